@@ -0,0 +1,464 @@
+/*
+  ==============================================================================
+
+    AnalysisEngine.cpp
+    Created: 17 Oct 2026 3:18:03pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "AnalysisEngine.h"
+#include "BeatAnalyser.h"
+#include "KeyAnalyser.h"
+#include "LoudnessAnalyser.h"
+
+//==============================================================================
+class AnalysisEngine::TrackAnalysis
+{
+public:
+    TrackAnalysis(double sampleRate, int numChannels)
+        : beatAnalyser(sampleRate),
+          keyAnalyser(sampleRate),
+          loudnessAnalyser(sampleRate, numChannels),
+          mono((size_t)blockSize)
+    {
+    }
+
+    //Only the first 2 channels are used, a mono track is read as its only channel twice
+    void process(const float* const* channels, int numChannels, int numSamples)
+    {
+        for (int offset = 0; offset < numSamples; offset += blockSize)
+        {
+            const int count{ juce::jmin(blockSize, numSamples - offset) };
+            const float* left{ channels[0] + offset };
+            const float* right{ channels[juce::jmin(numChannels, 2) - 1] + offset };
+
+            //The loudness is measured on every channel, the other analysers only need the mono mix
+            const float* stereo[2]{ left, right };
+            loudnessAnalyser.process(stereo, count);
+
+            juce::FloatVectorOperations::copyWithMultiply(mono.data(), left, 0.5f, count);
+            juce::FloatVectorOperations::addWithMultiply(mono.data(), right, 0.5f, count);
+
+            beatAnalyser.process(mono.data(), count);
+            keyAnalyser.process(mono.data(), count);
+        }
+    }
+
+    //A track with no beat, no notes or only silence still counts as analysed, with a tempo of 0,
+    //  a key of -1 or no auto gain, so it is not analysed again
+    void finish(AnalysisResult& result)
+    {
+        if (beatAnalyser.finish())
+        {
+            result.bpm = beatAnalyser.getBpm();
+            result.beatOffset = beatAnalyser.getBeatOffset();
+        }
+        result.analysisFlags |= LibraryDatabase::hasBpm;
+
+        keyAnalyser.finish();
+        result.key = keyAnalyser.getKey();
+        result.analysisFlags |= LibraryDatabase::hasKey;
+
+        if (loudnessAnalyser.finish())
+        {
+            result.autoGain = LoudnessAnalyser::getAutoGain(loudnessAnalyser.getIntegratedLoudness(), loudnessAnalyser.getTruePeak());
+        }
+        result.loudness = loudnessAnalyser.getIntegratedLoudness();
+        result.truePeak = loudnessAnalyser.getTruePeak();
+        result.analysisFlags |= LibraryDatabase::hasLoudness;
+    }
+
+private:
+    BeatAnalyser beatAnalyser;
+    KeyAnalyser keyAnalyser;
+    LoudnessAnalyser loudnessAnalyser;
+
+    std::vector<float> mono;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackAnalysis)
+};
+
+//==============================================================================
+//Analyses a track on the feed pool of the loader as its decode pass goes, and sends the result to the message thread.
+//A pass that stops before the end puts the track back in the priority lane, where a job decodes it on its own
+class AnalysisEngine::PassConsumer : public DecodeConsumer
+{
+public:
+    PassConsumer(juce::WeakReference<AnalysisEngine> _engine, juce::File _file, juce::uint32 _libraryId)
+        : engine(_engine),
+          file(_file),
+          libraryId(_libraryId)
+    {
+    }
+
+    void prepare(double sampleRate, int numChannels, juce::int64) override
+    {
+        if (sampleRate > 0.0 && numChannels > 0)
+        {
+            analysis.reset(new TrackAnalysis(sampleRate, numChannels));
+        }
+    }
+
+    void process(const float* const* channels, int numChannels, int numSamples) override
+    {
+        if (analysis != nullptr)
+        {
+            analysis->process(channels, numChannels, numSamples);
+        }
+    }
+
+    void finished(bool completed) override
+    {
+        const juce::WeakReference<AnalysisEngine> safeEngine{ engine };
+        const juce::uint32 id{ libraryId };
+
+        if (!completed)
+        {
+            const Task task{ file, libraryId };
+            juce::MessageManager::callAsync([safeEngine, task]
+            {
+                if (safeEngine != nullptr)
+                {
+                    safeEngine.get()->addTask(task, true);
+                }
+            });
+            return;
+        }
+
+        AnalysisResult result;
+        const bool analysedOk{ analysis != nullptr };
+        if (analysedOk)
+        {
+            analysis->finish(result);
+        }
+
+        juce::MessageManager::callAsync([safeEngine, id, analysedOk, result]
+        {
+            if (safeEngine != nullptr)
+            {
+                safeEngine.get()->analysisFinished(id, analysedOk, result);
+            }
+        });
+    }
+
+private:
+    juce::WeakReference<AnalysisEngine> engine;
+    juce::File file;
+    juce::uint32 libraryId;
+
+    std::unique_ptr<TrackAnalysis> analysis;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PassConsumer)
+};
+
+//==============================================================================
+//A job that analyses tasks until both lanes are empty. A job is added for every task, so a job
+//  that finds the lanes empty because another job took its task simply finishes.
+//Each job has its own format manager, so the jobs never share a reader between threads
+class AnalysisEngine::AnalysisJob : public juce::ThreadPoolJob
+{
+public:
+    explicit AnalysisJob(AnalysisEngine& _owner)
+        : juce::ThreadPoolJob("Track analysis"),
+          owner(_owner),
+          safeOwner(&_owner)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        Task task;
+        while (!shouldExit() && owner.takeNextTask(task))
+        {
+            //A track being decoded for a deck is analysed by its decode pass, which stores the result itself
+            if (owner.loader->joinDecodePass(task.file, std::make_shared<PassConsumer>(safeOwner, task.file, task.libraryId)))
+            {
+                continue;
+            }
+
+            AnalysisResult result;
+            const bool analysedOk{ AnalysisEngine::analyse(task.file, formatManager, *owner.cache, this, result) };
+
+            juce::WeakReference<AnalysisEngine> engine{ safeOwner };
+            const juce::uint32 libraryId{ task.libraryId };
+            juce::MessageManager::callAsync([engine, libraryId, analysedOk, result]
+            {
+                if (engine != nullptr)
+                {
+                    engine->analysisFinished(libraryId, analysedOk, result);
+                }
+            });
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    AnalysisEngine& owner;
+    juce::WeakReference<AnalysisEngine> safeOwner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisJob)
+};
+
+//==============================================================================
+AnalysisEngine::AnalysisEngine()
+{
+
+}
+
+AnalysisEngine::~AnalysisEngine()
+{
+    pool.removeAllJobs(true, 5000);
+}
+
+//The batch is added in the order of the library, so the tracks are read from the disk in the order they were imported
+int AnalysisEngine::analyseLibrary()
+{
+    int added{ 0 };
+
+    for (const juce::uint32 id : library->getTrackIds())
+    {
+        const LibraryRecord* record{ library->getRecord(id) };
+
+        if (record == nullptr || !needsAnalysis(*record) || isQueued(id))
+        {
+            continue;
+        }
+
+        addTask({ library->getFile(id), id }, false);
+        ++added;
+    }
+
+    return added;
+}
+
+//A track already waiting in the batch lane is moved to the priority lane
+void AnalysisEngine::analyseNow(const juce::File& file)
+{
+    const juce::uint32 id{ library->findTrack(file) };
+    const LibraryRecord* record{ library->getRecord(id) };
+
+    if (record == nullptr || !needsAnalysis(*record))
+    {
+        return;
+    }
+
+    {
+        const juce::ScopedLock scopedLock(queueLock);
+
+        if (queuedIds.count(id) != 0)
+        {
+            for (auto it = batchLane.begin(); it != batchLane.end(); ++it)
+            {
+                if (it->libraryId == id)
+                {
+                    priorityLane.push_back(*it);
+                    batchLane.erase(it);
+                    break;
+                }
+            }
+            //Either it was moved or it is being analysed right now
+            return;
+        }
+    }
+
+    addTask({ file, id }, true);
+}
+
+void AnalysisEngine::analyseLater(const juce::File& file)
+{
+    const juce::uint32 id{ library->findTrack(file) };
+    const LibraryRecord* record{ library->getRecord(id) };
+
+    if (record != nullptr && needsAnalysis(*record) && !isQueued(id))
+    {
+        addTask({ file, id }, false);
+    }
+}
+
+//The jobs of the removed tasks find the lanes empty and finish straight away
+void AnalysisEngine::cancelBatch()
+{
+    const juce::ScopedLock scopedLock(queueLock);
+
+    for (const Task& task : batchLane)
+    {
+        queuedIds.erase(task.libraryId);
+    }
+    batchLane.clear();
+}
+
+int AnalysisEngine::getNumWaiting() const
+{
+    const juce::ScopedLock scopedLock(queueLock);
+    return (int)queuedIds.size();
+}
+
+std::vector<juce::uint32> AnalysisEngine::takeChangedTracks()
+{
+    std::vector<juce::uint32> changed;
+    changed.swap(changedTracks);
+    return changed;
+}
+
+bool AnalysisEngine::needsAnalysis(const LibraryRecord& record)
+{
+    return (record.analysisFlags & allAnalyses) != allAnalyses;
+}
+
+//==============================================================================
+//A track that is already in the cache, because it was loaded on a deck, is not decoded again.
+//Otherwise it is streamed from the reader in blocks and mixed down to mono for the analysers
+bool AnalysisEngine::analyse(const juce::File& file,
+                             juce::AudioFormatManager& formatManager,
+                             DecodedTrackCache& cache,
+                             juce::ThreadPoolJob* job,
+                             AnalysisResult& result)
+{
+    const juce::String key{ DecodedTrackCache::makeKey(file) };
+    //peek() so that the analysis does not count as a deck load in the hit and miss counters
+    std::shared_ptr<const DecodedTrack> decoded{ cache.peek(key) };
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    double sampleRate{ 0.0 };
+    juce::int64 lengthInSamples{ 0 };
+    int numChannels{ 0 };
+
+    if (decoded != nullptr)
+    {
+        sampleRate = decoded->sampleRate;
+        lengthInSamples = decoded->buffer.getNumSamples();
+        numChannels = decoded->buffer.getNumChannels();
+    }
+    else
+    {
+        reader.reset(formatManager.createReaderFor(file));
+        if (reader == nullptr)
+        {
+            DBG("AnalysisEngine::analyse could not read " << file.getFullPathName());
+            return false;
+        }
+
+        sampleRate = reader->sampleRate;
+        lengthInSamples = reader->lengthInSamples;
+        numChannels = (int)reader->numChannels;
+    }
+
+    if (sampleRate <= 0.0 || numChannels <= 0)
+    {
+        return false;
+    }
+
+    TrackAnalysis analysis{ sampleRate, numChannels };
+    juce::AudioBuffer<float> block{ juce::jmin(numChannels, 2), blockSize };
+
+    for (juce::int64 position = 0; position < lengthInSamples; position += blockSize)
+    {
+        if (job != nullptr && job->shouldExit())
+        {
+            return false;
+        }
+
+        const int numSamples{ (int)juce::jmin((juce::int64)blockSize, lengthInSamples - position) };
+
+        if (decoded != nullptr)
+        {
+            const float* channels[2]{ decoded->buffer.getReadPointer(0, (int)position),
+                                      decoded->buffer.getReadPointer(juce::jmin(numChannels, 2) - 1, (int)position) };
+            analysis.process(channels, 2, numSamples);
+        }
+        else
+        {
+            reader->read(&block, 0, numSamples, position, true, true);
+            analysis.process(block.getArrayOfReadPointers(), block.getNumChannels(), numSamples);
+        }
+    }
+
+    analysis.finish(result);
+    return true;
+}
+
+//==============================================================================
+bool AnalysisEngine::isQueued(juce::uint32 libraryId) const
+{
+    const juce::ScopedLock scopedLock(queueLock);
+    return queuedIds.count(libraryId) != 0;
+}
+
+void AnalysisEngine::addTask(const Task& task, bool priority)
+{
+    {
+        const juce::ScopedLock scopedLock(queueLock);
+
+        queuedIds.insert(task.libraryId);
+        if (priority)
+        {
+            priorityLane.push_back(task);
+        }
+        else
+        {
+            batchLane.push_back(task);
+        }
+    }
+
+    pool.addJob(new AnalysisJob(*this), true);
+}
+
+//Called on a worker thread. The id stays in queuedIds until the result has been stored
+bool AnalysisEngine::takeNextTask(Task& task)
+{
+    const juce::ScopedLock scopedLock(queueLock);
+
+    std::deque<Task>& lane{ priorityLane.empty() ? batchLane : priorityLane };
+    if (lane.empty())
+    {
+        return false;
+    }
+
+    task = lane.front();
+    lane.pop_front();
+    return true;
+}
+
+//The record is looked up again, since the track may have been removed or changed while it was analysed
+void AnalysisEngine::analysisFinished(juce::uint32 libraryId, bool analysedOk, const AnalysisResult& result)
+{
+    {
+        const juce::ScopedLock scopedLock(queueLock);
+        queuedIds.erase(libraryId);
+    }
+
+    const LibraryRecord* current{ library->getRecord(libraryId) };
+
+    if (analysedOk && current != nullptr)
+    {
+        LibraryRecord record{ *current };
+
+        if ((result.analysisFlags & LibraryDatabase::hasBpm) != 0)
+        {
+            record.bpm = result.bpm;
+            record.beatOffset = result.beatOffset;
+        }
+        if ((result.analysisFlags & LibraryDatabase::hasKey) != 0)
+        {
+            record.key = result.key;
+        }
+        if ((result.analysisFlags & LibraryDatabase::hasLoudness) != 0)
+        {
+            record.loudness = result.loudness;
+            record.truePeak = result.truePeak;
+            record.autoGain = result.autoGain;
+        }
+        record.analysisFlags |= result.analysisFlags;
+
+        library->updateRecord(record);
+        changedTracks.push_back(libraryId);
+    }
+
+    sendChangeMessage();
+}
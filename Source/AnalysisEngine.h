@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    AnalysisEngine.h
+    Created: 17 Oct 2026 3:18:03pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <set>
+#include <vector>
+#include "LibraryDatabase.h"
+#include "DecodedTrackCache.h"
+#include "TrackLoader.h"
+
+//==============================================================================
+//What the analysis of a track found
+struct AnalysisResult
+{
+    //The LibraryDatabase::AnalysisFlags of the analyses that were run
+    juce::uint32 analysisFlags{ 0 };
+
+    //The tempo, 0 if no beat was found, and the time of the first beat in seconds
+    float bpm{ 0.0f };
+    float beatOffset{ 0.0f };
+
+    //The key from 0 to 23 as numbered by the KeyAnalyser, -1 if no notes were found
+    int key{ -1 };
+
+    //The integrated loudness in LUFS, the true peak in dBTP and the gain in decibels the auto gain applies
+    float loudness{ -70.0f };
+    float truePeak{ -70.0f };
+    float autoGain{ 0.0f };
+};
+
+//==============================================================================
+//Analyses the tracks of the library in the background and stores the results in their library records.
+//The tempo, the key and the loudness are found at the same time: every track is decoded once on a
+//  worker thread and its audio is fed to every analyser in blocks,
+//  so nothing but the analysers' own small state is kept in memory.
+//A track that is being decoded by the TrackLoader, because it was just loaded on a deck, is not decoded
+//  again: the analysers join its decode pass and the worker moves on to the next track.
+//There are 2 lanes: the batch lane holds the tracks of a whole library analysis, and the priority lane
+//  holds the tracks that were just loaded on a deck. A free worker always takes from the priority lane first.
+//It is used from the message thread, is shared using a juce::SharedResourcePointer and tells its
+//  listeners whenever a result has been stored
+class AnalysisEngine : public juce::ChangeBroadcaster
+{
+public:
+    //Every analysis the engine runs. A track missing any of them is analysed again
+    static constexpr juce::uint32 allAnalyses{ LibraryDatabase::hasBpm | LibraryDatabase::hasKey | LibraryDatabase::hasLoudness };
+
+    //The length of the blocks the tracks are decoded in
+    static constexpr int blockSize{ 16384 };
+
+    AnalysisEngine();
+    ~AnalysisEngine() override;
+
+    //Adding every track of the library that is missing an analysis to the batch lane.
+    //Returns the number of tracks added
+    int analyseLibrary();
+    //Analysing a track before anything in the batch lane, if it is in the library and missing an analysis
+    void analyseNow(const juce::File& file);
+    //Adding a single track to the batch lane, if it is in the library and missing an analysis
+    void analyseLater(const juce::File& file);
+    //Emptying the batch lane. The tracks being analysed right now are finished
+    void cancelBatch();
+
+    //The number of tracks waiting in both lanes or being analysed
+    int getNumWaiting() const;
+
+    //Returns the library ids of the tracks whose results were stored since the last call, and forgets them.
+    //Used by the playlist when it is told about a change, to update only those tracks
+    std::vector<juce::uint32> takeChangedTracks();
+
+    static bool needsAnalysis(const LibraryRecord& record);
+
+    //Decoding a file, or reading it from the cache, and running every analyser over it.
+    //Can be called on any thread. Returns false if the file could not be read or the job was asked to stop
+    static bool analyse(const juce::File& file,
+                        juce::AudioFormatManager& formatManager,
+                        DecodedTrackCache& cache,
+                        juce::ThreadPoolJob* job,
+                        AnalysisResult& result);
+
+private:
+    class AnalysisJob;
+    //Every analyser of a track, fed the audio of the track in blocks of any size
+    class TrackAnalysis;
+    //Runs a TrackAnalysis on the blocks of a decode pass
+    class PassConsumer;
+
+    //A track waiting to be analysed
+    struct Task
+    {
+        juce::File file;
+        juce::uint32 libraryId{ 0 };
+    };
+
+    //True if a track is waiting in a lane or being analysed
+    bool isQueued(juce::uint32 libraryId) const;
+    //Adding a task to a lane and a job to the pool to run it
+    void addTask(const Task& task, bool priority);
+    //Called by the jobs to take the next task, from the priority lane first
+    bool takeNextTask(Task& task);
+    //Called on the message thread with the result of a task
+    void analysisFinished(juce::uint32 libraryId, bool analysedOk, const AnalysisResult& result);
+
+    //The lanes and the ids of every track in them or being analysed, so a track is never queued twice
+    juce::CriticalSection queueLock;
+    std::deque<Task> priorityLane;
+    std::deque<Task> batchLane;
+    std::set<juce::uint32> queuedIds;
+
+    //The library ids of the tracks whose results were stored since takeChangedTracks was last called.
+    //Only used on the message thread
+    std::vector<juce::uint32> changedTracks;
+
+    juce::SharedResourcePointer<LibraryDatabase> library;
+    juce::SharedResourcePointer<DecodedTrackCache> cache;
+    juce::SharedResourcePointer<TrackLoader> loader;
+
+    //One core is left for the audio and the UI
+    juce::ThreadPool pool{ juce::jmax(1, juce::SystemStats::getNumCpus() - 1) };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(AnalysisEngine)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisEngine)
+};
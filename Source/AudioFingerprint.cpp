@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    AudioFingerprint.cpp
+    Created: 17 Oct 2026 3:14:17pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "AudioFingerprint.h"
+
+//The blocks start at evenly spaced positions from the start to the end of the track
+juce::uint64 AudioFingerprint::compute(juce::AudioFormatReader& reader, juce::int64 fileSize)
+{
+    juce::uint64 hash{ 14695981039346656037ull };
+
+    addToHash(hash, (juce::uint64)fileSize, 8);
+    addToHash(hash, (juce::uint64)reader.lengthInSamples, 8);
+    addToHash(hash, reader.numChannels, 4);
+
+    const int numChannels{ (int)juce::jlimit(1u, 2u, reader.numChannels) };
+    const int length{ (int)juce::jmin((juce::int64)blockLength, reader.lengthInSamples) };
+
+    if (length > 0)
+    {
+        juce::AudioBuffer<float> block{ numChannels, length };
+        const juce::int64 lastStart{ reader.lengthInSamples - length };
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const juce::int64 start{ lastStart * b / (numBlocks - 1) };
+            reader.read(&block, 0, length, start, true, numChannels > 1);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float* samples{ block.getReadPointer(ch) };
+
+                for (int i = 0; i < length; ++i)
+                {
+                    const int quantised{ juce::jlimit(-32768, 32767, juce::roundToInt(samples[i] * 32767.0f)) };
+                    addToHash(hash, (juce::uint16)quantised, 2);
+                }
+            }
+        }
+    }
+
+    return hash != 0 ? hash : 1;
+}
+
+void AudioFingerprint::addToHash(juce::uint64& hash, juce::uint64 value, int numBytes)
+{
+    for (int i = 0; i < numBytes; ++i)
+    {
+        hash = (hash ^ ((value >> (8 * i)) & 0xff)) * 1099511628211ull;
+    }
+}
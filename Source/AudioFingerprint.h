@@ -0,0 +1,35 @@
+/*
+  ==============================================================================
+
+    AudioFingerprint.h
+    Created: 17 Oct 2026 3:14:17pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+//A cheap fingerprint of an audio file, used to find the same audio stored under two names.
+//It hashes the size of the file, the length and channel count of the audio and a few short blocks of
+//  PCM spread evenly over the track, so only a few thousand samples are decoded however long the track is.
+//The samples are rounded to 16 bits before they are hashed, so small differences between decoders
+//  do not change the fingerprint
+class AudioFingerprint
+{
+public:
+    //The number of blocks read and the length of each of them in samples
+    static constexpr int numBlocks{ 8 };
+    static constexpr int blockLength{ 2048 };
+
+    //Computing the fingerprint of the audio of a reader. Never returns 0, which means "not known".
+    //Can be called on any thread
+    static juce::uint64 compute(juce::AudioFormatReader& reader, juce::int64 fileSize);
+
+private:
+    //Adding a value to an FNV-1a hash, one byte at a time
+    static void addToHash(juce::uint64& hash, juce::uint64 value, int numBytes);
+};
@@ -0,0 +1,325 @@
+/*
+  ==============================================================================
+
+    AudioPerformanceMonitor.cpp
+    Created: 17 Oct 2026 3:00:56pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "AudioPerformanceMonitor.h"
+
+AudioPerformanceMonitor::AudioPerformanceMonitor()
+{
+    for (int i = 0; i < maxSections; ++i)
+    {
+        sectionNames.add("Section " + juce::String(i + 1));
+    }
+
+    for (std::atomic<int>& bin : histogram)
+    {
+        bin = 0;
+    }
+
+    for (std::atomic<float>& load : recentLoads)
+    {
+        load = 0.0f;
+    }
+}
+
+AudioPerformanceMonitor::~AudioPerformanceMonitor()
+{
+
+}
+
+//==============================================================================
+void AudioPerformanceMonitor::setSectionName(int section, const juce::String& name)
+{
+    if (section >= 0 && section < maxSections)
+    {
+        sectionNames.set(section, name);
+    }
+}
+
+void AudioPerformanceMonitor::addCounter(const juce::String& name, const std::atomic<int>& counter)
+{
+    counters.push_back({ name, &counter, nullptr, 1.0 });
+}
+
+void AudioPerformanceMonitor::addCounter(const juce::String& name, const std::atomic<double>& value, double scale)
+{
+    counters.push_back({ name, nullptr, &value, scale });
+}
+
+//==============================================================================
+void AudioPerformanceMonitor::prepare(int samplesPerBlockExpected, double newSampleRate, juce::AudioIODevice* newDevice)
+{
+    blockSize = samplesPerBlockExpected;
+    sampleRate = newSampleRate;
+    device = newDevice;
+    firstXrunCount = device != nullptr ? juce::jmax(0, device->getXRunCount()) : 0;
+    clearRequested = true;
+}
+
+void AudioPerformanceMonitor::clearStatistics()
+{
+    lastLoad = 0.0;
+    averageLoad = 0.0;
+    peakLoad = 0.0;
+    overruns = 0;
+    xruns = 0;
+    callbacks = 0;
+
+    for (std::atomic<int>& bin : histogram)
+    {
+        bin = 0;
+    }
+
+    for (Section& section : sections)
+    {
+        section.pendingTicks = 0;
+        section.last = 0.0;
+        section.average = 0.0;
+        section.peak = 0.0;
+        section.used = false;
+    }
+}
+
+void AudioPerformanceMonitor::clearPeaks()
+{
+    peakLoad = 0.0;
+
+    for (Section& section : sections)
+    {
+        section.peak = 0.0;
+    }
+}
+
+void AudioPerformanceMonitor::addSectionTicks(int section, juce::int64 ticks)
+{
+    if (section >= 0 && section < maxSections)
+    {
+        sections[section].pendingTicks += ticks;
+        sections[section].used = true;
+    }
+}
+
+//The load is the time the callback took divided by the time the block lasts
+void AudioPerformanceMonitor::callbackFinished(juce::int64 startTicks, int numSamples)
+{
+    if (clearRequested.exchange(false))
+    {
+        clearStatistics();
+    }
+    if (peakResetRequested.exchange(false))
+    {
+        clearPeaks();
+    }
+
+    const double rate{ sampleRate };
+    if (rate <= 0.0 || numSamples <= 0)
+    {
+        return;
+    }
+
+    const juce::int64 endTicks{ juce::Time::getHighResolutionTicks() };
+    const double periodSeconds{ numSamples / rate };
+    const double load{ juce::Time::highResolutionTicksToSeconds(endTicks - startTicks) / periodSeconds };
+
+    //The xruns are the ones the driver counted since the device was prepared. Guessing them from late
+    //  callbacks would count every bursty driver and device restart. A device that cannot count them returns -1
+    if (device != nullptr)
+    {
+        const int deviceXruns{ device->getXRunCount() };
+        if (deviceXruns >= firstXrunCount)
+        {
+            xruns = deviceXruns - firstXrunCount;
+        }
+    }
+
+    if (load > 1.0)
+    {
+        ++overruns;
+    }
+
+    const int count{ callbacks };
+    lastLoad = load;
+    averageLoad = count == 0 ? load : averageLoad + (load - averageLoad) * averageSmoothing;
+    peakLoad = juce::jmax(peakLoad.load(), load);
+
+    const int bin{ juce::jlimit(0, numHistogramBins - 1, (int)(load / histogramBinWidth)) };
+    ++histogram[bin];
+
+    recentLoads[count % historySize] = (float)load;
+    callbacks = count + 1;
+
+    for (Section& section : sections)
+    {
+        if (!section.used)
+        {
+            continue;
+        }
+
+        const double microseconds{ juce::Time::highResolutionTicksToSeconds(section.pendingTicks) * 1.0e6 };
+        section.pendingTicks = 0;
+        section.last = microseconds;
+        section.average = count == 0 ? microseconds : section.average + (microseconds - section.average) * averageSmoothing;
+        section.peak = juce::jmax(section.peak.load(), microseconds);
+    }
+}
+
+//==============================================================================
+double AudioPerformanceMonitor::getLastLoad() const
+{
+    return lastLoad;
+}
+
+double AudioPerformanceMonitor::getAverageLoad() const
+{
+    return averageLoad;
+}
+
+double AudioPerformanceMonitor::getPeakLoad() const
+{
+    return peakLoad;
+}
+
+int AudioPerformanceMonitor::getNumOverruns() const
+{
+    return overruns;
+}
+
+int AudioPerformanceMonitor::getNumXruns() const
+{
+    return xruns;
+}
+
+int AudioPerformanceMonitor::getNumCallbacks() const
+{
+    return callbacks;
+}
+
+int AudioPerformanceMonitor::getBlockSize() const
+{
+    return blockSize;
+}
+
+double AudioPerformanceMonitor::getSampleRate() const
+{
+    return sampleRate;
+}
+
+//Returns an empty name for a section that was never timed, so it can be skipped
+juce::String AudioPerformanceMonitor::getSectionName(int section) const
+{
+    if (section < 0 || section >= maxSections || !sections[section].used)
+    {
+        return {};
+    }
+    return sectionNames[section];
+}
+
+AudioPerformanceMonitor::SectionStats AudioPerformanceMonitor::getSectionStats(int section) const
+{
+    SectionStats stats;
+
+    if (section >= 0 && section < maxSections)
+    {
+        stats.lastMicroseconds = sections[section].last;
+        stats.averageMicroseconds = sections[section].average;
+        stats.peakMicroseconds = sections[section].peak;
+    }
+    return stats;
+}
+
+int AudioPerformanceMonitor::getHistogramCount(int bin) const
+{
+    if (bin < 0 || bin >= numHistogramBins)
+    {
+        return 0;
+    }
+    return histogram[bin];
+}
+
+int AudioPerformanceMonitor::getNumCounters() const
+{
+    return (int)counters.size();
+}
+
+juce::String AudioPerformanceMonitor::getCounterName(int index) const
+{
+    return counters[(size_t)index].name;
+}
+
+//Counts are shown as they are and figures with 2 decimals
+juce::String AudioPerformanceMonitor::getCounterText(int index) const
+{
+    const Counter& counter{ counters[(size_t)index] };
+
+    if (counter.count != nullptr)
+    {
+        return juce::String(counter.count->load());
+    }
+    return juce::String(counter.value->load() * counter.scale, 2);
+}
+
+void AudioPerformanceMonitor::resetPeaks()
+{
+    peakResetRequested = true;
+}
+
+//==============================================================================
+//One "metric,value" row per statistic, then the histogram, then one row per recent callback
+bool AudioPerformanceMonitor::writeCsv(const juce::File& file) const
+{
+    const double periodMicroseconds{ getSampleRate() > 0.0 ? getBlockSize() / getSampleRate() * 1.0e6 : 0.0 };
+
+    juce::String csv;
+    csv << "metric,value\n";
+    csv << "block size," << getBlockSize() << "\n";
+    csv << "sample rate," << getSampleRate() << "\n";
+    csv << "buffer period us," << periodMicroseconds << "\n";
+    csv << "callbacks," << getNumCallbacks() << "\n";
+    csv << "last load %," << getLastLoad() * 100.0 << "\n";
+    csv << "average load %," << getAverageLoad() * 100.0 << "\n";
+    csv << "peak load %," << getPeakLoad() * 100.0 << "\n";
+    csv << "overruns," << getNumOverruns() << "\n";
+    csv << "xruns," << getNumXruns() << "\n";
+
+    for (int i = 0; i < getNumCounters(); ++i)
+    {
+        csv << getCounterName(i) << "," << getCounterText(i) << "\n";
+    }
+
+    for (int i = 0; i < maxSections; ++i)
+    {
+        const juce::String name{ getSectionName(i) };
+        if (name.isEmpty())
+        {
+            continue;
+        }
+
+        const SectionStats stats{ getSectionStats(i) };
+        csv << name << " average us," << stats.averageMicroseconds << "\n";
+        csv << name << " peak us," << stats.peakMicroseconds << "\n";
+    }
+
+    csv << "\nhistogram bin %,histogram bin us,callbacks\n";
+    for (int bin = 0; bin < numHistogramBins; ++bin)
+    {
+        const double binStart{ bin * histogramBinWidth };
+        csv << juce::roundToInt(binStart * 100.0) << (bin == numHistogramBins - 1 ? "+" : "") << ","
+            << juce::roundToInt(binStart * periodMicroseconds) << ","
+            << getHistogramCount(bin) << "\n";
+    }
+
+    csv << "\ncallback,load %\n";
+    const int count{ getNumCallbacks() };
+    for (int i = juce::jmax(0, count - historySize); i < count; ++i)
+    {
+        csv << i << "," << recentLoads[i % historySize].load() * 100.0f << "\n";
+    }
+
+    return file.replaceWithText(csv);
+}
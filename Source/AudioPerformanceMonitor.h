@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    AudioPerformanceMonitor.h
+    Created: 17 Oct 2026 3:00:56pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+//Measures how long the audio callback takes compared to the time it has, without locks.
+//The audio thread writes everything into atomics and the GUI reads them whenever it wants.
+//Besides the whole callback it times named sections (eg. each deck and the mixer), keeps a
+//  histogram of the callback load, counts overruns and xruns and can write all of it to a CSV file
+class AudioPerformanceMonitor
+{
+public:
+    //The number of sections that can be timed, eg. the mixer channels and the mixer itself
+    static constexpr int maxSections{ 24 };
+    //The histogram has bins 10% of the buffer period wide, the last one holding everything above 150%
+    static constexpr int numHistogramBins{ 16 };
+    static constexpr double histogramBinWidth{ 0.1 };
+    //The number of recent callbacks kept for the CSV file
+    static constexpr int historySize{ 4096 };
+
+    AudioPerformanceMonitor();
+    ~AudioPerformanceMonitor();
+
+    //==============================================================================
+    //Message thread, before the audio device starts
+
+    //Naming a section so that it shows up in the overlay and the CSV file
+    void setSectionName(int section, const juce::String& name);
+    //Adding a counter kept by someone else, eg. the read-ahead underruns of a deck.
+    //The counter must outlive the monitor
+    void addCounter(const juce::String& name, const std::atomic<int>& counter);
+    //Adding a figure kept by someone else, eg. the key-lock load of a deck, shown multiplied by scale
+    void addCounter(const juce::String& name, const std::atomic<double>& value, double scale = 1.0);
+
+    //==============================================================================
+    //Audio thread
+
+    //Called from prepareToPlay with the settings of the device, and the device itself so that its xruns
+    //  can be counted. Every statistic is cleared at the next callback
+    void prepare(int samplesPerBlockExpected, double sampleRate, juce::AudioIODevice* device);
+    //Adding time to a section for the current callback. A section can be timed several times in one callback
+    void addSectionTicks(int section, juce::int64 ticks);
+    //Called at the end of the callback with the time it started, in high resolution ticks
+    void callbackFinished(juce::int64 startTicks, int numSamples);
+
+    //==============================================================================
+    //Any thread
+
+    //The statistics of one section, in microseconds per callback
+    struct SectionStats
+    {
+        double lastMicroseconds{ 0.0 };
+        double averageMicroseconds{ 0.0 };
+        double peakMicroseconds{ 0.0 };
+    };
+
+    //The load of the callback as a fraction of the buffer period
+    double getLastLoad() const;
+    double getAverageLoad() const;
+    double getPeakLoad() const;
+    //The callbacks that took longer than the buffer period
+    int getNumOverruns() const;
+    //The xruns the device reported since it was prepared, 0 if the device does not count them
+    int getNumXruns() const;
+    int getNumCallbacks() const;
+    //The buffer settings passed to prepare
+    int getBlockSize() const;
+    double getSampleRate() const;
+
+    juce::String getSectionName(int section) const;
+    SectionStats getSectionStats(int section) const;
+    int getHistogramCount(int bin) const;
+
+    //The counters added with addCounter, and their values as text
+    int getNumCounters() const;
+    juce::String getCounterName(int index) const;
+    juce::String getCounterText(int index) const;
+
+    //Forgetting the peaks, so new ones can be found. The audio thread clears them at its next callback
+    void resetPeaks();
+
+    //Writing a snapshot of every statistic, followed by the load of the most recent callbacks
+    bool writeCsv(const juce::File& file) const;
+
+private:
+    //A section's figures, written by the audio thread only
+    struct Section
+    {
+        juce::int64 pendingTicks{ 0 };
+        std::atomic<double> last{ 0.0 };
+        std::atomic<double> average{ 0.0 };
+        std::atomic<double> peak{ 0.0 };
+        std::atomic<bool> used{ false };
+    };
+
+    //Clearing the statistics or only the peaks, called on the audio thread when it takes a request
+    void clearStatistics();
+    void clearPeaks();
+
+    //How quickly the averages follow the latest values
+    static constexpr double averageSmoothing{ 0.05 };
+
+    std::array<Section, maxSections> sections;
+    juce::StringArray sectionNames;
+
+    std::atomic<double> lastLoad{ 0.0 };
+    std::atomic<double> averageLoad{ 0.0 };
+    std::atomic<double> peakLoad{ 0.0 };
+    std::atomic<int> overruns{ 0 };
+    std::atomic<int> xruns{ 0 };
+    std::atomic<int> callbacks{ 0 };
+    std::array<std::atomic<int>, numHistogramBins> histogram;
+
+    //The load of the last callbacks, written in a circle
+    std::array<std::atomic<float>, historySize> recentLoads;
+
+    //Set by prepare() and resetPeaks(), and taken by the audio thread at the next callback,
+    //  so that only the audio thread ever writes the statistics
+    std::atomic<bool> clearRequested{ false };
+    std::atomic<bool> peakResetRequested{ false };
+
+    std::atomic<int> blockSize{ 0 };
+    std::atomic<double> sampleRate{ 0.0 };
+    //The device whose xruns are counted and its xrun count when it was prepared, only used on the audio thread
+    juce::AudioIODevice* device{ nullptr };
+    int firstXrunCount{ 0 };
+
+    //A counter added by the GUI, which points at either a count or a figure
+    struct Counter
+    {
+        juce::String name;
+        const std::atomic<int>* count{ nullptr };
+        const std::atomic<double>* value{ nullptr };
+        double scale{ 1.0 };
+    };
+
+    //The counters added by the GUI, only changed before the audio device starts
+    std::vector<Counter> counters;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPerformanceMonitor)
+};
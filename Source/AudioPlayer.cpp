@@ -13,15 +13,14 @@
 //Constructor for the AudioPlayer and the initialization list
 AudioPlayer::AudioPlayer(juce::AudioFormatManager& _formatManager) 
     : formatManager(_formatManager),
-      cue_position(0),
       current_position(0)
 {
-
+    analysisEngine->addChangeListener(this);
 }
 
 AudioPlayer::~AudioPlayer()
 {
-
+    analysisEngine->removeChangeListener(this);
 }
 
 //==============================================================================
@@ -36,14 +35,122 @@ void AudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
         DBG(s);
     }*/
 
+    outputSampleRate = sampleRate;
+    lastBlockTicks = 0;
+
     transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
     resampleSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    stretchSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
 }
    
-//Getting the next audio block to play from the buffer
+//Getting the next audio block to play from the buffer.
+//The commands sent by the GUI are applied here. A command with a timestamp is applied at the sample of this block
+//  that matches when it was sent during the previous block, so cues land with a fixed latency of one block
+//  and without jitter. The block is rendered in segments between the commands
 void AudioPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {    
-    resampleSource.getNextAudioBlock(bufferToFill);     
+    const juce::int64 blockTicks{ juce::Time::getHighResolutionTicks() };
+    int done{ 0 };
+
+    DeckCommand command;
+    while (commandQueue.peek(command))
+    {
+        //A command sent after this block started waits for the next block
+        if (command.timestamp > blockTicks)
+        {
+            break;
+        }
+
+        const int offset{ juce::jmax(done, getCommandOffset(command.timestamp, bufferToFill.numSamples)) };
+        if (offset > done)
+        {
+            renderSegment(bufferToFill, done, offset - done);
+            done = offset;
+        }
+
+        commandQueue.pop(command);
+        applyCommand(command);
+    }
+
+    loopRegionActive = loopRegion.active;
+
+    if (done < bufferToFill.numSamples)
+    {
+        renderSegment(bufferToFill, done, bufferToFill.numSamples - done);
+    }
+
+    lastBlockTicks = blockTicks;
+
+    //When the track plays to the end the transportSource stops by itself,
+    //so the requested state is brought back in line with it
+    if (transportSource.hasStreamFinished())
+    {
+        playing = false;
+        deckRunning = false;
+        playFadeGain = 0.0f;
+    }
+}
+
+//With key-lock on the tempo is changed by the stretcher, otherwise by resampling.
+//A paused deck is not read at all, so its playhead stays where it was. Pausing and resuming
+//  ramp the gain over playFadeLength samples, and a paused deck only reads the samples it fades out
+void AudioPlayer::renderSegment(const juce::AudioSourceChannelInfo& bufferToFill, int start, int numSamples)
+{
+    const float target{ deckRunning ? 1.0f : 0.0f };
+
+    if (!deckRunning && playFadeGain <= 0.0f)
+    {
+        bufferToFill.buffer->clear(bufferToFill.startSample + start, numSamples);
+        return;
+    }
+
+    const float step{ 1.0f / playFadeLength };
+    const int fadeCount{ juce::jmin(numSamples, (int)std::ceil(std::abs(target - playFadeGain) / step)) };
+    const int readCount{ deckRunning ? numSamples : fadeCount };
+    const juce::AudioSourceChannelInfo part{ bufferToFill.buffer, bufferToFill.startSample + start, readCount };
+
+    if (keyLockActive)
+    {
+        stretchSource.getNextAudioBlock(part);
+    }
+    else
+    {
+        resampleSource.getNextAudioBlock(part);
+    }
+
+    if (fadeCount > 0)
+    {
+        const float endGain{ deckRunning ? juce::jmin(1.0f, playFadeGain + fadeCount * step)
+                                         : juce::jmax(0.0f, playFadeGain - fadeCount * step) };
+        bufferToFill.buffer->applyGainRamp(part.startSample, fadeCount, playFadeGain, endGain);
+        playFadeGain = endGain;
+    }
+
+    if (readCount < numSamples)
+    {
+        bufferToFill.buffer->clear(part.startSample + readCount, numSamples - readCount);
+    }
+
+    //A seek made while the deck was fading out moves the playhead only once the deck is silent
+    if (playFadeGain <= 0.0f && pendingPosition >= 0.0)
+    {
+        transportSource.setPosition(pendingPosition);
+        stretchSource.reset();
+        pendingPosition = -1.0;
+    }
+}
+
+//The time between the start of the previous block and the command, turned into samples
+int AudioPlayer::getCommandOffset(juce::int64 timestamp, int numSamples) const
+{
+    if (timestamp <= 0 || lastBlockTicks <= 0 || outputSampleRate <= 0.0 || numSamples <= 0)
+    {
+        return 0;
+    }
+
+    const double seconds{ juce::Time::highResolutionTicksToSeconds(timestamp - lastBlockTicks) };
+
+    return juce::jlimit(0, numSamples - 1, (int)(seconds * outputSampleRate));
 }
 
 //Releasing resources
@@ -51,39 +158,183 @@ void AudioPlayer::releaseResources()
 {
     transportSource.releaseResources();
     resampleSource.releaseResources();    
+    stretchSource.releaseResources();
 }
 
 //==============================================================================
 
-//Loading the file into the transportSource
-void AudioPlayer::loadURL(juce::URL audioURL)
+//Loading the file on one of the TrackLoader worker threads.
+//The player keeps playing whatever it had until the new track is ready
+void AudioPlayer::loadURLAsync(juce::URL audioURL,
+                               std::function<void(float)> onProgress,
+                               std::function<void(bool)> onLoaded)
 {
-    juce::AudioFormatReader* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+    const int generation{ ++loadGeneration };
+    loading = true;
+    loadProgress = 0.0f;
+
+    //A weak reference is used, so that a load finishing after the player is deleted is ignored
+    juce::WeakReference<AudioPlayer> safeThis{ this };
+
+    trackLoader->loadAsync(formatManager, audioURL,
+        [safeThis, generation, onProgress](float progress)
+        {
+            if (safeThis == nullptr || safeThis->loadGeneration != generation)
+            {
+                return;
+            }
+
+            safeThis->loadProgress = progress;
+            if (onProgress != nullptr)
+            {
+                onProgress(progress);
+            }
+        },
+        [safeThis, generation, onLoaded](std::shared_ptr<LoadedTrack> track)
+        {
+            //Ignoring the track if the player is gone or a newer load was started since
+            if (safeThis == nullptr || safeThis->loadGeneration != generation)
+            {
+                return;
+            }
+
+            safeThis->loading = false;
+
+            if (track->loadedOk)
+            {
+                //Tracks played from memory are copied, not decoded, so only streamed tracks need reading ahead
+                if (!track->fromCache && !track->memoryMapped)
+                {
+                    track->source = safeThis->createReadAhead(std::move(track->source), track->sampleRate);
+                }
+                safeThis->setReaderSource(std::move(track->source), track->sampleRate, track->url);
+            }
+            else
+            {
+                DBG("Something went wrong in the file");
+            }
+
+            if (onLoaded != nullptr)
+            {
+                onLoaded(track->loadedOk);
+            }
+        });
+}
 
-    if (reader != nullptr)
-    {
-        std::unique_ptr<juce::AudioFormatReaderSource> newSource
-        (new juce::AudioFormatReaderSource(reader, true));
+//Returning true while a background load is running
+bool AudioPlayer::isLoading() const
+{
+    return loading;
+}
+
+//Returning the progress of the last background load
+float AudioPlayer::getLoadProgress() const
+{
+    return loadProgress;
+}
+
+//The decoding happens on the DiskIOThread, so the transportSource itself does not need a read-ahead buffer
+std::unique_ptr<juce::PositionableAudioSource> AudioPlayer::createReadAhead(std::unique_ptr<juce::PositionableAudioSource> source, double sampleRate)
+{
+    return std::make_unique<ReadAheadSource>(std::move(source), sampleRate, readAheadSeconds, readAheadStats);
+}
+
+void AudioPlayer::setReadAheadSeconds(double seconds)
+{
+    readAheadSeconds = juce::jlimit(1.0, 120.0, seconds);
+}
+
+double AudioPlayer::getReadAheadSeconds() const
+{
+    return readAheadSeconds;
+}
+
+const ReadAheadStats& AudioPlayer::getReadAheadStats() const
+{
+    return readAheadStats;
+}
 
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        readerSource.reset(newSource.release());
+//Swapping the new source into the transportSource. The swap itself only holds the
+//transportSource's lock for as long as it takes to change a pointer
+void AudioPlayer::setReaderSource(std::unique_ptr<juce::PositionableAudioSource> newSource, double sampleRate, juce::URL audioURL)
+{
+    trackSampleRate = sampleRate;
+    trackLength = newSource->getTotalLength();
+    loadedURL = audioURL;
+    ++trackGeneration;
+
+    //The loop region of the previous track is cleared before the new track starts.
+    //Handing a source to the transportSource stops it, so the deck is paused as well
+    sendCommand(DeckCommand::Type::clearLoop);
+    playing = false;
+    sendCommand(DeckCommand::Type::stop);
+
+    //The cues of the previous track are cleared and the cues saved for this track are read back
+    hotCues.clearAll();
+    restoreCues();
+    updateAutoGain();
+
+    //A track that is missing its tempo goes to the front of the analysis queue
+    if (loadedURL.isLocalFile())
+    {
+        analysisEngine->analyseNow(loadedURL.getLocalFile());
     }
-    else
+
+    std::unique_ptr<DeckSource> newDeckSource{ new DeckSource(std::move(newSource), loopRegion, hotCues) };
+    newDeckSource->setLooping(looping);
+
+    //The audio thread never waits for this lock, it skips applying a loop command
+    //while the source is being replaced.
+    //The old source is deleted after the lock is let go, since it may wait for the DiskIOThread
     {
-        DBG("Something went wrong in the file");
+        const juce::SpinLock::ScopedLockType lock(sourceLock);
+        transportSource.setSource(newDeckSource.get(), 0, nullptr, sampleRate);
+        readerSource.swap(newDeckSource);
     }
+    newDeckSource.reset();
 }
 
-//Setting the gain of the transportSource using the function from the AudioTransportSource class
-void AudioPlayer::setGain(double gain)
+void AudioPlayer::setAutoGain(bool shouldApply)
 {
-    if (gain < 0 || gain > 1.0)
+    autoGainOn = shouldApply;
+    sendGain();
+}
+
+bool AudioPlayer::isAutoGainOn() const
+{
+    return autoGainOn;
+}
+
+//The auto gain can raise a track above a gain of 1, since its true peak was measured and the raise
+//  leaves it at least LoudnessAnalyser::maxTruePeak below full scale. The headroom of the mixer keeps
+//  the sum of the decks below full scale
+void AudioPlayer::sendGain()
+{
+    const double gain{ autoGainOn ? juce::Decibels::decibelsToGain((double)autoGainDecibels) : 1.0 };
+
+    if (gain != sentGain)
     {
-        DBG("DJAudioPlayer::setGain gain should be between 0 and 1");
+        sentGain = gain;
+        sendCommand(DeckCommand::Type::setGain, gain);
     }
-    else
+}
+
+//A track that has not been analysed yet plays without an offset until its loudness is known
+void AudioPlayer::updateAutoGain()
+{
+    const LibraryRecord* record{ findLibraryRecord() };
+    const bool hasLoudness{ record != nullptr && (record->analysisFlags & LibraryDatabase::hasLoudness) != 0 };
+
+    autoGainDecibels = hasLoudness ? record->autoGain : 0.0f;
+    sendGain();
+}
+
+//The gain is not changed under a track that is already playing, the new offset is used from its next load
+void AudioPlayer::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    if (source == analysisEngine.get() && !isPlaying())
     {
-        transportSource.setGain(gain);
+        updateAutoGain();
     }
 }
 
@@ -96,14 +347,15 @@ void AudioPlayer::setSpeed(double ratio)
     }
     else
     {
-        resampleSource.setResamplingRatio(ratio);
+        speedRatio = ratio;
+        sendCommand(DeckCommand::Type::setSpeed, ratio);
     }
 }
 
 //Setting the position of the transportSource using the function from the AudioTransportSource class
 void AudioPlayer::setPosition(double posInSecs)
 {
-    transportSource.setPosition(posInSecs);
+    sendCommand(DeckCommand::Type::setPosition, posInSecs);
 }
 
 //Setting the position of the transportSource relative to range of the slider being 0 and 1
@@ -123,13 +375,33 @@ void AudioPlayer::setPositionRelative(double pos)
 //Starting of playback
 void AudioPlayer::start()
 {
-    transportSource.start();
+    playing = true;
+    startTransport();
+    sendCommand(DeckCommand::Type::start, 0.0, juce::Time::getHighResolutionTicks());
 }
 
 //Stopping of the playback 
 void AudioPlayer::stop()
 {
-    transportSource.stop();    
+    playing = false;
+    sendCommand(DeckCommand::Type::stop, 0.0, juce::Time::getHighResolutionTicks());
+}
+
+//The transportSource is only started here on the message thread, since starting and stopping it wait on its lock.
+//It is left running after that and the audio thread pauses the deck by not reading it. It only stops
+//  by itself at the end of a track and when a new source is handed to it
+void AudioPlayer::startTransport()
+{
+    if (!transportSource.isPlaying())
+    {
+        transportSource.start();
+    }
+}
+
+//Returning the state requested by the GUI, the audio thread catches up with it at the next block
+bool AudioPlayer::isPlaying() const
+{
+    return playing;
 }
 
 //Moving the position backwards of the transportSource
@@ -139,7 +411,7 @@ void AudioPlayer::rewind()
     //  the new position value is less than 0 or not 
     if (transportSource.getCurrentPosition() - 1 > 0)
     {
-        transportSource.setPosition(transportSource.getCurrentPosition() - 1.5);
+        setPosition(transportSource.getCurrentPosition() - 1.5);
     }
 }
 
@@ -154,53 +426,53 @@ void AudioPlayer::forward()
     //It will update the position only if the new position is in range
     if (transportSource.getCurrentPosition() +0.5 != last_pos || transportSource.getCurrentPosition() +0.5 > last_pos)
     {
-        transportSource.setPosition(transportSource.getCurrentPosition() + 1.5);
+        setPosition(transportSource.getCurrentPosition() + 1.5);
     }
 }
 
 //The below 4 functions are pure virtual functions that need to be implemented
 //  since we inherit from the PositionableAudioSource class
+//The position is in samples of the track and is applied by the audio thread like any other seek
 void AudioPlayer::setNextReadPosition(juce::int64 newPosition)
 {
-    
+    if (trackSampleRate > 0.0)
+    {
+        setPosition(newPosition / trackSampleRate);
+    }
 }
 
 juce::int64 AudioPlayer::getNextReadPosition() const
 {
+    if (readerSource == nullptr)
+    {
+        return 0;
+    }
     return readerSource->getNextReadPosition();
 }
 
 juce::int64 AudioPlayer::getTotalLength() const
 {    
-    return readerSource->getTotalLength();
+    return trackLength;
 }
 
 //Returning true if it is looping, or false if it is not
 bool AudioPlayer::isLooping() const
 {
-    return false;
+    return looping || loopRegionActive;
 }
 
 //Setting the playback to loop
 void AudioPlayer::setLoop()
 {
-    //if the readerSource is not a null pointer, the readerSource is set to loop
-    //using the function from the PositionableAudioSource class
-    if (readerSource != nullptr)
-    {
-        readerSource->setLooping(true);
-    }  
+    looping = true;
+    sendCommand(DeckCommand::Type::setLoop, 1.0);
 }
 
 //Setting the playback not to loop
 void AudioPlayer::unsetLoop()
 {
-    //if the readerSource is not a null pointer, the readerSource is set to not loop
-    //using the function from the PositionableAudioSource class
-    if (readerSource != nullptr)
-    {
-        readerSource->setLooping(false);
-    }
+    looping = false;
+    sendCommand(DeckCommand::Type::setLoop, 0.0);
 }
 
 //get the relative position of the playhead returned as a double
@@ -209,46 +481,463 @@ double AudioPlayer::getPositionRelative()
     return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
 }
 
-//A function that returns the total time of the track in minutes and seconds as a String
-juce::String AudioPlayer::getSongLength()
+double AudioPlayer::getPositionInSeconds()
 {
-    double length_minutes{ transportSource.getLengthInSeconds() / 60 };
-   
-    //Variables needed to seperate the integer and fractional value of the calculated minutes
-    //from the return value in seconds of the function getLengthInSeconds
-    double fractional_part, integer_part;
-    fractional_part = modf(length_minutes, &integer_part);
+    return transportSource.getCurrentPosition();
+}
 
-    //two variables that hold the calculated minutes and seconds
-    std::string minutes{ std::to_string((int)integer_part) };
-    std::string seconds{ std::to_string((int)round(fractional_part * 60)) };
-     
-    juce::String final_string{ minutes + " min : " + seconds + " sec" };   
+juce::File AudioPlayer::getLoadedFile() const
+{
+    return loadedURL.isLocalFile() ? loadedURL.getLocalFile() : juce::File{};
+}
 
-    return final_string;
+//A function that returns the total time of the track in minutes and seconds as a String
+//The formatting is shared with the playlist, which shows the lengths kept in the TrackMetadataStore
+juce::String AudioPlayer::getSongLength()
+{
+    return TrackMetadata::formatLength(transportSource.getLengthInSeconds());
 }
 
-//Recording the cue position saved by the user.
-//  Passed as an argument and stored in the class variable
+//Recording the cue position saved by the user, in seconds.
+//  It is kept as the main cue of the hotCues, so it gets a snippet like the hot cues
 void AudioPlayer::setCuePosition(double cue_pos)
 {
-    cue_position = cue_pos;
+    const juce::int64 samplePosition{ (juce::int64)std::llround(cue_pos * trackSampleRate) };
+
+    hotCues.setPosition(HotCueBank::mainCue, samplePosition);
+    requestSnippet(HotCueBank::mainCue, samplePosition);
+    saveCues();
 }
 
-//Returning back the recorded cue position
+//Returning back the recorded cue position in seconds
 double AudioPlayer::getCuePosition()
 {
-    return cue_position;
+    const juce::int64 samplePosition{ hotCues.getPosition(HotCueBank::mainCue) };
+
+    if (samplePosition < 0 || trackSampleRate <= 0.0)
+    {
+        return 0.0;
+    }
+    return samplePosition / trackSampleRate;
 }
 
-//Storing the current position of the playback
-void AudioPlayer::setCurrentPosition(double current_pos)
+//Setting a hot cue at the playhead
+void AudioPlayer::setHotCue(int index)
 {
-    current_position = current_pos;
+    if (index < 0 || index >= HotCueBank::numHotCues || trackSampleRate <= 0.0)
+    {
+        DBG("AudioPlayer::setHotCue no track loaded or index out of range");
+        return;
+    }
+
+    const juce::int64 samplePosition{ getTrackPlayhead() };
+    hotCues.setPosition(index, samplePosition);
+    requestSnippet(index, samplePosition);
+    saveCues();
 }
 
-//Returning the value stored in the current position variable
-double AudioPlayer::getCurrentPosition()
+void AudioPlayer::triggerHotCue(int index)
 {
-    return current_position;
+    if (!hasHotCue(index))
+    {
+        return;
+    }
+
+    playing = true;
+    startTransport();
+    sendCommand(DeckCommand::Type::triggerHotCue, index, juce::Time::getHighResolutionTicks());
+}
+
+void AudioPlayer::clearHotCue(int index)
+{
+    if (index >= 0 && index < HotCueBank::numHotCues)
+    {
+        hotCues.clear(index);
+        saveCues();
+    }
+}
+
+bool AudioPlayer::hasHotCue(int index) const
+{
+    return index >= 0 && index < HotCueBank::numHotCues && hotCues.getPosition(index) >= 0;
+}
+
+//Decoding the snippet on one of the TrackLoader threads. It is dropped if another track was loaded since
+void AudioPlayer::requestSnippet(int slot, juce::int64 samplePosition)
+{
+    if (loadedURL.isEmpty() || trackSampleRate <= 0.0)
+    {
+        return;
+    }
+
+    const int length{ juce::jmin(HotCueBank::maxSnippetLength, (int)(trackSampleRate * HotCueBank::snippetSeconds)) };
+    const int generation{ trackGeneration };
+    juce::WeakReference<AudioPlayer> safeThis{ this };
+
+    trackLoader->decodeSnippetAsync(formatManager, loadedURL, samplePosition, length,
+        [safeThis, generation, slot, samplePosition](std::shared_ptr<juce::AudioBuffer<float>> snippet)
+        {
+            if (safeThis == nullptr || safeThis->trackGeneration != generation || snippet == nullptr)
+            {
+                return;
+            }
+
+            safeThis->hotCues.storeSnippet(slot, samplePosition, *snippet);
+        });
+}
+
+//The main cue starts at the beginning of the track unless the library has one for it.
+//Cues past the end of the track, eg. after the file was replaced, are left out
+void AudioPlayer::restoreCues()
+{
+    const LibraryRecord* record{ findLibraryRecord() };
+    const double rate{ trackSampleRate };
+
+    juce::int64 mainCue{ 0 };
+    if (record != nullptr && record->mainCue >= 0.0)
+    {
+        mainCue = juce::jmin((juce::int64)std::llround(record->mainCue * rate), juce::jmax((juce::int64)0, trackLength - 1));
+    }
+    hotCues.setPosition(HotCueBank::mainCue, mainCue);
+    requestSnippet(HotCueBank::mainCue, mainCue);
+
+    if (record == nullptr)
+    {
+        return;
+    }
+
+    for (int i = 0; i < HotCueBank::numHotCues && i < LibraryRecord::numHotCues; ++i)
+    {
+        const juce::int64 samplePosition{ (juce::int64)std::llround(record->hotCues[i] * rate) };
+
+        if (record->hotCues[i] >= 0.0 && samplePosition < trackLength)
+        {
+            hotCues.setPosition(i, samplePosition);
+            requestSnippet(i, samplePosition);
+        }
+    }
+}
+
+void AudioPlayer::saveCues()
+{
+    const LibraryRecord* record{ findLibraryRecord() };
+    if (record == nullptr || trackSampleRate <= 0.0)
+    {
+        return;
+    }
+
+    LibraryRecord updated{ *record };
+    updated.mainCue = getCuePosition();
+
+    for (int i = 0; i < HotCueBank::numHotCues && i < LibraryRecord::numHotCues; ++i)
+    {
+        const juce::int64 samplePosition{ hotCues.getPosition(i) };
+        updated.hotCues[i] = samplePosition >= 0 ? samplePosition / trackSampleRate : -1.0;
+    }
+
+    library->updateRecord(updated);
+}
+
+const LibraryRecord* AudioPlayer::findLibraryRecord() const
+{
+    if (!loadedURL.isLocalFile())
+    {
+        return nullptr;
+    }
+    return library->getRecord(library->findTrack(loadedURL.getLocalFile()));
+}
+
+//Setting the loop in point at the playhead
+void AudioPlayer::setLoopIn()
+{
+    sendCommand(DeckCommand::Type::setLoopIn, 0.0, juce::Time::getHighResolutionTicks());
+}
+
+//Setting the loop out point at the playhead, which starts the loop
+void AudioPlayer::setLoopOut()
+{
+    sendCommand(DeckCommand::Type::setLoopOut, 0.0, juce::Time::getHighResolutionTicks());
+}
+
+void AudioPlayer::halveLoop()
+{
+    sendCommand(DeckCommand::Type::halveLoop);
+}
+
+void AudioPlayer::doubleLoop()
+{
+    sendCommand(DeckCommand::Type::doubleLoop);
+}
+
+void AudioPlayer::exitLoop()
+{
+    sendCommand(DeckCommand::Type::exitLoop);
+}
+
+bool AudioPlayer::isLoopRegionActive() const
+{
+    return loopRegionActive;
+}
+
+//The transportSource reports its position in seconds of the track, which is turned back into samples
+juce::int64 AudioPlayer::getTrackPlayhead() const
+{
+    return (juce::int64)std::llround(transportSource.getCurrentPosition() * trackSampleRate);
+}
+
+//The loop points are compared with the position of the DeckSource, so they are taken from it.
+//The position of the transportSource is rounded through seconds and the device sample rate, and can be
+//  a sample behind. It is only used while the message thread is swapping the source
+juce::int64 AudioPlayer::getLoopPlayhead() const
+{
+    const juce::SpinLock::ScopedTryLockType lock(sourceLock);
+
+    if (lock.isLocked() && readerSource != nullptr)
+    {
+        return readerSource->getNextReadPosition();
+    }
+    return getTrackPlayhead();
+}
+
+//Switching key-lock on or off
+void AudioPlayer::setKeyLock(bool shouldLock)
+{
+    keyLock = shouldLock;
+    sendCommand(DeckCommand::Type::setKeyLock, shouldLock ? 1.0 : 0.0);
+}
+
+bool AudioPlayer::isKeyLocked() const
+{
+    return keyLock;
+}
+
+bool AudioPlayer::isKeyLockEngaged() const
+{
+    return keyLock && TimeStretchAudioSource::isTempoInRange(speedRatio);
+}
+
+//The stretcher is never handed a speed it would have to clamp, the resampler plays the track instead
+void AudioPlayer::updateKeyLockActive()
+{
+    const bool active{ keyLockRequested && TimeStretchAudioSource::isTempoInRange(appliedSpeed) };
+
+    if (active != keyLockActive)
+    {
+        keyLockActive = active;
+        stretchSource.reset();
+    }
+}
+
+//Choosing the quality of the key-lock stretcher
+void AudioPlayer::setKeyLockQuality(TimeStretchAudioSource::Quality quality)
+{
+    sendCommand(DeckCommand::Type::setKeyLockQuality, (double)quality);
+}
+
+const std::atomic<double>& AudioPlayer::getKeyLockCpuLoad() const
+{
+    return stretchSource.getCpuLoad();
+}
+
+const std::atomic<double>& AudioPlayer::getKeyLockPeakMicroseconds() const
+{
+    return stretchSource.getPeakBlockMicroseconds();
+}
+
+//Playing from the cue position while the cue_play button is held down
+void AudioPlayer::cuePlay()
+{
+    playing = true;
+    startTransport();
+    sendCommand(DeckCommand::Type::cuePlay, 0.0, juce::Time::getHighResolutionTicks());
+}
+
+//Going back to where the playhead was before cuePlay when the cue_play button is released
+void AudioPlayer::cueRelease()
+{
+    playing = false;
+    sendCommand(DeckCommand::Type::cueRelease, 0.0, juce::Time::getHighResolutionTicks());
+}
+
+//==============================================================================
+//Pushing a command into the queue, called from the message thread
+void AudioPlayer::sendCommand(DeckCommand::Type type, double value, juce::int64 timestamp)
+{
+    DeckCommand command;
+    command.type = type;
+    command.value = value;
+    command.timestamp = timestamp;
+
+    commandQueue.push(command);
+}
+
+//Applying a single command to the sources of this player, called from the audio thread.
+//Nothing here waits and no memory is allocated. The transportSource is never started or stopped here,
+//  play and pause only set deckRunning, and renderSegment ramps the output in or out
+void AudioPlayer::applyCommand(const DeckCommand& command)
+{
+    switch (command.type)
+    {
+        //A seek still waiting for the fade out is made straight away
+        case DeckCommand::Type::start:
+            if (pendingPosition >= 0.0)
+            {
+                transportSource.setPosition(pendingPosition);
+                stretchSource.reset();
+                pendingPosition = -1.0;
+            }
+            deckRunning = true;
+            playing = true;
+            break;
+
+        case DeckCommand::Type::stop:
+            deckRunning = false;
+            break;
+
+        //A seek right after a pause, eg. the stop button going back to the start, waits for the fade out,
+        //  so the fade plays out what was playing instead of the audio at the new position
+        case DeckCommand::Type::setPosition:
+            if (!deckRunning && playFadeGain > 0.0f)
+            {
+                pendingPosition = command.value;
+                break;
+            }
+            transportSource.setPosition(command.value);
+            //The stretcher throws away what it buffered from the old position
+            stretchSource.reset();
+            break;
+
+        case DeckCommand::Type::setGain:
+            transportSource.setGain((float)command.value);
+            break;
+
+        case DeckCommand::Type::setSpeed:
+            resampleSource.setResamplingRatio(command.value);
+            stretchSource.setTempo(command.value);
+            appliedSpeed = command.value;
+            updateKeyLockActive();
+            break;
+
+        case DeckCommand::Type::setLoop:
+        {
+            //If the message thread is swapping the source right now, the new source
+            //already picks up the looping flag, so there is nothing to do
+            const juce::SpinLock::ScopedTryLockType lock(sourceLock);
+
+            if (lock.isLocked() && readerSource != nullptr)
+            {
+                readerSource->setLooping(command.value > 0.5);
+            }
+            break;
+        }
+
+        //The DeckSource makes the jump at the start of the next segment and plays the cue's snippet first.
+        //The stretcher throws away what it buffered from the old position. If a release or a seek is
+        //  still waiting for the fade out, the position it was going to is the one remembered
+        case DeckCommand::Type::cuePlay:
+            current_position = pendingPosition >= 0.0 ? pendingPosition : transportSource.getCurrentPosition();
+            pendingPosition = -1.0;
+            hotCues.requestJump(HotCueBank::mainCue);
+            deckRunning = true;
+            stretchSource.reset();
+            break;
+
+        //The playhead goes back once the deck has faded out, so the fade plays the audio after the cue
+        case DeckCommand::Type::cueRelease:
+            deckRunning = false;
+            if (playFadeGain > 0.0f)
+            {
+                pendingPosition = current_position;
+            }
+            else
+            {
+                transportSource.setPosition(current_position);
+                stretchSource.reset();
+            }
+            break;
+
+        case DeckCommand::Type::triggerHotCue:
+            hotCues.requestJump(juce::roundToInt(command.value));
+            deckRunning = true;
+            pendingPosition = -1.0;
+            playing = true;
+            stretchSource.reset();
+            break;
+
+        case DeckCommand::Type::setKeyLock:
+            keyLockRequested = command.value > 0.5;
+            updateKeyLockActive();
+            break;
+
+        case DeckCommand::Type::setKeyLockQuality:
+            stretchSource.setQuality((TimeStretchAudioSource::Quality)juce::roundToInt(command.value));
+            break;
+
+        //The in point is moved to the playhead. If the out point is not after it any more,
+        //the loop stops and waits for a new out point
+        case DeckCommand::Type::setLoopIn:
+        {
+            const juce::int64 playhead{ getLoopPlayhead() };
+            loopRegion.start = playhead;
+            if (loopRegion.end <= playhead)
+            {
+                loopRegion.end = playhead;
+                loopRegion.active = false;
+            }
+            break;
+        }
+
+        //The out point is the playhead, so the DeckSource wraps back to the in point straight away
+        case DeckCommand::Type::setLoopOut:
+        {
+            const juce::int64 playhead{ getLoopPlayhead() };
+            if (playhead > loopRegion.start)
+            {
+                loopRegion.end = playhead;
+                loopRegion.active = true;
+            }
+            break;
+        }
+
+        case DeckCommand::Type::halveLoop:
+        case DeckCommand::Type::doubleLoop:
+        {
+            if (loopRegion.getLength() <= 0)
+            {
+                break;
+            }
+
+            const juce::int64 minimumLength{ DeckSource::seamFadeLength * 2 };
+            juce::int64 length{ command.type == DeckCommand::Type::halveLoop ? loopRegion.getLength() / 2
+                                                                              : loopRegion.getLength() * 2 };
+            length = juce::jmax(minimumLength, length);
+            if (trackLength > 0)
+            {
+                length = juce::jmin(length, trackLength - loopRegion.start);
+            }
+            if (length <= 0)
+            {
+                break;
+            }
+            loopRegion.end = loopRegion.start + length;
+
+            //If the playhead is past the new out point it is moved to the same place in the shorter loop
+            const juce::int64 playhead{ getTrackPlayhead() };
+            if (loopRegion.active && playhead > loopRegion.end && trackSampleRate > 0.0)
+            {
+                const juce::int64 wrapped{ loopRegion.start + (playhead - loopRegion.start) % length };
+                transportSource.setPosition(wrapped / trackSampleRate);
+                stretchSource.reset();
+            }
+            break;
+        }
+
+        case DeckCommand::Type::exitLoop:
+            loopRegion.active = false;
+            break;
+
+        case DeckCommand::Type::clearLoop:
+            loopRegion = LoopRegion();
+            break;
+    }
 }
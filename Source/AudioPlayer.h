@@ -10,9 +10,19 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include <atomic>
+#include "DeckCommandQueue.h"
+#include "TrackLoader.h"
+#include "TimeStretchAudioSource.h"
+#include "DeckSource.h"
+#include "ReadAheadSource.h"
+#include "TrackMetadataStore.h"
+#include "LibraryDatabase.h"
+#include "AnalysisEngine.h"
 
 class AudioPlayer : public juce::AudioSource,
-                    public juce::PositionableAudioSource 
+                    public juce::PositionableAudioSource,
+                    public juce::ChangeListener
 {
 public:
 
@@ -30,10 +40,21 @@ public:
 
     //All the public functions needed to operate on the AudioTransportSource
 
-    //Loading the file into the transportSource object 
-    void loadURL(juce::URL audioURL);
-    //Setting the gain 
-    void setGain(double gain);
+    //Loading the file on a background thread. The callbacks are called on the message thread,
+    //  onProgress with a value between 0 and 1 and onLoaded once the track is ready to play
+    void loadURLAsync(juce::URL audioURL,
+                      std::function<void(float)> onProgress,
+                      std::function<void(bool)> onLoaded);
+    //Returns true while a background load is running
+    bool isLoading() const;
+    //Returns the progress of the last background load between 0 and 1
+    float getLoadProgress() const;
+    //Switching the auto gain on or off. With auto gain on, the gain of every track is offset by the
+    //  gain worked out from its loudness, so tracks mastered at different levels play equally loud.
+    //The offset is the gain of the transportSource, which ramps to it over a block. The fader of the
+    //  deck is its channel in the MixerEngine
+    void setAutoGain(bool shouldApply);
+    bool isAutoGainOn() const;
     //Setting the speed at which the track is played
     void setSpeed(double ratio);
     //Setting the position on the transportSource in seconds
@@ -46,10 +67,18 @@ public:
     //Getting the cue position back
     double getCuePosition();
 
-    //Recording the current position of the transportSource
-    void setCurrentPosition(double current_pos);
-    //Getting the recorded current position
-    double getCurrentPosition();
+    //Jumping to the cue position and playing from it, remembering where the playhead was
+    void cuePlay();
+    //Going back to the position remembered by cuePlay and stopping
+    void cueRelease();
+
+    //Hot cues, numbered from 0 to HotCueBank::numHotCues - 1.
+    //Setting a hot cue at the playhead also decodes the audio after it in the background
+    void setHotCue(int index);
+    //Jumping to a hot cue and playing from it, at the sample matching the time of the call
+    void triggerHotCue(int index);
+    void clearHotCue(int index);
+    bool hasHotCue(int index) const;
     
     //A function that return the total time of the track in minutes and seconds
     juce::String getSongLength();
@@ -61,6 +90,12 @@ public:
     void rewind();
     void forward();
 
+    //Returns true if the player is playing or has been asked to start playing
+    bool isPlaying() const;
+
+    //Called when the analysis engine has stored new results, which may be the loudness of the loaded track
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
     //Implementing the below 4 function since we inherit from PositionableAudioSource class to implement the looping function
     void setNextReadPosition(juce::int64 newPosition) override;
     juce::int64 getNextReadPosition() const override;
@@ -70,27 +105,173 @@ public:
     //Functions to set the playback to loop or not to loop
     void setLoop();
     void unsetLoop();
+
+    //Loop regions. The in and out points are taken at the playhead, to the sample, when the audio thread
+    //  applies the command. Setting the out point after the in point starts the loop
+    void setLoopIn();
+    void setLoopOut();
+    //Halving and doubling the length of the loop, keeping the in point
+    void halveLoop();
+    void doubleLoop();
+    //Leaving the loop and playing on
+    void exitLoop();
+    //Returns true while a loop region is playing
+    bool isLoopRegionActive() const;
+
+    //Switching key-lock on or off. With key-lock on the speed changes the tempo without changing the pitch
+    void setKeyLock(bool shouldLock);
+    bool isKeyLocked() const;
+    //Returns true if key-lock is on and the speed is in the range of the stretcher. Outside that range
+    //  the track is resampled, so the pitch follows the speed, until the speed is back in range
+    bool isKeyLockEngaged() const;
+    //Choosing between the low latency and the high quality key-lock
+    void setKeyLockQuality(TimeStretchAudioSource::Quality quality);
+    //The average cost of key-lock as a fraction of the block duration, and its peak cost per block in microseconds,
+    //  shown by the AudioPerformanceMonitor
+    const std::atomic<double>& getKeyLockCpuLoad() const;
+    const std::atomic<double>& getKeyLockPeakMicroseconds() const;
     
     //get the relative position of the playhead
     double getPositionRelative();
+    //The position of the playhead in seconds of the track
+    double getPositionInSeconds();
+    //The file of the track that is loaded, or an empty file if none is
+    juce::File getLoadedFile() const;
+
+    //The size in seconds of the read-ahead buffer used for the next streamed track
+    void setReadAheadSeconds(double seconds);
+    double getReadAheadSeconds() const;
+    //The underrun and seek counters of the read-ahead buffers of this player
+    const ReadAheadStats& getReadAheadStats() const;
 
     //The AudioTransportSource object used to play a file
     juce::AudioTransportSource transportSource;   
 
 private:
 
-    //Variable to record the cue position when the user press the cue_save button
-    double cue_position;
+    //Handing a newly opened source to the transportSource
+    void setReaderSource(std::unique_ptr<juce::PositionableAudioSource> newSource, double sampleRate, juce::URL audioURL);
+
+    //Starts the transportSource if it is not running, called on the message thread
+    void startTransport();
+    //Applies a single command to the transportSource and resampleSource
+    void applyCommand(const DeckCommand& command);
+    //Pushes a command into the queue so that the audio thread applies it.
+    //A command with a timestamp is applied at the matching sample, one block after it was sent
+    void sendCommand(DeckCommand::Type type, double value = 0.0, juce::int64 timestamp = 0);
+    //Returns the sample in the block at which a command sent at the given time is applied, called on the audio thread
+    int getCommandOffset(juce::int64 timestamp, int numSamples) const;
+    //Renders part of the block through the resampleSource or the stretchSource
+    void renderSegment(const juce::AudioSourceChannelInfo& bufferToFill, int start, int numSamples);
+
+    //Puts a source that decodes from a file behind a ReadAheadSource, so it is decoded on the DiskIOThread
+    std::unique_ptr<juce::PositionableAudioSource> createReadAhead(std::unique_ptr<juce::PositionableAudioSource> source, double sampleRate);
+
+    //Decodes the snippet after a cue point in the background and hands it to the hotCues
+    void requestSnippet(int slot, juce::int64 samplePosition);
+
+    //Reading the cues of the loaded track back from the library, and writing them after a change.
+    //Tracks that are not in the library keep their cues only while they are loaded
+    void restoreCues();
+    void saveCues();
+    //The library record of the loaded track, or nullptr
+    const LibraryRecord* findLibraryRecord() const;
+
+    //Reading the auto gain of the loaded track from the library, and sending the gain to the audio thread
+    void updateAutoGain();
+    void sendGain();
+
+    //The hot cues and the main cue, with the pre-decoded audio after each of them
+    HotCueBank hotCues;
+    //The track that is loaded, used to decode the cue snippets
+    juce::URL loadedURL;
+    //Increased every time a new track is handed to the transportSource
+    int trackGeneration{ 0 };
+    //The library the cues are saved in
+    juce::SharedResourcePointer<LibraryDatabase> library;
+    //Analyses a loaded track that has not been analysed yet, ahead of the rest of the library
+    juce::SharedResourcePointer<AnalysisEngine> analysisEngine;
+
+    //The auto gain of the loaded track in decibels and the gain last sent to the audio thread.
+    //Only used on the message thread
+    float autoGainDecibels{ 0.0f };
+    bool autoGainOn{ false };
+    double sentGain{ 1.0 };
+
+    //The read-ahead buffer settings and counters
+    std::atomic<double> readAheadSeconds{ ReadAheadSource::defaultBufferSeconds };
+    ReadAheadStats readAheadStats;
+
+    //The output sample rate and the time the last audio block started, in high resolution ticks.
+    //Only used by the audio thread
+    double outputSampleRate{ 0.0 };
+    juce::int64 lastBlockTicks{ 0 };
     //Variable to record the current position of the transportSource when
     //the user presses the cue_play button so we will be able to go back to it
-    //When the button is released.
+    //When the button is released. Only used by the audio thread
     double current_position;
 
+    //The commands sent from the GUI to the audio thread
+    DeckCommandQueue commandQueue;
+
+    //The state as requested by the GUI, so that it can be read back
+    //straight away without waiting for the audio thread
+    std::atomic<bool> playing{ false };
+    std::atomic<bool> looping{ false };
+
+    //The play state on the audio thread. The transportSource keeps running while the deck is paused,
+    //  and the gain of the deck's output ramps between 0 and 1 over playFadeLength samples
+    static constexpr int playFadeLength{ 256 };
+    bool deckRunning{ false };
+    float playFadeGain{ 0.0f };
+    //The position in seconds a seek made while the deck fades out, eg. by the stop button or cueRelease,
+    //  moves the playhead to once the deck is silent, or -1
+    double pendingPosition{ -1.0 };
+
+    //Held by the message thread while the readerSource is being replaced.
+    //The audio thread only ever tries to take it, so it never waits
+    juce::SpinLock sourceLock;
+
     //To be able to read audio from file
     juce::AudioFormatManager& formatManager;    
 
-    //smart pointer    
-    std::unique_ptr<juce::AudioFormatReaderSource> readerSource;    
+    //smart pointer to the source being played. The DeckSource takes care of the loop region and
+    //  wraps the track's own source, which streams from a file or plays from the DecodedTrackCache
+    std::unique_ptr<DeckSource> readerSource;    
+
+    //The loop region, only changed and read on the audio thread
+    LoopRegion loopRegion;
+    //A copy of loopRegion.active for the GUI
+    std::atomic<bool> loopRegionActive{ false };
+    //The sample rate and the length in samples of the loaded track
+    std::atomic<double> trackSampleRate{ 0.0 };
+    std::atomic<juce::int64> trackLength{ 0 };
+    //Returns the position of the playhead in samples of the track, used on the audio thread
+    juce::int64 getTrackPlayhead() const;
+    //Returns the position the DeckSource reads from next, which the loop points are set at. Used on the audio thread
+    juce::int64 getLoopPlayhead() const;
 
     juce::ResamplingAudioSource resampleSource{ &transportSource, false, 2 };
+
+    //Used instead of the resampleSource when key-lock is on
+    TimeStretchAudioSource stretchSource{ &transportSource };
+    //The key-lock state requested by the GUI and the one in use on the audio thread
+    std::atomic<bool> keyLock{ false };
+    bool keyLockActive{ false };
+    //The speed as set by the GUI, and the key-lock state and speed as the audio thread last applied them
+    std::atomic<double> speedRatio{ 1.0 };
+    bool keyLockRequested{ false };
+    double appliedSpeed{ 1.0 };
+    //Choosing between the stretcher and the resampler from the key-lock state and the speed, on the audio thread
+    void updateKeyLockActive();
+
+    //The loader shared by every player that opens tracks in the background
+    juce::SharedResourcePointer<TrackLoader> trackLoader;
+    //Increased on every load, so that a slow load finishing after a newer one is ignored
+    int loadGeneration{ 0 };
+    //The state of the last background load
+    bool loading{ false };
+    float loadProgress{ 0.0f };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(AudioPlayer)
 };
\ No newline at end of file
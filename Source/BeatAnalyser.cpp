@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+
+    BeatAnalyser.cpp
+    Created: 17 Oct 2026 3:18:17pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "BeatAnalyser.h"
+#include <cmath>
+
+//The hop is about 11.6 ms whatever the sample rate, which is 512 samples at 44.1kHz
+BeatAnalyser::BeatAnalyser(double _sampleRate)
+    : sampleRate(_sampleRate)
+{
+    hopSize = juce::jmax(64, juce::roundToInt(sampleRate / 86.1328125));
+    squares.resize((size_t)hopSize);
+}
+
+BeatAnalyser::~BeatAnalyser()
+{
+
+}
+
+//==============================================================================
+//The samples are squared with a vector multiply and summed into 8 separate sums, so the compiler
+//  can keep the sums in a vector register
+void BeatAnalyser::process(const float* samples, int numSamples)
+{
+    int done{ 0 };
+
+    while (done < numSamples)
+    {
+        const int count{ juce::jmin(hopSize - samplesInHop, numSamples - done) };
+        juce::FloatVectorOperations::multiply(squares.data(), samples + done, samples + done, count);
+
+        float sums[8]{};
+        int i{ 0 };
+
+        for (; i + 8 <= count; i += 8)
+        {
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                sums[lane] += squares[(size_t)(i + lane)];
+            }
+        }
+        for (; i < count; ++i)
+        {
+            sums[0] += squares[(size_t)i];
+        }
+
+        hopEnergy += ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+        samplesInHop += count;
+        done += count;
+
+        if (samplesInHop == hopSize)
+        {
+            addHop(hopEnergy);
+            samplesInHop = 0;
+            hopEnergy = 0.0f;
+        }
+    }
+}
+
+//The log compresses loud and quiet passages alike, so a beat counts the same in a breakdown as in a drop.
+//Only rises in energy are onsets
+void BeatAnalyser::addHop(float energy)
+{
+    const float logEnergy{ std::log1p(1000.0f * energy / (float)hopSize) };
+
+    envelope.push_back(envelope.empty() ? 0.0f : juce::jmax(0.0f, logEnergy - lastLogEnergy));
+    lastLogEnergy = logEnergy;
+}
+
+//==============================================================================
+bool BeatAnalyser::finish()
+{
+    const double hopsPerSecond{ sampleRate / hopSize };
+    const double shortestLag{ hopsPerSecond * 60.0 / maxBpm };
+    const double longestLag{ hopsPerSecond * 60.0 / minBpm };
+    const int numHops{ (int)envelope.size() };
+
+    bpm = 0.0f;
+    beatOffset = 0.0f;
+
+    //At least 8 beats at the slowest tempo are needed
+    if (numHops < (int)(longestLag * 8.0))
+    {
+        return false;
+    }
+
+    //Taking away the local average leaves the peaks that stand out from their surroundings
+    {
+        const int halfWindow{ 8 };
+        std::vector<float> sums((size_t)numHops + 1, 0.0f);
+        for (int n = 0; n < numHops; ++n)
+        {
+            sums[(size_t)n + 1] = sums[(size_t)n] + envelope[(size_t)n];
+        }
+
+        std::vector<float> detrended((size_t)numHops);
+        for (int n = 0; n < numHops; ++n)
+        {
+            const int from{ juce::jmax(0, n - halfWindow) };
+            const int to{ juce::jmin(numHops, n + halfWindow + 1) };
+            const float average{ (sums[(size_t)to] - sums[(size_t)from]) / (float)(to - from) };
+            detrended[(size_t)n] = juce::jmax(0.0f, envelope[(size_t)n] - average);
+        }
+        envelope.swap(detrended);
+    }
+
+    //Every whole lag in the range is scored by its autocorrelation plus half that of twice the lag, which
+    //  backs up periods whose multiples also line up. A prior around preferredBpm settles between a
+    //  tempo and its half or double
+    double bestLag{ 0.0 };
+    {
+        const int firstLag{ (int)std::floor(shortestLag) };
+        const int lastLag{ (int)std::ceil(longestLag) };
+        std::vector<float> scores((size_t)(lastLag - firstLag + 1), 0.0f);
+
+        for (int lag = firstLag; lag <= lastLag; ++lag)
+        {
+            const float lagBpm{ (float)(hopsPerSecond * 60.0 / lag) };
+            const float octaves{ std::log2(lagBpm / preferredBpm) / priorWidth };
+            const float prior{ std::exp(-0.5f * octaves * octaves) };
+
+            scores[(size_t)(lag - firstLag)] = prior * (getCorrelation(lag) + 0.5f * getCorrelation(2.0 * lag));
+        }
+
+        int best{ 0 };
+        for (int i = 1; i < (int)scores.size(); ++i)
+        {
+            if (scores[(size_t)i] > scores[(size_t)best])
+            {
+                best = i;
+            }
+        }
+
+        if (scores[(size_t)best] <= 0.0f)
+        {
+            return false;
+        }
+
+        //A parabola through the best score and its neighbours places the peak between 2 lags
+        double shift{ 0.0 };
+        if (best > 0 && best < (int)scores.size() - 1)
+        {
+            const float left{ scores[(size_t)best - 1] };
+            const float centre{ scores[(size_t)best] };
+            const float right{ scores[(size_t)best + 1] };
+            const float denominator{ left - 2.0f * centre + right };
+
+            if (denominator < 0.0f)
+            {
+                shift = juce::jlimit(-0.5, 0.5, 0.5 * (double)(left - right) / (double)denominator);
+            }
+        }
+        bestLag = firstLag + best + shift;
+    }
+
+    //A small error in the period adds up over many beats, so the period is refined by lining up beats
+    //  that are 1, 2, 4 and up to 64 beats apart. The further apart, the sharper the peak
+    {
+        const int numSteps{ 400 };
+        double refinedLag{ bestLag };
+        float bestScore{ -1.0f };
+
+        for (int step = 0; step <= numSteps; ++step)
+        {
+            const double lag{ bestLag * (0.98 + 0.04 * step / numSteps) };
+            float score{ 0.0f };
+
+            for (int beats = 1; beats <= 64 && lag * beats < numHops / 2; beats *= 2)
+            {
+                score += getCorrelation(lag * beats);
+            }
+
+            if (score > bestScore)
+            {
+                bestScore = score;
+                refinedLag = lag;
+            }
+        }
+        bestLag = refinedLag;
+    }
+
+    //The phase is the offset into the first beat whose comb of beats collects the most onset
+    double bestPhase{ 0.0 };
+    {
+        float bestScore{ -1.0f };
+
+        for (double phase = 0.0; phase < bestLag; phase += 0.25)
+        {
+            float score{ 0.0f };
+
+            for (double position = phase; position < numHops - 1; position += bestLag)
+            {
+                score += getEnvelope(position);
+            }
+
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestPhase = phase;
+            }
+        }
+    }
+
+    bpm = (float)(hopsPerSecond * 60.0 / bestLag);
+    //An onset lands somewhere in its hop, so the middle of the hop is taken
+    beatOffset = (float)((bestPhase + 0.5) * hopSize / sampleRate);
+
+    return true;
+}
+
+float BeatAnalyser::getBpm() const
+{
+    return bpm;
+}
+
+float BeatAnalyser::getBeatOffset() const
+{
+    return beatOffset;
+}
+
+//==============================================================================
+float BeatAnalyser::getCorrelation(double lag) const
+{
+    const int wholeLag{ (int)lag };
+    const float fraction{ (float)(lag - wholeLag) };
+    const int count{ (int)envelope.size() - wholeLag - 1 };
+
+    if (count <= 0)
+    {
+        return 0.0f;
+    }
+
+    const float* env{ envelope.data() };
+    float sum{ 0.0f };
+
+    for (int n = 0; n < count; ++n)
+    {
+        sum += env[n] * (env[n + wholeLag] + fraction * (env[n + wholeLag + 1] - env[n + wholeLag]));
+    }
+
+    return sum / (float)count;
+}
+
+float BeatAnalyser::getEnvelope(double position) const
+{
+    const int index{ (int)position };
+    const float fraction{ (float)(position - index) };
+
+    return envelope[(size_t)index] + fraction * (envelope[(size_t)index + 1] - envelope[(size_t)index]);
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    BeatAnalyser.h
+    Created: 17 Oct 2026 3:18:17pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+//Finds the tempo and the beat grid of a track from its mono audio, fed in blocks of any size.
+//While the audio is fed, the energy of every hop of samples is turned into an onset envelope: how much
+//  the log energy rose since the last hop. Only the envelope is kept, about 86 values per second.
+//When the track is finished, the autocorrelation of the envelope gives the beat period, which is then
+//  refined over several beats, and the phase of the beats is the offset that lines up best with the onsets
+class BeatAnalyser
+{
+public:
+    //The tempo range searched, in beats per minute
+    static constexpr float minBpm{ 60.0f };
+    static constexpr float maxBpm{ 200.0f };
+
+    explicit BeatAnalyser(double sampleRate);
+    ~BeatAnalyser();
+
+    //Adding the next block of mono audio
+    void process(const float* samples, int numSamples);
+
+    //Working out the tempo and the beat grid from everything that was fed. Returns false if the
+    //  track was too short or had no beats that could be found
+    bool finish();
+
+    //The results of finish()
+    float getBpm() const;
+    //The time of the first beat in seconds. The other beats follow every 60 / bpm seconds
+    float getBeatOffset() const;
+
+private:
+    //Turning the energy of a hop into the next value of the onset envelope
+    void addHop(float energy);
+
+    //The autocorrelation of the envelope at a lag in hops, which does not have to be a whole number
+    float getCorrelation(double lag) const;
+    //The envelope between 2 hops, read with linear interpolation
+    float getEnvelope(double position) const;
+
+    //The tempo that the prior favours, and how quickly it falls off in octaves
+    static constexpr float preferredBpm{ 120.0f };
+    static constexpr float priorWidth{ 1.0f };
+
+    double sampleRate;
+    //The number of samples in a hop
+    int hopSize{ 512 };
+
+    //The samples of the hop being filled and their sum of squares
+    int samplesInHop{ 0 };
+    float hopEnergy{ 0.0f };
+    //The log energy of the last hop
+    float lastLogEnergy{ 0.0f };
+
+    //The onset envelope, one value per hop
+    std::vector<float> envelope;
+    //Scratch space used by process()
+    std::vector<float> squares;
+
+    float bpm{ 0.0f };
+    float beatOffset{ 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BeatAnalyser)
+};
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    CachedTrackSource.cpp
+    Created: 17 Oct 2026 1:31:20pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "CachedTrackSource.h"
+
+CachedTrackSource::CachedTrackSource(std::shared_ptr<const DecodedTrack> _track)
+    : track(std::move(_track))
+{
+
+}
+
+CachedTrackSource::~CachedTrackSource()
+{
+
+}
+
+//==============================================================================
+void CachedTrackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+
+}
+
+//Copying the samples from the decoded track into the output buffer.
+//Nothing is decoded or allocated, it is only a copy
+void CachedTrackSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const juce::AudioBuffer<float>& samples{ track->buffer };
+    const juce::int64 totalLength{ samples.getNumSamples() };
+    const int numSourceChannels{ samples.getNumChannels() };
+
+    int done{ 0 };
+
+    while (done < bufferToFill.numSamples)
+    {
+        if (looping && totalLength > 0 && position >= totalLength)
+        {
+            position = position % totalLength;
+        }
+
+        const int available{ (int)juce::jlimit((juce::int64)0, (juce::int64)(bufferToFill.numSamples - done), totalLength - position) };
+
+        //At the end of a track that does not loop, the rest of the block is silence
+        if (available <= 0 || numSourceChannels == 0)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + done, bufferToFill.numSamples - done);
+            position += bufferToFill.numSamples - done;
+            break;
+        }
+
+        //A mono track is copied into every output channel
+        for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel)
+        {
+            bufferToFill.buffer->copyFrom(channel,
+                bufferToFill.startSample + done,
+                samples,
+                juce::jmin(channel, numSourceChannels - 1),
+                (int)position,
+                available);
+        }
+
+        done += available;
+        position += available;
+    }
+}
+
+void CachedTrackSource::releaseResources()
+{
+
+}
+
+//==============================================================================
+void CachedTrackSource::setNextReadPosition(juce::int64 newPosition)
+{
+    position = juce::jmax((juce::int64)0, newPosition);
+}
+
+juce::int64 CachedTrackSource::getNextReadPosition() const
+{
+    const juce::int64 totalLength{ track->buffer.getNumSamples() };
+
+    return (looping && totalLength > 0) ? position % totalLength : position;
+}
+
+juce::int64 CachedTrackSource::getTotalLength() const
+{
+    return track->buffer.getNumSamples();
+}
+
+bool CachedTrackSource::isLooping() const
+{
+    return looping;
+}
+
+void CachedTrackSource::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+}
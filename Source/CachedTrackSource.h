@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    CachedTrackSource.h
+    Created: 17 Oct 2026 1:31:20pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include "DecodedTrackCache.h"
+
+//==============================================================================
+//A PositionableAudioSource that plays a track straight from the DecodedTrackCache.
+//It holds a reference to the decoded track, so the cache cannot evict it while it is playing,
+//  and any number of sources can play the same decoded track at the same time
+class CachedTrackSource : public juce::PositionableAudioSource
+{
+public:
+    CachedTrackSource(std::shared_ptr<const DecodedTrack> _track);
+    ~CachedTrackSource() override;
+
+    //The 3 functions that need to be implemented since we inherit from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //The functions that need to be implemented since we inherit from PositionableAudioSource
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+private:
+    //The decoded track being played
+    std::shared_ptr<const DecodedTrack> track;
+
+    //The position of the next sample to be read
+    juce::int64 position{ 0 };
+
+    //True if the source goes back to the start when it reaches the end
+    bool looping{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CachedTrackSource)
+};
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.cpp
+    Created: 17 Oct 2026 10:12:31am
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "DeckCommandQueue.h"
+
+DeckCommandQueue::DeckCommandQueue()
+{
+
+}
+
+DeckCommandQueue::~DeckCommandQueue()
+{
+
+}
+
+//Writing a command into the next free slot of the ring
+bool DeckCommandQueue::push(const DeckCommand& command)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    //If there is no free slot, the command is dropped
+    if (size1 + size2 < 1)
+    {
+        DBG("DeckCommandQueue::push the queue is full, command dropped");
+        return false;
+    }
+
+    commands[size1 > 0 ? start1 : start2] = command;
+    fifo.finishedWrite(1);
+
+    return true;
+}
+
+//Reading the oldest command from the ring, if there is one
+bool DeckCommandQueue::pop(DeckCommand& command)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        return false;
+    }
+
+    command = commands[size1 > 0 ? start1 : start2];
+    fifo.finishedRead(1);
+
+    return true;
+}
+
+//Reading the oldest command, leaving it in the ring for the next pop
+bool DeckCommandQueue::peek(DeckCommand& command) const
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        return false;
+    }
+
+    command = commands[size1 > 0 ? start1 : start2];
+
+    return true;
+}
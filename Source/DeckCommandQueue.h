@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.h
+    Created: 17 Oct 2026 10:12:31am
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+//==============================================================================
+//A single command sent from the GUI (message thread) to an AudioPlayer.
+//The audio thread applies these commands at the start of every audio block, or, for the commands
+//  that carry a timestamp, at the sample in the block that matches the time they were sent
+struct DeckCommand
+{
+    enum class Type
+    {
+        start,
+        stop,
+        setPosition,
+        setGain,
+        setSpeed,
+        setLoop,
+        cuePlay,
+        cueRelease,
+        setKeyLock,
+        setKeyLockQuality,
+        setLoopIn,
+        setLoopOut,
+        halveLoop,
+        doubleLoop,
+        exitLoop,
+        clearLoop,
+        triggerHotCue
+    };
+
+    Type type{ Type::stop };
+
+    //The argument of the command, eg. the position in seconds, the gain or the speed ratio
+    double value{ 0.0 };
+
+    //The time the command was sent in high resolution ticks, or 0 to apply it at the start of the next block
+    juce::int64 timestamp{ 0 };
+};
+
+//==============================================================================
+//A single-producer/single-consumer ring of DeckCommands.
+//The message thread is the only one that pushes and the audio thread is the only one that pops,
+//  so neither side ever takes a lock or allocates memory
+class DeckCommandQueue
+{
+public:
+    DeckCommandQueue();
+    ~DeckCommandQueue();
+
+    //Called from the message thread. Returns false if the ring is full and the command was dropped
+    bool push(const DeckCommand& command);
+
+    //Called from the audio thread. Returns false when there are no more commands waiting
+    bool pop(DeckCommand& command);
+
+    //Called from the audio thread. Reads the oldest command without removing it
+    bool peek(DeckCommand& command) const;
+
+private:
+    //The number of commands the ring can hold, enough for a few seconds of slider dragging
+    static constexpr int capacity{ 512 };
+
+    //The AbstractFifo keeps track of the read and write positions with atomics
+    juce::AbstractFifo fifo{ capacity };
+
+    //The storage of the commands themselves, allocated once
+    std::array<DeckCommand, capacity> commands;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckCommandQueue)
+};
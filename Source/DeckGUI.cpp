@@ -28,10 +28,26 @@ DeckGUI::DeckGUI(AudioPlayer* _player,
     addAndMakeVisible(loadFile);
     addAndMakeVisible(SaveToPlaylist);
     addAndMakeVisible(loop);
+    addAndMakeVisible(keyLock);
+    addAndMakeVisible(keyLockHQ);
+    addAndMakeVisible(autoGain);
     addAndMakeVisible(rewind);
     addAndMakeVisible(fforward);
     addAndMakeVisible(cue_save);
     addAndMakeVisible(cue_play);
+    addAndMakeVisible(loopIn);
+    addAndMakeVisible(loopOut);
+    addAndMakeVisible(loopHalve);
+    addAndMakeVisible(loopDouble);
+    addAndMakeVisible(loopExit);
+
+    for (int i = 0; i < HotCueBank::numHotCues; ++i)
+    {
+        hotCueButtons[i].setButtonText(juce::String(i + 1));
+        hotCueButtons[i].setTriggeredOnMouseDown(true);
+        hotCueButtons[i].addListener(this);
+        addAndMakeVisible(hotCueButtons[i]);
+    }
 
     //Setting the below buttons to be triggered when they are pressed down
     //as the default setting is that they are triggered when the mouse button is released
@@ -41,6 +57,8 @@ DeckGUI::DeckGUI(AudioPlayer* _player,
     fforward.setTriggeredOnMouseDown(true);
     cue_save.setTriggeredOnMouseDown(true);
     cue_play.setTriggeredOnMouseDown(true);
+    loopIn.setTriggeredOnMouseDown(true);
+    loopOut.setTriggeredOnMouseDown(true);
 
     //Making visible the 3 sliders
     addAndMakeVisible(gain);
@@ -56,11 +74,19 @@ DeckGUI::DeckGUI(AudioPlayer* _player,
     fforward.addListener(this);
     cue_save.addListener(this);
     cue_play.addListener(this);
+    loopIn.addListener(this);
+    loopOut.addListener(this);
+    loopHalve.addListener(this);
+    loopDouble.addListener(this);
+    loopExit.addListener(this);
 
     gain.addListener(this);
     speed.addListener(this);
     position.addListener(this);
     loop.addListener(this);
+    keyLock.addListener(this);
+    keyLockHQ.addListener(this);
+    autoGain.addListener(this);
 
     //setting the ranges for the sliders
     gain.setRange(0.0, 1.0);
@@ -114,9 +140,25 @@ void DeckGUI::resized()
     loadFile.setBounds(getWidth()/3, rowH, getWidth() / 3, rowH);
     SaveToPlaylist.setBounds(getWidth() / 3*2, rowH, getWidth() / 3, rowH);
 
-    gain.setBounds(0, rowH*2, getWidth() / 2, rowH*2);
-    speed.setBounds(getWidth() / 2, rowH*2, getWidth() / 2, rowH*2);
-    position.setBounds(5, rowH*4, getWidth()-5, rowH);
+    //The toggles get a row of their own above the rotary sliders, so they never take the sliders' drags
+    keyLock.setBounds(getWidth() - 180, rowH*2, 90, rowH / 2);
+    keyLockHQ.setBounds(getWidth() - 90, rowH*2, 90, rowH / 2);
+    autoGain.setBounds(0, rowH*2, 90, rowH / 2);
+    gain.setBounds(0, rowH*2 + rowH / 2, getWidth() / 2, rowH*1.5);
+    speed.setBounds(getWidth() / 2, rowH*2 + rowH / 2, getWidth() / 2, rowH*1.5);
+    position.setBounds(5, rowH*4, getWidth()-5, rowH / 2);
+
+    loopIn.setBounds(0, rowH * 4 + rowH / 2, button_width, rowH / 2);
+    loopOut.setBounds(button_width, rowH * 4 + rowH / 2, button_width, rowH / 2);
+    loopHalve.setBounds(button_width * 2, rowH * 4 + rowH / 2, button_width, rowH / 2);
+    loopDouble.setBounds(button_width * 3, rowH * 4 + rowH / 2, button_width, rowH / 2);
+    loopExit.setBounds(button_width * 4, rowH * 4 + rowH / 2, button_width, rowH / 2);
+
+    double hot_cue_width = getWidth() / (double)HotCueBank::numHotCues;
+    for (int i = 0; i < HotCueBank::numHotCues; ++i)
+    {
+        hotCueButtons[i].setBounds(hot_cue_width * i, rowH * 5, hot_cue_width, rowH / 2);
+    }
 }
 
 //A function that is implemented since we inherit from Button Listener class
@@ -128,7 +170,7 @@ void DeckGUI::buttonClicked(juce::Button* button)
     {        
         //A check is made to see whether the player is already playing a track
         //if so, the player just stops playing
-        if (player->transportSource.isPlaying())
+        if (player->isPlaying())
         {
             DBG("Track paused");
             player->stop();          
@@ -143,16 +185,20 @@ void DeckGUI::buttonClicked(juce::Button* button)
             if (started == false)
             {
                 gain.setValue(0.25, juce::dontSendNotification);
-                player->setGain(gain.getValue());
+                if (onGainChanged != nullptr)
+                {
+                    onGainChanged((float)gain.getValue());
+                }
                 speed.setValue(1.00, juce::dontSendNotification);
                 player->setSpeed(speed.getValue());
+                updateKeyLockButton();
             }
             //player starts playing
             player->start(); 
             //the started bool variable is set to true
             started = true;
             //If the player is playing the timer is started
-            if (player->transportSource.isPlaying())
+            if (player->isPlaying())
             {
                 startTimer(200);
             }
@@ -178,13 +224,11 @@ void DeckGUI::buttonClicked(juce::Button* button)
         //the current position of the player is recorded and saved for later
         //the position of the player is set to the cue position and the player starts playing      
         cue = true;
-        player->setCurrentPosition(player->transportSource.getCurrentPosition());
-        player->setPosition(player->getCuePosition());
-        player->start();
+        player->cuePlay();
         //if the player is already playing the button state is set to on
         //this is used by the paint function to change its colour
         //the timer is started as well
-        if (player->transportSource.isPlaying())
+        if (player->isPlaying())
         {
             button->setToggleState(true, false);
             startTimer(200);
@@ -206,21 +250,7 @@ void DeckGUI::buttonClicked(juce::Button* button)
         if (chooser.browseForFileToOpen())
         {
             fileLoaded = chooser.getResult();
-            //The URL of the file is passed to the loadURL function of the player and is loaded
-            //  into the transportSource object of the player
-            player->loadURL(juce::URL{ fileLoaded });
-            //The URL of the file is passed to the loadURL function of the waveformDisplay object and is loaded
-            //  into the audioThumb object 
-            w_display->loadURL(juce::URL{ fileLoaded });
-            //The filename and the song length of the chosen file is passed to the setTitle function found in the
-            //TrackTitle class
-            title->setTitle(fileLoaded.getFileNameWithoutExtension().toUpperCase(),player->getSongLength());
-            
-            //if the the loop toggle button is on, the player is set to loop the track
-            if (loop.getToggleState() == true)
-            {
-                player->setLoop();
-            }
+            loadTrack(fileLoaded);
         }
     }
 
@@ -244,16 +274,161 @@ void DeckGUI::buttonClicked(juce::Button* button)
             player->unsetLoop();
         }
     }
+
+    //The loop buttons set the loop region of the player. The in and out points are taken
+    //  by the audio thread at the playhead, so the loop is exact to the sample
+    if (button == &loopIn)
+    {
+        player->setLoopIn();
+    }
+
+    if (button == &loopOut)
+    {
+        player->setLoopOut();
+    }
+
+    if (button == &loopHalve)
+    {
+        player->halveLoop();
+    }
+
+    if (button == &loopDouble)
+    {
+        player->doubleLoop();
+    }
+
+    if (button == &loopExit)
+    {
+        player->exitLoop();
+    }
+
+    //The hot cue buttons. The jump is made by the audio thread at the sample matching the time of the click
+    for (int i = 0; i < HotCueBank::numHotCues; ++i)
+    {
+        if (button != &hotCueButtons[i])
+        {
+            continue;
+        }
+
+        if (juce::ModifierKeys::currentModifiers.isShiftDown())
+        {
+            player->clearHotCue(i);
+        }
+        else if (player->hasHotCue(i))
+        {
+            player->triggerHotCue(i);
+            started = true;
+            startTimer(200);
+        }
+        else
+        {
+            player->setHotCue(i);
+        }
+        repaint();
+    }
+
+    //The key lock toggle button keeps the pitch of the track when the speed is changed
+    if (button == &keyLock)
+    {
+        player->setKeyLock(keyLock.getToggleState());
+        updateKeyLockButton();
+    }
+
+    //The HQ toggle button switches the key lock between the low latency and the high quality setting
+    if (button == &keyLockHQ)
+    {
+        player->setKeyLockQuality(keyLockHQ.getToggleState() ? TimeStretchAudioSource::Quality::high
+                                                             : TimeStretchAudioSource::Quality::live);
+    }
+
+    //The auto gain toggle button plays every analysed track at the same loudness
+    if (button == &autoGain)
+    {
+        player->setAutoGain(autoGain.getToggleState());
+    }
+}
+
+//The cue_play button is let go as soon as the mouse is released, instead of waiting for the timer,
+//  so the player goes back to where it was without any delay
+void DeckGUI::buttonStateChanged(juce::Button* button)
+{
+    if (button == &cue_play && !cue_play.isDown() && cue == true)
+    {
+        cue = false;
+        player->cueRelease();
+        cue_play.setToggleState(false, false);
+    }
+}
+
+//Loading a track into the player in the background.
+//The title shows the progress of the load and the waveform is loaded once the track is ready
+//The key lock only keeps the pitch between the stretcher's minimum and maximum tempo. Outside that range
+//  the track is resampled, so the toggle says so in red until the speed is back in range
+void DeckGUI::updateKeyLockButton()
+{
+    if (keyLock.getToggleState() && !player->isKeyLockEngaged())
+    {
+        keyLock.setButtonText("Key Lock " + juce::String{ TimeStretchAudioSource::minTempo } + "-"
+                              + juce::String{ TimeStretchAudioSource::maxTempo } + "x");
+        keyLock.setColour(juce::ToggleButton::textColourId, juce::Colours::red);
+    }
+    else
+    {
+        keyLock.setButtonText("Key Lock");
+        keyLock.removeColour(juce::ToggleButton::textColourId);
+    }
+}
+
+void DeckGUI::loadTrack(juce::File file)
+{
+    juce::String trackName{ file.getFileNameWithoutExtension().toUpperCase() };
+    title->setTitle(trackName, "Loading...");
+
+    //A safe pointer is used since the deck could be deleted before the load finishes
+    juce::Component::SafePointer<DeckGUI> safeThis{ this };
+
+    //The URL of the file is passed to the loadURLAsync function of the player and is loaded
+    //  into the transportSource object of the player on a background thread.
+    //If the loop toggle button is on, the new track picks up the looping state of the player
+    player->loadURLAsync(juce::URL{ file },
+        [safeThis, trackName](float progress)
+        {
+            if (safeThis != nullptr)
+            {
+                safeThis->title->setTitle(trackName, "Loading " + juce::String(juce::roundToInt(progress * 100.0f)) + "%");
+            }
+        },
+        [safeThis, trackName, file](bool loadedOk)
+        {
+            if (safeThis == nullptr)
+            {
+                return;
+            }
+
+            if (loadedOk)
+            {
+                //The URL of the file is passed to the loadURL function of the waveformDisplay object and is loaded
+                //  into the audioThumb object 
+                safeThis->w_display->loadURL(juce::URL{ file });
+                //The filename and the song length of the chosen file is passed to the setTitle function found in the
+                //TrackTitle class
+                safeThis->title->setTitle(trackName, safeThis->player->getSongLength());
+            }
+            else
+            {
+                safeThis->title->setTitle(trackName, "Could not load the file");
+            }
+        });
 }
 
 //Implement a slider listener
 void DeckGUI::sliderValueChanged(juce::Slider* slider)
 {
-    //Wheneve the gain slider value changes, the player's gain is changed according to the
+    //Wheneve the gain slider value changes, the fader of the deck's mixer channel is changed according to the
     //slider's value
-    if (slider == &gain)
+    if (slider == &gain && onGainChanged != nullptr)
     {
-        player->setGain(slider->getValue());
+        onGainChanged((float)slider->getValue());
     }
 
     //Wheneve the speed slider value changes, the player's speed is changed according to the
@@ -261,6 +436,7 @@ void DeckGUI::sliderValueChanged(juce::Slider* slider)
     if (slider == &speed)
     {
         player->setSpeed(slider->getValue());
+        updateKeyLockButton();
     }
 
     //Wheneve the position slider value changes the player's position along the track is changed according to the
@@ -280,7 +456,7 @@ void DeckGUI::buttonTimerCallback()
     //and the player rewind function gets called
     if (rewind.isDown() && cue == false)
     {   
-        if (player->transportSource.isPlaying())
+        if (player->isPlaying())
         {
             rewind.setToggleState(true, false);
             player->rewind();            
@@ -297,7 +473,7 @@ void DeckGUI::buttonTimerCallback()
     //the player forward function gets called
     if (fforward.isDown() && cue == false)
     {
-        if (player->transportSource.isPlaying())
+        if (player->isPlaying())
         {
             fforward.setToggleState(true, false);
             player->forward();              
@@ -308,18 +484,6 @@ void DeckGUI::buttonTimerCallback()
     {
         fforward.setToggleState(false, false);
     }
-    
-    //if the cue_play button is not down or released
-    //cue is set to false, the player's position is set to the position 
-    //that was saved earlier when the cue_play button was first pressed
-    //the cue_play button toggle state is set to false
-    if (!cue_play.isDown() && cue == true)
-    {
-        cue = false;        
-        player->setPosition(player->getCurrentPosition());        
-        player->stop();
-        cue_play.setToggleState(false, false);        
-    }    
 }
 
 //Implementing this function since we inherit from the timer class
@@ -333,6 +497,9 @@ void DeckGUI::timerCallback()
     position.setValue(player->getPositionRelative(),juce::NotificationType::dontSendNotification);
     //The playhead position is updated according to the player's relative position
     w_display->setPositionRelative(player->getPositionRelative());    
+
+    //The loop out button stays lit while a loop region is playing
+    loopOut.setToggleState(player->isLoopRegionActive(), juce::dontSendNotification);
 }
 
 //Function takes care of the painting of the buttons
@@ -413,6 +580,28 @@ void DeckGUI::buttonsRepainting()
         cue_save.setColour(juce::TextButton::buttonColourId, juce::Colours::darkslategrey);
     }
 
+    //The loop buttons follow the same colours as the other buttons
+    for (juce::TextButton* loopButton : { &loopIn, &loopOut, &loopHalve, &loopDouble, &loopExit })
+    {
+        loopButton->setColour(juce::TextButton::buttonColourId,
+            loopButton->isOver() ? juce::Colours::darkcyan : juce::Colours::darkslategrey);
+    }
+
+    //The hot cues that are set are shown in darkorange
+    for (int i = 0; i < HotCueBank::numHotCues; ++i)
+    {
+        juce::Colour colour{ hotCueButtons[i].isOver() ? juce::Colours::darkcyan : juce::Colours::darkslategrey };
+        if (player->hasHotCue(i))
+        {
+            colour = juce::Colours::darkorange;
+        }
+        hotCueButtons[i].setColour(juce::TextButton::buttonColourId, colour);
+    }
+
+    //While a loop region is playing the loop out button is shown in darkorange
+    loopOut.setColour(juce::TextButton::buttonOnColourId, juce::Colours::darkorange);
+    loopOut.setToggleState(player->isLoopRegionActive(), juce::dontSendNotification);
+
     //The below 3 statements sets the colour of the buttons darkorange whenever the buttons togglestates are on
     cue_play.setColour(juce::TextButton::buttonOnColourId, juce::Colours::darkorange);
     rewind.setColour(juce::TextButton::buttonOnColourId, juce::Colours::darkorange);
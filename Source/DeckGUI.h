@@ -39,6 +39,8 @@ public:
 
     //Needs to be implemented since we inherit from Button::Listener class
     void buttonClicked(juce::Button* button) override;
+    //Called as soon as a button is pressed or released, used to catch the release of the cue_play button
+    void buttonStateChanged(juce::Button* button) override;
 
     //Implement a slider listener
     void sliderValueChanged(juce::Slider* slider) override;  
@@ -52,11 +54,21 @@ public:
     //A function that takes care of the painting and graphical representation of the sliders
     void slidersRepainting();
 
+    //Called with the value of the gain slider whenever it changes. The gain slider is the fader of the
+    //  deck's channel in the mixer, so the MainComponent sends it there
+    std::function<void(float)> onGainChanged;
+
 private:
     
     //A function that perform operations on the buttons in the timercallback function
     void buttonTimerCallback();
 
+    //A function that loads a file into the player in the background and updates the title and waveform
+    void loadTrack(juce::File file);
+
+    //A function that shows on the key lock toggle when the speed is outside the key lock range
+    void updateKeyLockButton();
+
     //Set of buttons 
     juce::TextButton playButton{" Play / Pause "};     
     juce::TextButton stopButton{ " Stop " };
@@ -65,9 +77,23 @@ private:
     juce::TextButton rewind{ "<<" };
     juce::TextButton fforward{ ">>" };
     juce::ToggleButton loop{ "Loop" };
+    juce::ToggleButton keyLock{ "Key Lock" };
+    juce::ToggleButton keyLockHQ{ "HQ" };
+    juce::ToggleButton autoGain{ "Auto Gain" };
     juce::TextButton cue_save{ "CUE Save" };
     juce::TextButton cue_play{ "CUE Play" };
 
+    //Buttons for the loop region
+    juce::TextButton loopIn{ "LOOP IN" };
+    juce::TextButton loopOut{ "LOOP OUT" };
+    juce::TextButton loopHalve{ "1/2" };
+    juce::TextButton loopDouble{ "x2" };
+    juce::TextButton loopExit{ "EXIT" };
+
+    //The hot cue buttons. Clicking an empty one sets it at the playhead, clicking a set one jumps
+    //  to it and plays, and shift-clicking clears it
+    std::array<juce::TextButton, HotCueBank::numHotCues> hotCueButtons;
+
     //3 sliders for the gain, speed and position
     juce::Slider gain;
     juce::Slider speed;
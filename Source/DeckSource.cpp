@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    DeckSource.cpp
+    Created: 17 Oct 2026 2:50:05pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "DeckSource.h"
+
+DeckSource::DeckSource(std::unique_ptr<juce::PositionableAudioSource> _input, const LoopRegion& _loopRegion, HotCueBank& _hotCues)
+    : input(std::move(_input)),
+      loopRegion(_loopRegion),
+      hotCues(_hotCues)
+{
+    position = input->getNextReadPosition();
+    readStart = position;
+}
+
+DeckSource::~DeckSource()
+{
+
+}
+
+//==============================================================================
+//The buffer for the seam is allocated here, never on the audio thread
+void DeckSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    seamTail.setSize(2, seamFadeLength);
+    seamFadePosition = seamFadeLength;
+}
+
+//Reading from the input in pieces that stop at the loop out point, jumping back to the
+//loop in point whenever the playhead reaches it
+void DeckSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    //The snippet of the previous track may still be playing when this source is swapped in.
+    //It is stopped here on the audio thread, which is the only thread that reads it
+    if (!started)
+    {
+        hotCues.endSnippet();
+        started = true;
+    }
+
+    const int jump{ hotCues.takePendingJump() };
+    if (jump >= 0)
+    {
+        jumpToCue(jump);
+    }
+
+    //Without a loop region the input is read as it is, looping over the whole track if asked to
+    if (!loopRegion.active || loopRegion.getLength() <= 0)
+    {
+        const bool fromSnippet{ hotCues.isPlayingSnippet() };
+
+        readInput(bufferToFill);
+        applySeamFade(bufferToFill);
+
+        //While the snippet plays the input is already further on, so the playhead is counted here
+        readStart = position;
+        position = (fromSnippet && hotCues.isPlayingSnippet()) ? position + bufferToFill.numSamples : input->getNextReadPosition();
+        return;
+    }
+
+    int done{ 0 };
+
+    while (done < bufferToFill.numSamples)
+    {
+        //The playhead only wraps when it played up to or past the out point, so seeking past the loop
+        //  plays on normally. An out point set a little behind the playhead still wraps
+        if (position >= loopRegion.end && readStart < loopRegion.end)
+        {
+            hotCues.endSnippet();
+            startSeamFade(bufferToFill.buffer->getNumChannels());
+            position = loopRegion.start;
+            input->setNextReadPosition(position);
+        }
+
+        int count{ bufferToFill.numSamples - done };
+        if (position < loopRegion.end)
+        {
+            count = (int)juce::jmin((juce::int64)count, loopRegion.end - position);
+        }
+
+        const juce::AudioSourceChannelInfo part{ bufferToFill.buffer, bufferToFill.startSample + done, count };
+        readStart = position;
+        readInput(part);
+        applySeamFade(part);
+
+        position += count;
+        done += count;
+    }
+}
+
+void DeckSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+//==============================================================================
+//A seek cancels any fade or snippet that is still running
+void DeckSource::setNextReadPosition(juce::int64 newPosition)
+{
+    //A seek also wins over a cue jump that has not been made yet
+    hotCues.takePendingJump();
+    hotCues.endSnippet();
+    position = newPosition;
+    readStart = newPosition;
+    input->setNextReadPosition(newPosition);
+    seamFadePosition = seamFadeLength;
+}
+
+juce::int64 DeckSource::getNextReadPosition() const
+{
+    return position;
+}
+
+juce::int64 DeckSource::getTotalLength() const
+{
+    return input->getTotalLength();
+}
+
+//The AudioTransportSource does not stop at the end of the track while this returns true
+bool DeckSource::isLooping() const
+{
+    return looping || loopRegion.active;
+}
+
+void DeckSource::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+    input->setLooping(shouldLoop);
+}
+
+//==============================================================================
+//When the cue has a snippet the input is sent to the end of it straight away, so a streaming
+//  input has the whole snippet's duration to find its place in the file
+void DeckSource::jumpToCue(int slot)
+{
+    const juce::int64 cuePosition{ hotCues.getPosition(slot) };
+    if (cuePosition < 0)
+    {
+        return;
+    }
+
+    seamFadePosition = seamFadeLength;
+    position = cuePosition;
+    readStart = cuePosition;
+
+    const int snippetLength{ hotCues.beginSnippet(slot) };
+    input->setNextReadPosition(cuePosition + snippetLength);
+}
+
+void DeckSource::readInput(const juce::AudioSourceChannelInfo& info)
+{
+    int done{ 0 };
+
+    if (hotCues.isPlayingSnippet())
+    {
+        done = hotCues.readSnippet(*info.buffer, info.startSample, info.numSamples);
+    }
+
+    if (done < info.numSamples)
+    {
+        input->getNextAudioBlock(juce::AudioSourceChannelInfo(info.buffer, info.startSample + done, info.numSamples - done));
+    }
+}
+
+//==============================================================================
+//The samples after the playhead, which is at the loop out point here, are the natural continuation
+//of what was just played. They are kept and faded out while the loop in point fades in.
+//A cue snippet that was still playing left the input further on, at the end of the snippet,
+//  so the input is sent back to the playhead first
+void DeckSource::startSeamFade(int numChannels)
+{
+    const int fadeChannels{ juce::jmin(numChannels, seamTail.getNumChannels()) };
+
+    if (fadeChannels == 0)
+    {
+        return;
+    }
+
+    if (input->getNextReadPosition() != position)
+    {
+        input->setNextReadPosition(position);
+    }
+
+    const int length{ (int)juce::jmin((juce::int64)seamFadeLength, juce::jmax((juce::int64)0, getTotalLength() - position)) };
+
+    seamTail.clear();
+    if (length > 0)
+    {
+        input->getNextAudioBlock(juce::AudioSourceChannelInfo(&seamTail, 0, length));
+    }
+
+    seamFadePosition = 0;
+}
+
+//Linear fades over the seam: the loop in point goes from 0 to 1 and the tail from 1 to 0
+void DeckSource::applySeamFade(const juce::AudioSourceChannelInfo& info)
+{
+    if (seamFadePosition >= seamFadeLength)
+    {
+        return;
+    }
+
+    const int count{ juce::jmin(info.numSamples, seamFadeLength - seamFadePosition) };
+    const float startGain{ (float)seamFadePosition / seamFadeLength };
+    const float endGain{ (float)(seamFadePosition + count) / seamFadeLength };
+    const int fadeChannels{ juce::jmin(info.buffer->getNumChannels(), seamTail.getNumChannels()) };
+
+    for (int ch = 0; ch < fadeChannels; ++ch)
+    {
+        info.buffer->applyGainRamp(ch, info.startSample, count, startGain, endGain);
+        info.buffer->addFromWithRamp(ch, info.startSample, seamTail.getReadPointer(ch, seamFadePosition), count, 1.0f - startGain, 1.0f - endGain);
+    }
+
+    seamFadePosition += count;
+}
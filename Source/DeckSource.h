@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    DeckSource.h
+    Created: 17 Oct 2026 2:50:05pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include "HotCueBank.h"
+
+//==============================================================================
+//A loop region in samples of the track. It is owned by the AudioPlayer and only
+//  changed and read on the audio thread, so it keeps its value when a new track is loaded
+struct LoopRegion
+{
+    //True when the playhead should go back to start when it reaches end
+    bool active{ false };
+    juce::int64 start{ 0 };
+    juce::int64 end{ 0 };
+
+    //The length of the region in samples
+    juce::int64 getLength() const { return end - start; }
+};
+
+//==============================================================================
+//The PositionableAudioSource that sits between a track's source and the AudioTransportSource of a deck.
+//When the loop region is active, the playhead wraps from the loop out point back to the loop in point
+//  inside the audio callback, at the exact sample, with a short crossfade over the seam so that the loop does not click.
+//Jumps to a cue point are made at the start of a block, and the first samples after the cue are served from the
+//  cue's pre-decoded snippet while the input is moved on to the end of the snippet
+class DeckSource : public juce::PositionableAudioSource
+{
+public:
+    //Takes ownership of the track's source and reads the loop region and the cue points owned by the player
+    DeckSource(std::unique_ptr<juce::PositionableAudioSource> _input, const LoopRegion& _loopRegion, HotCueBank& _hotCues);
+    ~DeckSource() override;
+
+    //The 3 functions that need to be implemented since we inherit from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //The functions that need to be implemented since we inherit from PositionableAudioSource
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+    //The number of samples crossfaded over the loop seam
+    static constexpr int seamFadeLength{ 256 };
+
+private:
+    //Moving the playhead to a cue point, starting its snippet if there is one
+    void jumpToCue(int slot);
+    //Reading from the cue's snippet while it lasts and from the input after that
+    void readInput(const juce::AudioSourceChannelInfo& info);
+
+    //Reading the audio that follows the loop out point, to fade it out over the start of the loop
+    void startSeamFade(int numChannels);
+    //Fading the loop in over the part of the block just written, and the saved tail out
+    void applySeamFade(const juce::AudioSourceChannelInfo& info);
+
+    std::unique_ptr<juce::PositionableAudioSource> input;
+    const LoopRegion& loopRegion;
+    HotCueBank& hotCues;
+
+    //The position of the next sample to be read, and the position the last read started from,
+    //  so that a seek is told apart from playing through the loop out point
+    juce::int64 position{ 0 };
+    juce::int64 readStart{ 0 };
+
+    //True if the whole track loops when there is no loop region
+    bool looping{ false };
+
+    //False until the first block, when the snippet of the previous source is stopped
+    bool started{ false };
+
+    //The audio after the loop out point, faded out over the start of the loop
+    juce::AudioBuffer<float> seamTail;
+    int seamFadePosition{ seamFadeLength };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckSource)
+};
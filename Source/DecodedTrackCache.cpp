@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.cpp
+    Created: 17 Oct 2026 1:05:44pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "DecodedTrackCache.h"
+
+//==============================================================================
+size_t DecodedTrack::getSizeInBytes() const
+{
+    return (size_t)buffer.getNumChannels() * (size_t)buffer.getNumSamples() * sizeof(float);
+}
+
+//==============================================================================
+DecodedTrackCache::DecodedTrackCache()
+{
+
+}
+
+DecodedTrackCache::~DecodedTrackCache()
+{
+
+}
+
+//Looking up a track and moving it to the front of the list if it is found
+std::shared_ptr<const DecodedTrack> DecodedTrackCache::find(const juce::String& key)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto it = index.find(key.toStdString());
+
+    if (it == index.end())
+    {
+        ++misses;
+        return nullptr;
+    }
+
+    ++hits;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->track;
+}
+
+//A track that is used is still moved to the front, only the counters are left alone
+std::shared_ptr<const DecodedTrack> DecodedTrackCache::peek(const juce::String& key)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto it = index.find(key.toStdString());
+
+    if (it == index.end())
+    {
+        return nullptr;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->track;
+}
+
+bool DecodedTrackCache::contains(const juce::String& key)
+{
+    const juce::ScopedLock sl(lock);
+    return index.find(key.toStdString()) != index.end();
+}
+
+//Adding a track to the front of the list, making room for it first
+bool DecodedTrackCache::insert(const juce::String& key, std::shared_ptr<const DecodedTrack> track)
+{
+    if (track == nullptr)
+    {
+        return false;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    const std::string stdKey{ key.toStdString() };
+
+    //If the track is already there it is only moved to the front
+    auto it = index.find(stdKey);
+    if (it != index.end())
+    {
+        entries.splice(entries.begin(), entries, it->second);
+        return true;
+    }
+
+    const size_t size{ track->getSizeInBytes() };
+
+    if (size > memoryBudget)
+    {
+        DBG("DecodedTrackCache::insert track is bigger than the whole memory budget");
+        return false;
+    }
+
+    evictUntilBelow(memoryBudget - size);
+
+    if (memoryUsed + size > memoryBudget)
+    {
+        DBG("DecodedTrackCache::insert no room left, every cached track is in use");
+        return false;
+    }
+
+    entries.push_front({ stdKey, std::move(track), size });
+    index[stdKey] = entries.begin();
+    memoryUsed += size;
+
+    return true;
+}
+
+void DecodedTrackCache::setMemoryBudget(size_t bytes)
+{
+    const juce::ScopedLock sl(lock);
+
+    memoryBudget = bytes;
+    evictUntilBelow(memoryBudget);
+}
+
+size_t DecodedTrackCache::getMemoryBudget() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryBudget;
+}
+
+size_t DecodedTrackCache::getMemoryUsed() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryUsed;
+}
+
+juce::int64 DecodedTrackCache::getNumHits() const
+{
+    return hits;
+}
+
+juce::int64 DecodedTrackCache::getNumMisses() const
+{
+    return misses;
+}
+
+//The key is made of the full path, the size and the modification time of the file
+juce::String DecodedTrackCache::makeKey(const juce::File& file)
+{
+    return file.getFullPathName()
+        + "|" + juce::String(file.getSize())
+        + "|" + juce::String(file.getLastModificationTime().toMilliseconds());
+}
+
+//Walking the list from the least recently used end. A track whose shared_ptr is
+//only held by the cache is not in use by any player and can be evicted
+void DecodedTrackCache::evictUntilBelow(size_t limit)
+{
+    auto it = entries.end();
+
+    while (memoryUsed > limit && it != entries.begin())
+    {
+        --it;
+
+        if (it->track.use_count() == 1)
+        {
+            memoryUsed -= it->sizeInBytes;
+            index.erase(it->key);
+            it = entries.erase(it);
+        }
+    }
+}
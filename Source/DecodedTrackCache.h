@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.h
+    Created: 17 Oct 2026 1:05:44pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+//==============================================================================
+//A track that has been fully decoded into float PCM
+struct DecodedTrack
+{
+    //The decoded samples, one channel per channel of the file
+    juce::AudioBuffer<float> buffer;
+
+    //The sample rate of the file the samples were decoded from
+    double sampleRate{ 0.0 };
+
+    //The number of bytes the samples take up in memory
+    size_t getSizeInBytes() const;
+};
+
+//==============================================================================
+//A DecodedTrack that is still being decoded, and the number of samples at its start decoded so far.
+//The buffer has the length of the whole track from the start and is never resized, and the samples before
+//  decodedLength never change again, so they can be read on any thread, the audio thread as well, while the
+//  rest is written. decodedLength is stored with release and loaded with acquire
+struct PartialTrack
+{
+    std::shared_ptr<DecodedTrack> track;
+    std::atomic<juce::int64> decodedLength{ 0 };
+};
+
+//==============================================================================
+//A process-wide cache of fully decoded tracks, shared between all the AudioPlayers
+//  using a juce::SharedResourcePointer.
+//Tracks are kept until the memory budget is reached and then the least recently used ones are evicted.
+//A track that is held by a player (its shared_ptr is used outside the cache) is never evicted
+class DecodedTrackCache
+{
+public:
+    DecodedTrackCache();
+    ~DecodedTrackCache();
+
+    //Returns the decoded track for a key or nullptr, counting a hit or a miss.
+    //A hit moves the track to the front of the LRU list
+    std::shared_ptr<const DecodedTrack> find(const juce::String& key);
+
+    //Returns the decoded track for a key or nullptr like find(), without counting a hit or a miss.
+    //Used to check for a track that is not being loaded onto a deck, eg. to copy a snippet from it,
+    //  analyse it or build its waveform
+    std::shared_ptr<const DecodedTrack> peek(const juce::String& key);
+
+    //Returns true if a track is in the cache, without counting a hit or a miss
+    bool contains(const juce::String& key);
+
+    //Adds a decoded track, evicting the least recently used tracks that are not in use to make room.
+    //Returns false if there was not enough room for it
+    bool insert(const juce::String& key, std::shared_ptr<const DecodedTrack> track);
+
+    //Setting and getting the memory budget in bytes. Lowering the budget evicts tracks straight away
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+
+    //The number of bytes used by all the tracks in the cache
+    size_t getMemoryUsed() const;
+
+    //The hit and miss counters of find(), one for every track loaded onto a deck that could be cached
+    juce::int64 getNumHits() const;
+    juce::int64 getNumMisses() const;
+
+    //Builds the key for a file. The size and modification time are part of the key,
+    //  so a file that changes on disk is never served from an old decode
+    static juce::String makeKey(const juce::File& file);
+
+private:
+    //Evicting the least recently used tracks not in use until the used memory is below the limit
+    void evictUntilBelow(size_t limit);
+
+    struct Entry
+    {
+        std::string key;
+        std::shared_ptr<const DecodedTrack> track;
+        size_t sizeInBytes;
+    };
+
+    //The entries in order of use, the most recently used one first
+    std::list<Entry> entries;
+    //An index from a key to its entry in the list
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+
+    size_t memoryBudget{ (size_t)512 * 1024 * 1024 };
+    size_t memoryUsed{ 0 };
+
+    std::atomic<juce::int64> hits{ 0 };
+    std::atomic<juce::int64> misses{ 0 };
+
+    //Guards the list and index. The cache is only used from the message thread and the
+    //  loader threads, never from the audio thread
+    juce::CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrackCache)
+};
@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    DiskIOThread.cpp
+    Created: 17 Oct 2026 2:22:09pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "DiskIOThread.h"
+
+//The thread is started straight away with a priority above normal,
+//so that it keeps up with the playheads while the GUI is busy
+DiskIOThread::DiskIOThread()
+    : juce::TimeSliceThread("Deck disk I/O")
+{
+    startThread(6);
+}
+
+DiskIOThread::~DiskIOThread()
+{
+    stopThread(2000);
+}
@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    DiskIOThread.h
+    Created: 17 Oct 2026 2:22:09pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+//A background thread that does the disk work for the decks, away from the audio thread.
+//Sources that need to read or touch a file ahead of the playhead register themselves
+//  as juce::TimeSliceClients. It is shared by all the decks using a juce::SharedResourcePointer
+class DiskIOThread : public juce::TimeSliceThread
+{
+public:
+    DiskIOThread();
+    ~DiskIOThread() override;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskIOThread)
+};
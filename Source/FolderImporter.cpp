@@ -0,0 +1,314 @@
+/*
+  ==============================================================================
+
+    FolderImporter.cpp
+    Created: 17 Oct 2026 3:12:17pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "FolderImporter.h"
+#include "AudioFingerprint.h"
+
+//==============================================================================
+//The job that walks the folders and hands the audio files it finds to probe jobs in batches
+class FolderImporter::WalkJob : public juce::ThreadPoolJob
+{
+public:
+    WalkJob(FolderImporter& _owner, juce::File _folder, juce::String _wildcard, int _generation)
+        : juce::ThreadPoolJob("Folder import walk"),
+          owner(_owner),
+          folder(_folder),
+          wildcard(_wildcard),
+          generation(_generation),
+          safeOwner(&_owner)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        std::vector<juce::File> batch;
+        batch.reserve(FolderImporter::batchSize);
+
+        for (const juce::DirectoryEntry& entry : juce::RangedDirectoryIterator(folder, true, wildcard, juce::File::findFiles))
+        {
+            if (shouldExit())
+            {
+                return jobHasFinished;
+            }
+
+            batch.push_back(entry.getFile());
+
+            if ((int)batch.size() == FolderImporter::batchSize)
+            {
+                owner.addProbeJob(std::move(batch), generation);
+                batch.clear();
+                batch.reserve(FolderImporter::batchSize);
+            }
+        }
+
+        if (!batch.empty())
+        {
+            owner.addProbeJob(std::move(batch), generation);
+        }
+
+        juce::WeakReference<FolderImporter> importer{ safeOwner };
+        const int walkGeneration{ generation };
+        juce::MessageManager::callAsync([importer, walkGeneration]
+        {
+            if (importer != nullptr && importer->generation == walkGeneration)
+            {
+                importer->walkDone();
+            }
+        });
+
+        return jobHasFinished;
+    }
+
+private:
+    FolderImporter& owner;
+    juce::File folder;
+    juce::String wildcard;
+    int generation;
+    juce::WeakReference<FolderImporter> safeOwner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WalkJob)
+};
+
+//==============================================================================
+//The job that reads the headers of a batch of files. Each job has its own format manager,
+//  so the jobs never share a reader or a format between threads
+class FolderImporter::ProbeJob : public juce::ThreadPoolJob
+{
+public:
+    ProbeJob(FolderImporter& _owner, std::vector<juce::File> _files, int _generation)
+        : juce::ThreadPoolJob("Folder import probe"),
+          owner(_owner),
+          files(std::move(_files)),
+          generation(_generation),
+          safeOwner(&_owner)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        auto batch = std::make_shared<std::vector<ProbedFile>>();
+        batch->reserve(files.size());
+
+        for (const juce::File& file : files)
+        {
+            if (shouldExit())
+            {
+                return jobHasFinished;
+            }
+
+            batch->push_back(probe(formatManager, file));
+            ++owner.filesProbed;
+        }
+
+        juce::WeakReference<FolderImporter> importer{ safeOwner };
+        const int batchGeneration{ generation };
+        juce::MessageManager::callAsync([importer, batchGeneration, batch]
+        {
+            if (importer != nullptr && importer->generation == batchGeneration)
+            {
+                importer->batchProbed(*batch);
+            }
+        });
+
+        return jobHasFinished;
+    }
+
+private:
+    //Only the header and the few blocks of audio the fingerprint needs are read
+    static ProbedFile probe(juce::AudioFormatManager& formatManager, const juce::File& file)
+    {
+        ProbedFile probed;
+        probed.file = file;
+        probed.record.fileSize = file.getSize();
+        probed.record.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+        std::unique_ptr<juce::AudioFormatReader> reader{ formatManager.createReaderFor(file) };
+
+        if (reader != nullptr && reader->sampleRate > 0)
+        {
+            probed.record.sampleRate = reader->sampleRate;
+            probed.record.numChannels = reader->numChannels;
+            probed.record.lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
+            probed.record.fingerprint = AudioFingerprint::compute(*reader, probed.record.fileSize);
+            probed.readOk = true;
+        }
+
+        return probed;
+    }
+
+    FolderImporter& owner;
+    std::vector<juce::File> files;
+    int generation;
+    juce::WeakReference<FolderImporter> safeOwner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProbeJob)
+};
+
+//==============================================================================
+FolderImporter::FolderImporter()
+{
+
+}
+
+FolderImporter::~FolderImporter()
+{
+    pool.removeAllJobs(true, 5000);
+}
+
+//The file types are taken from a format manager here, so the walk only returns files that can be probed
+bool FolderImporter::importFolder(const juce::File& folder, TracksCallback onTracksAdded, ProgressCallback onProgress)
+{
+    if (importing)
+    {
+        DBG("FolderImporter::importFolder an import is already running");
+        return false;
+    }
+
+    if (!folder.isDirectory())
+    {
+        DBG("FolderImporter::importFolder " << folder.getFullPathName() << " is not a folder");
+        return false;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    tracksCallback = std::move(onTracksAdded);
+    progressCallback = std::move(onProgress);
+
+    ++generation;
+    importing = true;
+    filesFound = 0;
+    filesProbed = 0;
+    progress = ImportProgress{};
+    startTime = juce::Time::getMillisecondCounterHiRes();
+
+    pool.addJob(new WalkJob(*this, folder, formatManager.getWildcardForAllFormats(), generation), true);
+    return true;
+}
+
+//The batches that are still on their way to the message thread are dropped, since the generation changes
+void FolderImporter::cancel()
+{
+    if (!importing)
+    {
+        return;
+    }
+
+    ++generation;
+    pool.removeAllJobs(true, 5000);
+
+    importing = false;
+    progress.finished = true;
+    progress.cancelled = true;
+
+    if (progressCallback != nullptr)
+    {
+        progressCallback(getProgress());
+    }
+}
+
+bool FolderImporter::isImporting() const
+{
+    return importing;
+}
+
+ImportProgress FolderImporter::getProgress() const
+{
+    ImportProgress current{ progress };
+    current.filesFound = filesFound;
+    current.elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    if (current.elapsedSeconds > 0.0)
+    {
+        current.filesPerSecond = filesProbed / current.elapsedSeconds;
+    }
+    return current;
+}
+
+//==============================================================================
+//Called on the walk thread. The count is increased before the job is added, so the import
+//  cannot look finished while a batch is still waiting to be probed
+void FolderImporter::addProbeJob(std::vector<juce::File> files, int jobGeneration)
+{
+    filesFound += (int)files.size();
+    pool.addJob(new ProbeJob(*this, std::move(files), jobGeneration), true);
+}
+
+//The whole batch goes into the library with a single flush of the journal.
+//Files that are already in the library keep their record, cues and analysis.
+//A file whose fingerprint matches a track of the library, including one added earlier in the same
+//  import, is the same audio under another path, so it is flagged and left out
+void FolderImporter::batchProbed(const std::vector<ProbedFile>& batch)
+{
+    std::vector<ImportedTrack> added;
+    added.reserve(batch.size());
+
+    library->beginBatch();
+
+    for (const ProbedFile& probed : batch)
+    {
+        if (!probed.readOk)
+        {
+            ++progress.filesFailed;
+            continue;
+        }
+
+        if (library->findTrack(probed.file) != 0)
+        {
+            ++progress.tracksSkipped;
+            continue;
+        }
+
+        const juce::uint32 original{ library->findDuplicate(probed.record.fingerprint) };
+        if (original != 0)
+        {
+            progress.duplicates.push_back({ probed.file, library->getFile(original) });
+            continue;
+        }
+
+        added.push_back({ probed.file, library->addTrack(probed.file, probed.record) });
+    }
+
+    library->endBatch();
+
+    progress.filesDone += (int)batch.size();
+    progress.tracksAdded += (int)added.size();
+
+    if (!added.empty() && tracksCallback != nullptr)
+    {
+        tracksCallback(added);
+    }
+
+    reportProgress();
+}
+
+void FolderImporter::walkDone()
+{
+    progress.walkFinished = true;
+    reportProgress();
+}
+
+void FolderImporter::reportProgress()
+{
+    if (progress.walkFinished && progress.filesDone == filesFound)
+    {
+        importing = false;
+        progress.finished = true;
+    }
+
+    if (progressCallback != nullptr)
+    {
+        progressCallback(getProgress());
+    }
+}
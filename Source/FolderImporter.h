@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    FolderImporter.h
+    Created: 17 Oct 2026 3:12:17pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "LibraryDatabase.h"
+
+//==============================================================================
+//How far an import has got, as shown to the user
+struct ImportProgress
+{
+    //The audio files found so far, and how many of them have been probed and handed to the library
+    int filesFound{ 0 };
+    int filesDone{ 0 };
+    //The files that were added to the library, already in it, or could not be read
+    int tracksAdded{ 0 };
+    int tracksSkipped{ 0 };
+    int filesFailed{ 0 };
+    //The files left out because the same audio is already in the library under another path
+    std::vector<DuplicateTrack> duplicates;
+
+    //True once every folder has been walked, and once every file found has been handled
+    bool walkFinished{ false };
+    bool finished{ false };
+    //True if the import was stopped before the end
+    bool cancelled{ false };
+
+    double elapsedSeconds{ 0.0 };
+    //The number of files probed per second since the import started
+    double filesPerSecond{ 0.0 };
+};
+
+//==============================================================================
+//Imports every audio file in a folder and its sub folders into the LibraryDatabase.
+//One job walks the folders and hands the files it finds, in batches, to probe jobs that read their
+//  headers. There are as many worker threads as CPU cores, so a big drive is probed in parallel.
+//The probed batches are added to the library on the message thread, one journal flush per batch,
+//  so the UI keeps running during the import.
+//It is only used from the message thread, and every callback is called on the message thread
+class FolderImporter
+{
+public:
+    //A track that was added to the library
+    struct ImportedTrack
+    {
+        juce::File file;
+        juce::uint32 libraryId{ 0 };
+    };
+
+    //Called with the tracks of every batch that was added to the library
+    using TracksCallback = std::function<void(const std::vector<ImportedTrack>&)>;
+    //Called after every batch and once more when the import has finished
+    using ProgressCallback = std::function<void(const ImportProgress&)>;
+
+    //The number of files probed by a single job and added to the library together
+    static constexpr int batchSize{ 256 };
+
+    FolderImporter();
+    ~FolderImporter();
+
+    //Starts importing a folder and returns straight away. Returns false if an import is already running
+    bool importFolder(const juce::File& folder, TracksCallback onTracksAdded, ProgressCallback onProgress);
+    //Stops the import. The tracks already added stay in the library
+    void cancel();
+
+    bool isImporting() const;
+    ImportProgress getProgress() const;
+
+private:
+    class WalkJob;
+    class ProbeJob;
+
+    //A file read by a probe job, with its record ready for the library
+    struct ProbedFile
+    {
+        juce::File file;
+        LibraryRecord record;
+        bool readOk{ false };
+    };
+
+    //Called by the walk job for every batch of files it finds
+    void addProbeJob(std::vector<juce::File> files, int jobGeneration);
+    //Called on the message thread when a batch has been probed and when the walk has finished
+    void batchProbed(const std::vector<ProbedFile>& batch);
+    void walkDone();
+    //Sending the progress and checking whether the import has finished
+    void reportProgress();
+
+    //The walk job and the probe jobs
+    juce::ThreadPool pool{ juce::jmax(1, juce::SystemStats::getNumCpus()) };
+
+    juce::SharedResourcePointer<LibraryDatabase> library;
+
+    TracksCallback tracksCallback;
+    ProgressCallback progressCallback;
+
+    //Increased by every import, so that the batches of a cancelled import are dropped
+    int generation{ 0 };
+    bool importing{ false };
+
+    //Counted by the walk job and the probe jobs
+    std::atomic<int> filesFound{ 0 };
+    std::atomic<int> filesProbed{ 0 };
+    //Only used on the message thread
+    ImportProgress progress;
+    double startTime{ 0.0 };
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(FolderImporter)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FolderImporter)
+};
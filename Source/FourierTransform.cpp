@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    FourierTransform.cpp
+    Created: 17 Oct 2026 3:25:17pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "FourierTransform.h"
+#include <cmath>
+
+FourierTransform::FourierTransform(int order)
+    : size(1 << juce::jmax(2, order)),
+      halfSize(size / 2)
+{
+    const double pi{ 3.14159265358979323846 };
+
+    twiddles.resize((size_t)halfSize / 2);
+    for (int i = 0; i < halfSize / 2; ++i)
+    {
+        const double angle{ -2.0 * pi * i / halfSize };
+        twiddles[(size_t)i] = { (float)std::cos(angle), (float)std::sin(angle) };
+    }
+
+    splitTwiddles.resize((size_t)halfSize);
+    for (int k = 0; k < halfSize; ++k)
+    {
+        const double angle{ -2.0 * pi * k / size };
+        splitTwiddles[(size_t)k] = { (float)std::cos(angle), (float)std::sin(angle) };
+    }
+
+    bitReversed.resize((size_t)halfSize);
+    int numBits{ 0 };
+    while ((1 << numBits) < halfSize)
+    {
+        ++numBits;
+    }
+    for (int i = 0; i < halfSize; ++i)
+    {
+        int reversed{ 0 };
+        for (int bit = 0; bit < numBits; ++bit)
+        {
+            reversed |= ((i >> bit) & 1) << (numBits - 1 - bit);
+        }
+        bitReversed[(size_t)i] = reversed;
+    }
+
+    scratch.resize((size_t)halfSize);
+}
+
+FourierTransform::~FourierTransform()
+{
+
+}
+
+int FourierTransform::getSize() const
+{
+    return size;
+}
+
+//==============================================================================
+//The even samples are the real parts and the odd samples the imaginary parts of the packed values.
+//If Z is their transform, the spectrum of the real signal is
+//  X[k] = (Z[k] + conj(Z[N/2 - k])) / 2 - i * W^k * (Z[k] - conj(Z[N/2 - k])) / 2, with W = e^(-2 pi i / N)
+void FourierTransform::performMagnitudes(const float* samples, float* magnitudes)
+{
+    for (int i = 0; i < halfSize; ++i)
+    {
+        scratch[(size_t)bitReversed[(size_t)i]] = { samples[2 * i], samples[2 * i + 1] };
+    }
+
+    performComplex();
+
+    magnitudes[0] = std::abs(scratch[0].real() + scratch[0].imag());
+    magnitudes[halfSize] = std::abs(scratch[0].real() - scratch[0].imag());
+
+    for (int k = 1; k < halfSize; ++k)
+    {
+        const std::complex<float> z{ scratch[(size_t)k] };
+        const std::complex<float> mirrored{ std::conj(scratch[(size_t)(halfSize - k)]) };
+        const std::complex<float> even{ 0.5f * (z + mirrored) };
+        const std::complex<float> odd{ 0.5f * (z - mirrored) };
+        const std::complex<float> twiddled{ multiply(splitTwiddles[(size_t)k], odd) };
+        //Multiplying by -i swaps the real and imaginary parts
+        const std::complex<float> x{ even + std::complex<float>{ twiddled.imag(), -twiddled.real() } };
+
+        magnitudes[k] = std::sqrt(x.real() * x.real() + x.imag() * x.imag());
+    }
+}
+
+//std::complex multiplication checks for infinities and NaNs, which the samples never hold
+std::complex<float> FourierTransform::multiply(std::complex<float> a, std::complex<float> b)
+{
+    return { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+}
+
+//The values are already in bit reversed order, so the butterflies run from the shortest span to the longest
+void FourierTransform::performComplex()
+{
+    std::complex<float>* data{ scratch.data() };
+
+    for (int span = 1; span < halfSize; span *= 2)
+    {
+        const int twiddleStep{ halfSize / (2 * span) };
+
+        for (int start = 0; start < halfSize; start += 2 * span)
+        {
+            for (int i = 0; i < span; ++i)
+            {
+                const std::complex<float> odd{ multiply(twiddles[(size_t)(i * twiddleStep)], data[start + i + span]) };
+                const std::complex<float> even{ data[start + i] };
+
+                data[start + i] = even + odd;
+                data[start + i + span] = even - odd;
+            }
+        }
+    }
+}
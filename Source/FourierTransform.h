@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    FourierTransform.h
+    Created: 17 Oct 2026 3:25:17pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+#include <vector>
+
+//==============================================================================
+//A radix-2 fast Fourier transform of real signals, used by the offline analysers.
+//A real signal of N samples is packed into N / 2 complex values, transformed with an in-place
+//  iterative FFT and then split back into the spectrum of the real signal, which is about twice
+//  as fast as transforming it as N complex values.
+//The twiddle factors and the bit reversed order are worked out once in the constructor.
+//The tables are only read while transforming, but the scratch buffer is not, so an object
+//  should only be used by one thread at a time
+class FourierTransform
+{
+public:
+    //The size of the transform is 2 to the power of order, at least 4 samples
+    explicit FourierTransform(int order);
+    ~FourierTransform();
+
+    int getSize() const;
+
+    //Transforming getSize() real samples and writing the magnitudes of the getSize() / 2 + 1 bins,
+    //  from 0 Hz up to half the sample rate
+    void performMagnitudes(const float* samples, float* magnitudes);
+
+private:
+    //The in-place complex FFT of the getSize() / 2 packed values in scratch
+    void performComplex();
+    static std::complex<float> multiply(std::complex<float> a, std::complex<float> b);
+
+    int size;
+    int halfSize;
+
+    //The twiddle factors of the complex FFT and of the split into the real spectrum
+    std::vector<std::complex<float>> twiddles;
+    std::vector<std::complex<float>> splitTwiddles;
+    //The index every packed value is swapped with before the butterflies
+    std::vector<int> bitReversed;
+
+    std::vector<std::complex<float>> scratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FourierTransform)
+};
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    HotCueBank.cpp
+    Created: 17 Oct 2026 2:56:24pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "HotCueBank.h"
+
+//All the snippet buffers are allocated here, so nothing is allocated when a cue is set or played
+HotCueBank::HotCueBank()
+{
+    for (Slot& slot : slots)
+    {
+        for (Snippet& snippet : slot.snippets)
+        {
+            snippet.audio.setSize(2, maxSnippetLength);
+        }
+    }
+}
+
+HotCueBank::~HotCueBank()
+{
+
+}
+
+//==============================================================================
+void HotCueBank::setPosition(int slot, juce::int64 samplePosition)
+{
+    if (slot < 0 || slot >= numSlots)
+    {
+        DBG("HotCueBank::setPosition slot out of range");
+        return;
+    }
+
+    slots[slot].position = juce::jmax((juce::int64)0, samplePosition);
+}
+
+//The snippets go with the cue, so a cue set at the same sample of the next track, eg. the main cue at 0,
+//  never plays the audio of the old one: nothing is published until a new snippet is stored.
+//The buffers themselves are left alone, since the audio thread may be reading them. A snippet it is
+//  playing right now is left to finish
+void HotCueBank::clear(int slot)
+{
+    if (slot < 0 || slot >= numSlots)
+    {
+        return;
+    }
+
+    Slot& target{ slots[slot] };
+    target.position = -1;
+    target.active.store(-1, std::memory_order_release);
+}
+
+void HotCueBank::clearAll()
+{
+    for (int i = 0; i < numSlots; ++i)
+    {
+        clear(i);
+    }
+}
+
+juce::int64 HotCueBank::getPosition(int slot) const
+{
+    if (slot < 0 || slot >= numSlots)
+    {
+        return -1;
+    }
+
+    return slots[slot].position;
+}
+
+//The snippet is written into the buffer that was not published last, and then published.
+//If the audio thread is playing from that buffer right now the snippet is dropped, and the
+//  cue falls back to reading from the track. beginSnippet() marks a buffer as being read before it
+//  checks that it is still published, so it never starts reading the buffer written here
+void HotCueBank::storeSnippet(int slot, juce::int64 start, const juce::AudioBuffer<float>& audio)
+{
+    if (slot < 0 || slot >= numSlots || slots[slot].position != start)
+    {
+        return;
+    }
+
+    Slot& target{ slots[slot] };
+    const int buffer{ target.published == 0 ? 1 : 0 };
+
+    if (reading == slot * 2 + buffer)
+    {
+        return;
+    }
+
+    Snippet& snippet{ target.snippets[buffer] };
+    snippet.length = juce::jmin(audio.getNumSamples(), maxSnippetLength);
+    snippet.start = start;
+
+    for (int ch = 0; ch < snippet.audio.getNumChannels(); ++ch)
+    {
+        //A mono track is copied into both channels
+        snippet.audio.copyFrom(ch, 0, audio, juce::jmin(ch, audio.getNumChannels() - 1), 0, snippet.length);
+    }
+
+    target.published = buffer;
+    target.active.store(buffer, std::memory_order_release);
+}
+
+//==============================================================================
+void HotCueBank::requestJump(int slot)
+{
+    pendingJump = slot;
+}
+
+int HotCueBank::takePendingJump()
+{
+    const int slot{ pendingJump };
+    pendingJump = -1;
+    return slot;
+}
+
+//The buffer is marked as being read first and then checked to still be the published one, so the
+//  message thread either sees the mark and leaves it alone, or has already published the other buffer.
+//The snippet is only used if it was decoded at the position the cue has now
+int HotCueBank::beginSnippet(int slot)
+{
+    endSnippet();
+
+    if (slot < 0 || slot >= numSlots)
+    {
+        return 0;
+    }
+
+    const int buffer{ slots[slot].active.load(std::memory_order_acquire) };
+    if (buffer < 0)
+    {
+        return 0;
+    }
+
+    reading = slot * 2 + buffer;
+    if (slots[slot].active.load(std::memory_order_acquire) != buffer)
+    {
+        endSnippet();
+        return 0;
+    }
+
+    const Snippet& snippet{ slots[slot].snippets[buffer] };
+    if (snippet.start != slots[slot].position || snippet.length <= 0)
+    {
+        endSnippet();
+        return 0;
+    }
+
+    readPosition = 0;
+
+    return snippet.length;
+}
+
+int HotCueBank::readSnippet(juce::AudioBuffer<float>& destination, int startSample, int numSamples)
+{
+    const int current{ reading };
+    if (current < 0)
+    {
+        return 0;
+    }
+
+    const Snippet& snippet{ slots[current / 2].snippets[current % 2] };
+    const int count{ juce::jmin(numSamples, snippet.length - readPosition) };
+    const int numChannels{ juce::jmin(destination.getNumChannels(), snippet.audio.getNumChannels()) };
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        destination.copyFrom(ch, startSample, snippet.audio, ch, readPosition, count);
+    }
+
+    readPosition += count;
+    if (readPosition >= snippet.length)
+    {
+        endSnippet();
+    }
+
+    return count;
+}
+
+void HotCueBank::endSnippet()
+{
+    reading = -1;
+    readPosition = 0;
+}
+
+bool HotCueBank::isPlayingSnippet() const
+{
+    return reading >= 0;
+}
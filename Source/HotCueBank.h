@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    HotCueBank.h
+    Created: 17 Oct 2026 2:56:24pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+//The cue points of a deck: 8 hot cues and the main cue used by the CUE buttons.
+//Every cue point keeps a short pre-decoded snippet of the audio that follows it, so that the first
+//  blocks after a jump are served from memory while the track's own source catches up.
+//The positions and snippets are set on the message thread. Jumps are requested and snippets are
+//  read on the audio thread, without locks. Each cue has two snippet buffers so that a new snippet
+//  can be written while the old one is being played. A buffer is only written while it is not published
+//  and not being read, and is published with a release store of the slot's active buffer
+class HotCueBank
+{
+public:
+    //The number of hot cues and the index of the main cue, which comes after them
+    static constexpr int numHotCues{ 8 };
+    static constexpr int mainCue{ numHotCues };
+    static constexpr int numSlots{ numHotCues + 1 };
+
+    //The length of the snippet kept after each cue point
+    static constexpr double snippetSeconds{ 0.5 };
+    //The longest snippet, 0.5 seconds at 96kHz, allocated up front
+    static constexpr int maxSnippetLength{ 48000 };
+
+    HotCueBank();
+    ~HotCueBank();
+
+    //==============================================================================
+    //Message thread
+
+    //Setting a cue point, in samples of the track. The old snippet is not used any more
+    void setPosition(int slot, juce::int64 samplePosition);
+    //Removing a cue point and its snippets, or all of them when a new track is loaded
+    void clear(int slot);
+    void clearAll();
+    //Returns the position of a cue point in samples, or -1 if it is not set
+    juce::int64 getPosition(int slot) const;
+
+    //Storing the decoded audio that starts at a cue point. It is ignored if the cue point moved
+    //  since the snippet was asked for, or if both buffers are busy
+    void storeSnippet(int slot, juce::int64 start, const juce::AudioBuffer<float>& audio);
+
+    //==============================================================================
+    //Audio thread
+
+    //Asking the DeckSource to jump to a cue point at the start of its next block
+    void requestJump(int slot);
+    //Returns the slot of the jump asked for, or -1, and forgets it
+    int takePendingJump();
+
+    //Starts serving the snippet of a slot. Returns the length of the snippet, or 0 if there is
+    //  no snippet for the current position of the cue
+    int beginSnippet(int slot);
+    //Copies the next part of the snippet into a buffer and returns how many samples were copied
+    int readSnippet(juce::AudioBuffer<float>& destination, int startSample, int numSamples);
+    //Stops serving the snippet, eg. after a seek
+    void endSnippet();
+    bool isPlayingSnippet() const;
+
+private:
+    struct Snippet
+    {
+        juce::AudioBuffer<float> audio;
+        juce::int64 start{ -1 };
+        int length{ 0 };
+    };
+
+    struct Slot
+    {
+        std::atomic<juce::int64> position{ -1 };
+        std::array<Snippet, 2> snippets;
+        //The buffer holding the latest snippet, or -1
+        std::atomic<int> active{ -1 };
+        //The buffer that was published last, even if the cue was cleared since. The audio thread may
+        //  still be starting to read it, so it is never written next. Only used on the message thread
+        int published{ -1 };
+    };
+
+    std::array<Slot, numSlots> slots;
+
+    //The snippet being played, as slot * 2 + buffer, or -1
+    std::atomic<int> reading{ -1 };
+    //How far into the snippet the audio thread is
+    int readPosition{ 0 };
+    //The jump asked for by the player, only used on the audio thread
+    int pendingJump{ -1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HotCueBank)
+};
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    KeyAnalyser.cpp
+    Created: 17 Oct 2026 3:25:02pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "KeyAnalyser.h"
+#include <cmath>
+
+//The frames are analysed at about 11kHz whatever the sample rate of the track
+KeyAnalyser::KeyAnalyser(double sampleRate)
+{
+    decimation = juce::jmax(1, juce::roundToInt(sampleRate / 11025.0));
+    frameSampleRate = sampleRate / decimation;
+
+    frame.resize((size_t)frameSize);
+    windowed.resize((size_t)frameSize);
+    magnitudes.resize((size_t)frameSize / 2 + 1);
+
+    window.resize((size_t)frameSize);
+    for (int i = 0; i < frameSize; ++i)
+    {
+        window[(size_t)i] = (float)(0.5 - 0.5 * std::cos(2.0 * 3.14159265358979323846 * i / frameSize));
+    }
+
+    firstBin = juce::jmax(1, (int)(lowestFrequency * frameSize / frameSampleRate));
+    lastBin = juce::jmin(frameSize / 2 - 1, (int)(highestFrequency * frameSize / frameSampleRate) + 1);
+}
+
+KeyAnalyser::~KeyAnalyser()
+{
+
+}
+
+//==============================================================================
+//Averaging the samples in groups is a simple low pass filter, good enough since only the peaks
+//  of the spectrum are used
+void KeyAnalyser::process(const float* samples, int numSamples)
+{
+    const float scale{ 1.0f / (float)decimation };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        sum += samples[i];
+
+        if (++samplesInSum < decimation)
+        {
+            continue;
+        }
+
+        frame[(size_t)samplesInFrame++] = sum * scale;
+        samplesInSum = 0;
+        sum = 0.0f;
+
+        if (samplesInFrame == frameSize)
+        {
+            analyseFrame();
+
+            //The second half of the frame is the first half of the next one
+            std::copy(frame.begin() + hopSize, frame.end(), frame.begin());
+            samplesInFrame = frameSize - hopSize;
+        }
+    }
+}
+
+//A peak is a bin louder than both its neighbours. A parabola through the 3 bins places the peak
+//  between bins, which matters for the low notes where a semitone is only a few bins wide
+void KeyAnalyser::analyseFrame()
+{
+    juce::FloatVectorOperations::multiply(windowed.data(), frame.data(), window.data(), frameSize);
+    transform.performMagnitudes(windowed.data(), magnitudes.data());
+
+    const float* m{ magnitudes.data() };
+
+    float loudest{ 0.0f };
+    for (int bin = firstBin; bin <= lastBin; ++bin)
+    {
+        loudest = juce::jmax(loudest, m[bin]);
+    }
+
+    //Peaks 40dB below the loudest one are mostly noise
+    const float threshold{ loudest * 0.01f };
+
+    for (int bin = firstBin; bin <= lastBin; ++bin)
+    {
+        if (m[bin] <= threshold || m[bin] <= m[bin - 1] || m[bin] < m[bin + 1])
+        {
+            continue;
+        }
+
+        const float denominator{ m[bin - 1] - 2.0f * m[bin] + m[bin + 1] };
+        const float shift{ denominator < 0.0f ? 0.5f * (m[bin - 1] - m[bin + 1]) / denominator : 0.0f };
+        const double frequency{ (bin + shift) * frameSampleRate / frameSize };
+
+        //The MIDI note number, where 60 is middle C, so the pitch class of C is 0
+        const int note{ (int)std::lround(69.0 + 12.0 * std::log2(frequency / 440.0)) };
+
+        chroma[((note % 12) + 12) % 12] += m[bin];
+    }
+}
+
+//==============================================================================
+//The Pearson correlation is used, so only the shape of the chromagram matters and not how loud the track is
+bool KeyAnalyser::finish()
+{
+    static const double majorProfile[12]{ 6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+    static const double minorProfile[12]{ 6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+    key = -1;
+
+    double chromaMean{ 0.0 };
+    for (double value : chroma)
+    {
+        chromaMean += value / 12.0;
+    }
+
+    if (chromaMean <= 0.0)
+    {
+        return false;
+    }
+
+    double bestCorrelation{ -2.0 };
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        const double* profile{ mode == 0 ? majorProfile : minorProfile };
+
+        double profileMean{ 0.0 };
+        for (int i = 0; i < 12; ++i)
+        {
+            profileMean += profile[i] / 12.0;
+        }
+
+        for (int tonic = 0; tonic < 12; ++tonic)
+        {
+            double product{ 0.0 };
+            double chromaSquares{ 0.0 };
+            double profileSquares{ 0.0 };
+
+            for (int i = 0; i < 12; ++i)
+            {
+                const double c{ chroma[(tonic + i) % 12] - chromaMean };
+                const double p{ profile[i] - profileMean };
+
+                product += c * p;
+                chromaSquares += c * c;
+                profileSquares += p * p;
+            }
+
+            const double correlation{ product / std::sqrt(chromaSquares * profileSquares + 1.0e-30) };
+
+            if (correlation > bestCorrelation)
+            {
+                bestCorrelation = correlation;
+                key = tonic + 12 * mode;
+            }
+        }
+    }
+
+    return true;
+}
+
+int KeyAnalyser::getKey() const
+{
+    return key;
+}
+
+//==============================================================================
+juce::String KeyAnalyser::getKeyName(int key)
+{
+    static const char* const noteNames[12]{ "C", "C#", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+
+    if (key < 0 || key > 23)
+    {
+        return {};
+    }
+    return juce::String(noteNames[key % 12]) + (key >= 12 ? "m" : "");
+}
+
+juce::String KeyAnalyser::getCamelotCode(int key)
+{
+    const int index{ getCamelotIndex(key) };
+
+    if (index < 0)
+    {
+        return {};
+    }
+    return juce::String(index / 2 + 1) + (index % 2 == 0 ? "A" : "B");
+}
+
+//Going up a fifth moves one step around the wheel, C major is 8B and its relative minor, A minor, is 8A
+int KeyAnalyser::getCamelotIndex(int key)
+{
+    if (key < 0 || key > 23)
+    {
+        return -1;
+    }
+
+    const bool minor{ key >= 12 };
+    //A minor key sits with the major key 3 semitones above it
+    const int major{ minor ? (key + 3) % 12 : key };
+    const int number{ (7 * major + 7) % 12 };
+
+    return 2 * number + (minor ? 0 : 1);
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    KeyAnalyser.h
+    Created: 17 Oct 2026 3:25:02pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "FourierTransform.h"
+
+//==============================================================================
+//Finds the musical key of a track from its mono audio, fed in blocks of any size.
+//The audio is brought down to about 11kHz by averaging groups of samples, which keeps every note that
+//  matters for the key, and cut into Hann windowed frames of 8192 samples that overlap by half.
+//The peaks of the spectrum of every frame between C2 and C7 are added to a chromagram, the energy of
+//  each of the 12 pitch classes over the whole track.
+//When the track is finished the chromagram is compared with the Krumhansl-Kessler profiles of the
+//  24 major and minor keys, and the best match is the key.
+//Keys are numbered 0 to 11 for C major to B major and 12 to 23 for C minor to B minor
+class KeyAnalyser
+{
+public:
+    explicit KeyAnalyser(double sampleRate);
+    ~KeyAnalyser();
+
+    //Adding the next block of mono audio
+    void process(const float* samples, int numSamples);
+
+    //Working out the key from everything that was fed. Returns false if there were no notes in the track
+    bool finish();
+
+    //The result of finish(), or -1
+    int getKey() const;
+
+    //The name of a key, like "F#m", and its code on the Camelot wheel DJs use for harmonic mixing,
+    //  like "11A". Keys next to each other on the wheel mix well
+    static juce::String getKeyName(int key);
+    static juce::String getCamelotCode(int key);
+    //The position of a key on the Camelot wheel from 0 to 23, 1A first, used for sorting
+    static int getCamelotIndex(int key);
+
+private:
+    //Adding the peaks of the frame in the frame buffer to the chromagram
+    void analyseFrame();
+
+    //The size of the frames as a power of 2, and how far apart they start
+    static constexpr int frameOrder{ 13 };
+    static constexpr int frameSize{ 1 << frameOrder };
+    static constexpr int hopSize{ frameSize / 2 };
+
+    //The lowest and the highest frequency added to the chromagram, C2 and C7
+    static constexpr double lowestFrequency{ 65.4 };
+    static constexpr double highestFrequency{ 2093.0 };
+
+    //How many samples are averaged into one, and the samples averaged so far
+    int decimation{ 1 };
+    int samplesInSum{ 0 };
+    float sum{ 0.0f };
+    double frameSampleRate{ 0.0 };
+
+    //The decimated samples of the frame being filled
+    std::vector<float> frame;
+    int samplesInFrame{ 0 };
+
+    FourierTransform transform{ frameOrder };
+    std::vector<float> window;
+    std::vector<float> windowed;
+    std::vector<float> magnitudes;
+
+    //The first and last bin added to the chromagram
+    int firstBin{ 0 };
+    int lastBin{ 0 };
+
+    double chroma[12]{};
+    int key{ -1 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KeyAnalyser)
+};
@@ -0,0 +1,720 @@
+/*
+  ==============================================================================
+
+    LibraryDatabase.cpp
+    Created: 17 Oct 2026 3:06:56pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "LibraryDatabase.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+    //The header at the start of the library file
+    struct LibraryFileHeader
+    {
+        char magic[4]{ 'O', 'D', 'L', 'B' };
+        juce::uint32 version{ 1 };
+        juce::uint32 recordSize{ sizeof(LibraryRecord) };
+        juce::uint32 numRecords{ 0 };
+        juce::uint64 recordsOffset{ 0 };
+        juce::uint64 stringTableOffset{ 0 };
+        juce::uint64 stringTableSize{ 0 };
+        juce::uint32 nextId{ 1 };
+        juce::uint8 reserved[20]{};
+    };
+
+    //The header in front of every entry of the journal
+    struct JournalEntryHeader
+    {
+        juce::uint32 magic{ 0x454a444f };
+        juce::uint32 type{ 0 };
+        juce::uint32 size{ 0 };
+        juce::uint32 checksum{ 0 };
+    };
+
+    static_assert(std::is_trivially_copyable<LibraryRecord>::value, "LibraryRecord is written to disk as it is");
+    static_assert(sizeof(LibraryFileHeader) == 64, "The header of the library file must stay 64 bytes");
+    static_assert(sizeof(LibraryRecord) % 8 == 0, "The records must stay 8 byte aligned in the mapped file");
+
+    //The journal grows until it is this big and a quarter of the library file before it is folded in
+    const juce::int64 compactJournalSize{ 1024 * 1024 };
+
+    //FNV-1a over the payload of a journal entry, to find an entry cut short by a crash
+    juce::uint32 checksum(const void* data, size_t size)
+    {
+        const juce::uint8* bytes{ static_cast<const juce::uint8*>(data) };
+        juce::uint32 hash{ 2166136261u };
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+    }
+}
+
+//==============================================================================
+LibraryDatabase::LibraryDatabase()
+{
+    if (!open(getDefaultFile()))
+    {
+        DBG("LibraryDatabase could not read " << getDefaultFile().getFullPathName() << ", starting an empty library");
+    }
+}
+
+LibraryDatabase::LibraryDatabase(const juce::File& file)
+{
+    if (!open(file))
+    {
+        DBG("LibraryDatabase could not read " << file.getFullPathName() << ", starting an empty library");
+    }
+}
+
+LibraryDatabase::~LibraryDatabase()
+{
+    if (journal != nullptr)
+    {
+        journal->flush();
+    }
+}
+
+juce::File LibraryDatabase::getDefaultFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("OtoDecks_library.odl");
+}
+
+//Opening the files, and folding the journal into the library file if it has grown too big
+bool LibraryDatabase::open(const juce::File& file)
+{
+    libraryFile = file;
+    journalFile = file.withFileExtension("journal");
+    foldersFile = file.withFileExtension("folders");
+    compactionDisabled = false;
+
+    folders.clear();
+    if (foldersFile.existsAsFile())
+    {
+        folders.addLines(foldersFile.loadFileAsString());
+        folders.removeEmptyStrings();
+    }
+
+    const bool openedOk{ openFiles() };
+
+    if (openedOk && shouldCompact())
+    {
+        compact();
+    }
+
+    return openedOk;
+}
+
+bool LibraryDatabase::shouldCompact() const
+{
+    return !compactionDisabled && journalSize > compactJournalSize && journalSize > libraryFile.getSize() / 4;
+}
+
+//Mapping the library file, replaying the journal over it and opening the journal for new entries
+bool LibraryDatabase::openFiles()
+{
+    journal.reset();
+    mappedFile.reset();
+    mappedRecords = nullptr;
+    numMappedRecords = 0;
+    stringTable = nullptr;
+    stringTableSize = 0;
+    changedTracks.clear();
+    removedTracks.clear();
+    trackIds.clear();
+    pathIndex.clear();
+    fingerprintIndex.clear();
+    indexesBuilt = false;
+    nextId = 1;
+
+    const bool mappedOk{ mapLibraryFile() };
+
+    //A library file that cannot be read, eg. one cut short or written by another version, is moved aside
+    //  before anything is written, so compacting the journal never overwrites it. If it cannot be moved
+    //  the journal is not folded in for the rest of the session
+    if (!mappedOk && libraryFile.existsAsFile())
+    {
+        const juce::File aside{ libraryFile.getSiblingFile(libraryFile.getFileName() + ".bad").getNonexistentSibling(false) };
+
+        if (libraryFile.moveFileTo(aside))
+        {
+            DBG("LibraryDatabase::open moved the unreadable library to " << aside.getFullPathName());
+        }
+        else
+        {
+            DBG("LibraryDatabase::open could not move the unreadable library aside, the journal is kept");
+            compactionDisabled = true;
+        }
+    }
+
+    replayJournal();
+
+    journal = std::make_unique<juce::FileOutputStream>(journalFile);
+    if (journal->failedToOpen())
+    {
+        DBG("LibraryDatabase::open could not open the journal " << journalFile.getFullPathName());
+        journal.reset();
+    }
+    else
+    {
+        //An entry cut short by a crash is dropped, so new entries follow the last good one
+        journal->setPosition(journalSize);
+        journal->truncate();
+    }
+
+    return mappedOk;
+}
+
+bool LibraryDatabase::mapLibraryFile()
+{
+    if (!libraryFile.existsAsFile())
+    {
+        return true;
+    }
+
+    mappedFile = std::make_unique<juce::MemoryMappedFile>(libraryFile, juce::MemoryMappedFile::readOnly);
+
+    const char* data{ static_cast<const char*>(mappedFile->getData()) };
+    const juce::uint64 size{ (juce::uint64)mappedFile->getSize() };
+
+    LibraryFileHeader header;
+    if (data == nullptr || size < sizeof(header))
+    {
+        mappedFile.reset();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    //Every table has to be inside the file, or the file is not used at all
+    const bool valid{ std::memcmp(header.magic, "ODLB", 4) == 0
+        && header.version == 1
+        && header.recordSize == sizeof(LibraryRecord)
+        && header.recordsOffset % 8 == 0
+        && header.recordsOffset + (juce::uint64)header.numRecords * sizeof(LibraryRecord) <= size
+        && header.stringTableOffset + header.stringTableSize <= size };
+
+    if (!valid)
+    {
+        mappedFile.reset();
+        return false;
+    }
+
+    mappedRecords = reinterpret_cast<const LibraryRecord*>(data + header.recordsOffset);
+    numMappedRecords = header.numRecords;
+    stringTable = data + header.stringTableOffset;
+    stringTableSize = header.stringTableSize;
+    nextId = juce::jmax((juce::uint32)1, header.nextId);
+
+    trackIds.reserve(numMappedRecords);
+    for (juce::uint32 i = 0; i < numMappedRecords; ++i)
+    {
+        trackIds.push_back(mappedRecords[i].id);
+        nextId = juce::jmax(nextId, mappedRecords[i].id + 1);
+    }
+
+    return true;
+}
+
+//Applying every complete entry of the journal. Reading stops at the first entry that is cut short
+//  or does not match its checksum, which is where a crash stopped writing
+void LibraryDatabase::replayJournal()
+{
+    journalSize = 0;
+
+    juce::MemoryBlock data;
+    if (!journalFile.existsAsFile() || !journalFile.loadFileAsData(data))
+    {
+        return;
+    }
+
+    const char* bytes{ static_cast<const char*>(data.getData()) };
+    const size_t size{ data.getSize() };
+    size_t position{ 0 };
+
+    while (position + sizeof(JournalEntryHeader) <= size)
+    {
+        JournalEntryHeader header;
+        std::memcpy(&header, bytes + position, sizeof(header));
+
+        const size_t payloadStart{ position + sizeof(header) };
+        if (header.magic != JournalEntryHeader{}.magic
+            || payloadStart + header.size > size
+            || checksum(bytes + payloadStart, header.size) != header.checksum)
+        {
+            break;
+        }
+
+        const char* payload{ bytes + payloadStart };
+
+        if (header.type == (juce::uint32)JournalEntry::upsert && header.size >= sizeof(LibraryRecord) + sizeof(juce::uint32))
+        {
+            LibraryRecord record;
+            juce::uint32 pathLength{ 0 };
+            std::memcpy(&record, payload, sizeof(record));
+            std::memcpy(&pathLength, payload + sizeof(record), sizeof(pathLength));
+
+            if (sizeof(record) + sizeof(pathLength) + pathLength <= header.size)
+            {
+                applyUpsert(record, juce::String::fromUTF8(payload + sizeof(record) + sizeof(pathLength), (int)pathLength));
+            }
+        }
+        else if (header.type == (juce::uint32)JournalEntry::remove && header.size >= sizeof(juce::uint32))
+        {
+            juce::uint32 id{ 0 };
+            std::memcpy(&id, payload, sizeof(id));
+            applyRemove(id);
+        }
+
+        position = payloadStart + header.size;
+    }
+
+    journalSize = (juce::int64)position;
+}
+
+//==============================================================================
+const std::vector<juce::uint32>& LibraryDatabase::getTrackIds() const
+{
+    return trackIds;
+}
+
+int LibraryDatabase::getNumTracks() const
+{
+    return (int)trackIds.size();
+}
+
+//A change from the journal wins over the mapped file
+const LibraryRecord* LibraryDatabase::getRecord(juce::uint32 id) const
+{
+    if (removedTracks.count(id) > 0)
+    {
+        return nullptr;
+    }
+
+    auto changed = changedTracks.find(id);
+    if (changed != changedTracks.end())
+    {
+        return &changed->second.record;
+    }
+
+    return findMappedRecord(id);
+}
+
+juce::File LibraryDatabase::getFile(juce::uint32 id) const
+{
+    const juce::String path{ getPath(id) };
+
+    return path.isEmpty() ? juce::File{} : juce::File{ path };
+}
+
+juce::uint32 LibraryDatabase::findTrack(const juce::File& file) const
+{
+    buildIndexes();
+
+    auto entry = pathIndex.find(normalisePath(file.getFullPathName()));
+    return entry == pathIndex.end() ? 0 : entry->second;
+}
+
+juce::uint32 LibraryDatabase::findDuplicate(juce::uint64 fingerprint) const
+{
+    if (fingerprint == 0)
+    {
+        return 0;
+    }
+
+    buildIndexes();
+
+    auto entry = fingerprintIndex.find(fingerprint);
+    return entry == fingerprintIndex.end() ? 0 : entry->second;
+}
+
+juce::uint32 LibraryDatabase::addTrack(const juce::File& file)
+{
+    const juce::uint32 existing{ findTrack(file) };
+    if (existing != 0)
+    {
+        return existing;
+    }
+
+    return addTrack(file, LibraryRecord{});
+}
+
+juce::uint32 LibraryDatabase::addTrack(const juce::File& file, const LibraryRecord& record)
+{
+    const juce::uint32 existing{ findTrack(file) };
+    if (existing != 0)
+    {
+        return existing;
+    }
+
+    LibraryRecord added{ record };
+    added.id = nextId;
+
+    const juce::String path{ file.getFullPathName() };
+    appendToJournal(JournalEntry::upsert, added, path);
+    applyUpsert(added, path);
+
+    return added.id;
+}
+
+void LibraryDatabase::updateRecord(const LibraryRecord& record)
+{
+    if (getRecord(record.id) == nullptr)
+    {
+        DBG("LibraryDatabase::updateRecord there is no track " << (int)record.id);
+        return;
+    }
+
+    const juce::String path{ getPath(record.id) };
+    appendToJournal(JournalEntry::upsert, record, path);
+    applyUpsert(record, path);
+}
+
+//The move is an upsert with the new path, so it is replayed from the journal like any other change
+bool LibraryDatabase::moveTrack(juce::uint32 id, const juce::File& newFile)
+{
+    const LibraryRecord* record{ getRecord(id) };
+    if (record == nullptr || findTrack(newFile) != 0)
+    {
+        return false;
+    }
+
+    const LibraryRecord moved{ *record };
+    const juce::String path{ newFile.getFullPathName() };
+    appendToJournal(JournalEntry::upsert, moved, path);
+    applyUpsert(moved, path);
+
+    return true;
+}
+
+void LibraryDatabase::removeTrack(juce::uint32 id)
+{
+    if (getRecord(id) == nullptr)
+    {
+        return;
+    }
+
+    LibraryRecord record;
+    record.id = id;
+    appendToJournal(JournalEntry::remove, record, {});
+    applyRemove(id);
+}
+
+const juce::StringArray& LibraryDatabase::getFolders() const
+{
+    return folders;
+}
+
+void LibraryDatabase::addFolder(const juce::File& folder)
+{
+    for (const juce::String& path : folders)
+    {
+        const juce::File existing{ path };
+        if (folder == existing || folder.isAChildOf(existing))
+        {
+            return;
+        }
+    }
+
+    for (int i = folders.size(); --i >= 0;)
+    {
+        if (juce::File{ folders[i] }.isAChildOf(folder))
+        {
+            folders.remove(i);
+        }
+    }
+    folders.add(folder.getFullPathName());
+
+    if (!foldersFile.replaceWithText(folders.joinIntoString("\n")))
+    {
+        DBG("LibraryDatabase::addFolder could not write " << foldersFile.getFullPathName());
+    }
+}
+
+void LibraryDatabase::beginBatch()
+{
+    ++batchDepth;
+}
+
+void LibraryDatabase::endBatch()
+{
+    if (batchDepth == 0 || --batchDepth > 0)
+    {
+        return;
+    }
+
+    if (journal != nullptr)
+    {
+        journal->flush();
+    }
+
+    if (shouldCompact())
+    {
+        compact();
+    }
+}
+
+//==============================================================================
+//The entry is written in one go and flushed, so it is on disk before the change is used.
+//In a batch the flush waits for the end of the batch
+void LibraryDatabase::appendToJournal(JournalEntry type, const LibraryRecord& record, const juce::String& path)
+{
+    if (journal == nullptr)
+    {
+        return;
+    }
+
+    juce::MemoryOutputStream payload;
+
+    if (type == JournalEntry::upsert)
+    {
+        const juce::uint32 pathLength{ (juce::uint32)path.getNumBytesAsUTF8() };
+        payload.write(&record, sizeof(record));
+        payload.write(&pathLength, sizeof(pathLength));
+        payload.write(path.toRawUTF8(), pathLength);
+    }
+    else
+    {
+        payload.write(&record.id, sizeof(record.id));
+    }
+
+    JournalEntryHeader header;
+    header.type = (juce::uint32)type;
+    header.size = (juce::uint32)payload.getDataSize();
+    header.checksum = checksum(payload.getData(), payload.getDataSize());
+
+    journal->write(&header, sizeof(header));
+    journal->write(payload.getData(), payload.getDataSize());
+
+    if (batchDepth == 0)
+    {
+        journal->flush();
+    }
+
+    journalSize += (juce::int64)(sizeof(header) + payload.getDataSize());
+}
+
+void LibraryDatabase::applyUpsert(const LibraryRecord& record, const juce::String& path)
+{
+    if (record.id == 0)
+    {
+        return;
+    }
+
+    const LibraryRecord* previous{ getRecord(record.id) };
+    const bool isNew{ previous == nullptr };
+    const juce::uint64 previousFingerprint{ isNew ? 0 : previous->fingerprint };
+    const juce::String previousPath{ isNew ? juce::String{} : getPath(record.id) };
+
+    removedTracks.erase(record.id);
+    changedTracks[record.id] = ChangedTrack{ record, path };
+    nextId = juce::jmax(nextId, record.id + 1);
+
+    if (isNew)
+    {
+        trackIds.push_back(record.id);
+    }
+
+    if (indexesBuilt)
+    {
+        //A moved track is no longer found under its old path
+        if (!isNew && previousPath != path)
+        {
+            auto entry = pathIndex.find(normalisePath(previousPath));
+            if (entry != pathIndex.end() && entry->second == record.id)
+            {
+                pathIndex.erase(entry);
+            }
+        }
+        pathIndex[normalisePath(path)] = record.id;
+
+        if (previousFingerprint != record.fingerprint)
+        {
+            auto entry = fingerprintIndex.find(previousFingerprint);
+            if (entry != fingerprintIndex.end() && entry->second == record.id)
+            {
+                fingerprintIndex.erase(entry);
+            }
+        }
+        if (record.fingerprint != 0)
+        {
+            fingerprintIndex.emplace(record.fingerprint, record.id);
+        }
+    }
+}
+
+void LibraryDatabase::applyRemove(juce::uint32 id)
+{
+    const LibraryRecord* record{ getRecord(id) };
+    if (record == nullptr)
+    {
+        return;
+    }
+
+    if (indexesBuilt)
+    {
+        pathIndex.erase(normalisePath(getPath(id)));
+
+        auto entry = fingerprintIndex.find(record->fingerprint);
+        if (entry != fingerprintIndex.end() && entry->second == id)
+        {
+            fingerprintIndex.erase(entry);
+        }
+    }
+
+    changedTracks.erase(id);
+    removedTracks.insert(id);
+    trackIds.erase(std::remove(trackIds.begin(), trackIds.end(), id), trackIds.end());
+}
+
+//==============================================================================
+//The records of the library file are sorted by id, so they are found with a binary search
+const LibraryRecord* LibraryDatabase::findMappedRecord(juce::uint32 id) const
+{
+    if (mappedRecords == nullptr)
+    {
+        return nullptr;
+    }
+
+    const LibraryRecord* end{ mappedRecords + numMappedRecords };
+    const LibraryRecord* found{ std::lower_bound(mappedRecords, end, id,
+        [](const LibraryRecord& record, juce::uint32 value) { return record.id < value; }) };
+
+    return (found != end && found->id == id) ? found : nullptr;
+}
+
+juce::String LibraryDatabase::getMappedPath(const LibraryRecord& record) const
+{
+    if (stringTable == nullptr || record.pathOffset + record.pathLength > stringTableSize)
+    {
+        return {};
+    }
+    return juce::String::fromUTF8(stringTable + record.pathOffset, (int)record.pathLength);
+}
+
+juce::String LibraryDatabase::getPath(juce::uint32 id) const
+{
+    if (removedTracks.count(id) > 0)
+    {
+        return {};
+    }
+
+    auto changed = changedTracks.find(id);
+    if (changed != changedTracks.end())
+    {
+        return changed->second.path;
+    }
+
+    const LibraryRecord* record{ findMappedRecord(id) };
+    return record != nullptr ? getMappedPath(*record) : juce::String{};
+}
+
+std::string LibraryDatabase::normalisePath(const juce::String& path)
+{
+    return (juce::File::areFileNamesCaseSensitive() ? path : path.toLowerCase()).toStdString();
+}
+
+void LibraryDatabase::buildIndexes() const
+{
+    if (indexesBuilt)
+    {
+        return;
+    }
+
+    pathIndex.reserve(trackIds.size());
+    for (juce::uint32 id : trackIds)
+    {
+        pathIndex[normalisePath(getPath(id))] = id;
+
+        const juce::uint64 fingerprint{ getRecord(id)->fingerprint };
+        if (fingerprint != 0)
+        {
+            fingerprintIndex.emplace(fingerprint, id);
+        }
+    }
+    indexesBuilt = true;
+}
+
+//==============================================================================
+//Everything is gathered in memory first, because the old file stays mapped until the new one replaces it
+bool LibraryDatabase::compact()
+{
+    if (compactionDisabled)
+    {
+        return false;
+    }
+
+    std::vector<juce::uint32> ids{ trackIds };
+    std::sort(ids.begin(), ids.end());
+
+    std::vector<LibraryRecord> records;
+    records.reserve(ids.size());
+    juce::MemoryOutputStream strings;
+
+    for (juce::uint32 id : ids)
+    {
+        LibraryRecord record{ *getRecord(id) };
+        const juce::String path{ getPath(id) };
+
+        record.pathOffset = strings.getDataSize();
+        record.pathLength = (juce::uint32)path.getNumBytesAsUTF8();
+        strings.write(path.toRawUTF8(), record.pathLength);
+
+        records.push_back(record);
+    }
+
+    LibraryFileHeader header;
+    header.numRecords = (juce::uint32)records.size();
+    header.recordsOffset = sizeof(header);
+    header.stringTableOffset = header.recordsOffset + records.size() * sizeof(LibraryRecord);
+    header.stringTableSize = strings.getDataSize();
+    header.nextId = nextId;
+
+    juce::TemporaryFile tempFile{ libraryFile };
+    {
+        juce::FileOutputStream output{ tempFile.getFile() };
+        if (output.failedToOpen())
+        {
+            DBG("LibraryDatabase::compact could not write " << tempFile.getFile().getFullPathName());
+            return false;
+        }
+
+        output.write(&header, sizeof(header));
+        output.write(records.data(), records.size() * sizeof(LibraryRecord));
+        output.write(strings.getData(), strings.getDataSize());
+        output.flush();
+
+        //A short write, eg. on a full disk, leaves the old file and the journal as they are
+        if (output.getStatus().failed())
+        {
+            DBG("LibraryDatabase::compact could not write " << tempFile.getFile().getFullPathName());
+            return false;
+        }
+    }
+
+    //The old file is unmapped before it is replaced
+    mappedFile.reset();
+    mappedRecords = nullptr;
+    stringTable = nullptr;
+
+    if (!tempFile.overwriteTargetFileWithTemporary())
+    {
+        DBG("LibraryDatabase::compact could not replace " << libraryFile.getFullPathName());
+        openFiles();
+        return false;
+    }
+
+    //The journal is only emptied once the new library file is in place
+    journal.reset();
+    journalFile.deleteFile();
+
+    return openFiles();
+}
@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    LibraryDatabase.h
+    Created: 17 Oct 2026 3:06:56pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//==============================================================================
+//One track of the library as it is stored on disk. The record has a fixed size and no pointers,
+//  so the records of the library file can be used straight from the memory-mapped file.
+//Numbers are stored in the byte order of the machine
+struct LibraryRecord
+{
+    //The number of hot cues kept per track
+    static constexpr int numHotCues{ 8 };
+
+    //A number that stays the same for the life of the track in the library
+    juce::uint32 id{ 0 };
+    juce::uint32 flags{ 0 };
+
+    //The path of the file, as a position and length in the string table
+    juce::uint64 pathOffset{ 0 };
+    juce::uint32 pathLength{ 0 };
+
+    //The metadata of the file, 0 until it has been probed
+    juce::uint32 numChannels{ 0 };
+    double lengthInSeconds{ 0.0 };
+    double sampleRate{ 0.0 };
+    juce::int64 fileSize{ 0 };
+    juce::int64 modificationTime{ 0 };
+
+    //The analysis results, valid when the matching flag is set in analysisFlags
+    juce::uint32 analysisFlags{ 0 };
+    float bpm{ 0.0f };
+    //The time of the first beat of the beat grid in seconds
+    float beatOffset{ 0.0f };
+    //The key as an index from 0 to 23, or -1
+    juce::int32 key{ -1 };
+    //The integrated loudness in LUFS, the true peak in dBTP and the gain in decibels that the
+    //  auto gain applies to the track
+    float loudness{ 0.0f };
+    float truePeak{ 0.0f };
+    float autoGain{ 0.0f };
+
+    //The cue points in seconds, -1 when not set
+    double mainCue{ -1.0 };
+    double hotCues[numHotCues]{ -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0 };
+
+    //A hash of the size of the file and of blocks of its audio, see AudioFingerprint. 0 when not known
+    juce::uint64 fingerprint{ 0 };
+
+    //Space for fields added later, so that the record size does not change
+    juce::uint8 reserved[24]{};
+};
+
+//A file left out of the library because the same audio is already in it under another path
+struct DuplicateTrack
+{
+    juce::File file;
+    //The track of the library with the same fingerprint
+    juce::File original;
+    //The id the file had in the library before it was taken out again, 0 if it was never added
+    juce::uint32 libraryId{ 0 };
+};
+
+//==============================================================================
+//The library of tracks, kept in a compact binary file and a journal.
+//The library file holds a header, a table of fixed-size records sorted by id and a table of strings.
+//  It is memory-mapped when the library is opened, so even a very big library opens straight away.
+//Every change is appended to the journal and flushed, so saving never rewrites the library file and a crash
+//  loses nothing. Changes made in a batch are flushed together when the batch ends. The journal is replayed on top of the library file when it is opened, and folded into
+//  a new library file when it grows too big.
+//It is only used on the message thread, and is shared using a juce::SharedResourcePointer
+class LibraryDatabase
+{
+public:
+    //Bits of LibraryRecord::analysisFlags
+    enum AnalysisFlags
+    {
+        hasBpm = 1 << 0,
+        hasKey = 1 << 1,
+        hasLoudness = 1 << 2
+    };
+
+    //Opens the library in the user application data folder
+    LibraryDatabase();
+    //Opens the library in a given file, eg. a temporary one in the tests
+    explicit LibraryDatabase(const juce::File& libraryFile);
+    ~LibraryDatabase();
+
+    //Opens a library file and its journal, creating them if needed. Returns false if the file could not be read
+    bool open(const juce::File& libraryFile);
+
+    //The ids of the tracks in the order they were added
+    const std::vector<juce::uint32>& getTrackIds() const;
+    int getNumTracks() const;
+
+    //Returns the record of a track, or nullptr if there is no such track. The pointer is only valid
+    //  until the library is changed
+    const LibraryRecord* getRecord(juce::uint32 id) const;
+    juce::File getFile(juce::uint32 id) const;
+    //The path of a track, or an empty string if there is no such track
+    juce::String getPath(juce::uint32 id) const;
+
+    //Returns the id of the track for a file, or 0 if it is not in the library.
+    //Paths are compared the way the file system compares them, so on Windows and macOS the case is ignored
+    juce::uint32 findTrack(const juce::File& file) const;
+    //Returns the id of a track with the same audio fingerprint, or 0 if there is none
+    juce::uint32 findDuplicate(juce::uint64 fingerprint) const;
+
+    //Adds a file to the library and returns its id. A file that is already there keeps its id
+    juce::uint32 addTrack(const juce::File& file);
+    //Adds a file with its record already filled in, eg. by a scan, as a single change. The id of the
+    //  record is ignored. A file that is already there keeps its id and its record
+    juce::uint32 addTrack(const juce::File& file, const LibraryRecord& record);
+    //Writes a changed record. The id and the path cannot be changed
+    void updateRecord(const LibraryRecord& record);
+    //Gives a track a new path, eg. when its file was moved or renamed, keeping its id and its record.
+    //Returns false if there is no such track or another track already has the new path
+    bool moveTrack(juce::uint32 id, const juce::File& newFile);
+    void removeTrack(juce::uint32 id);
+
+    //The folders imported into the library, which the LibraryWatcher watches with their sub folders.
+    //They are kept in a small text file next to the library file, one path per line
+    const juce::StringArray& getFolders() const;
+    //Adding an imported folder. A folder inside one that is already there is left out, and the folders
+    //  inside a new one are replaced by it
+    void addFolder(const juce::File& folder);
+
+    //Writes a new library file holding everything and empties the journal.
+    //Returns false, leaving both files as they were, if the new file could not be written
+    bool compact();
+
+    //The changes made until endBatch is called are flushed to the journal together, which is much
+    //  faster when adding a lot of tracks. Batches can be nested.
+    //The journal is folded into the library file at the end of a batch if it has grown too big
+    void beginBatch();
+    void endBatch();
+
+    //The default place of the library
+    static juce::File getDefaultFile();
+
+private:
+    //The types of the entries of the journal
+    enum class JournalEntry : juce::uint32
+    {
+        upsert = 1,
+        remove = 2
+    };
+
+    //A record changed since the library file was written, with its path
+    struct ChangedTrack
+    {
+        LibraryRecord record;
+        juce::String path;
+    };
+
+    //Mapping the library file and replaying the journal, without folding the journal in
+    bool openFiles();
+    //Reading the library file and the journal
+    bool mapLibraryFile();
+    void replayJournal();
+    //Returns true when the journal has grown big enough to be folded into the library file
+    bool shouldCompact() const;
+    //Appending an entry to the journal and flushing it to disk, unless a batch is open
+    void appendToJournal(JournalEntry type, const LibraryRecord& record, const juce::String& path);
+
+    //Applying a change in memory, used when writing and replaying
+    void applyUpsert(const LibraryRecord& record, const juce::String& path);
+    void applyRemove(juce::uint32 id);
+
+    //Finding a record of the mapped file by id
+    const LibraryRecord* findMappedRecord(juce::uint32 id) const;
+    juce::String getMappedPath(const LibraryRecord& record) const;
+
+    //The key of a path in the path lookup
+    static std::string normalisePath(const juce::String& path);
+    //Building the path and fingerprint lookups the first time they are needed
+    void buildIndexes() const;
+
+    juce::File libraryFile;
+    juce::File journalFile;
+    juce::File foldersFile;
+
+    //The imported folders, read from foldersFile when the library is opened
+    juce::StringArray folders;
+
+    //The mapped library file and its tables
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const LibraryRecord* mappedRecords{ nullptr };
+    juce::uint32 numMappedRecords{ 0 };
+    const char* stringTable{ nullptr };
+    juce::uint64 stringTableSize{ 0 };
+
+    //The changes from the journal and from this run, on top of the mapped file
+    std::unordered_map<juce::uint32, ChangedTrack> changedTracks;
+    std::unordered_set<juce::uint32> removedTracks;
+
+    //The ids of every track in the library, in order
+    std::vector<juce::uint32> trackIds;
+    juce::uint32 nextId{ 1 };
+
+    //The path and fingerprint lookups, built on first use. The fingerprint lookup holds the first
+    //  track that was found with each fingerprint
+    mutable std::unordered_map<std::string, juce::uint32> pathIndex;
+    mutable std::unordered_map<juce::uint64, juce::uint32> fingerprintIndex;
+    mutable bool indexesBuilt{ false };
+
+    std::unique_ptr<juce::FileOutputStream> journal;
+    juce::int64 journalSize{ 0 };
+    //The number of batches that are open
+    int batchDepth{ 0 };
+    //Set when an unreadable library file could not be moved aside, so that compact() never replaces it
+    bool compactionDisabled{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryDatabase)
+};
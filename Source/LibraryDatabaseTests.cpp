@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    LibraryDatabaseTests.cpp
+    Created: 17 Oct 2026 5:09:32pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "LibraryDatabase.h"
+#include <memory>
+
+//==============================================================================
+//Checks that the LibraryDatabase gets back everything it wrote, from the journal and from a compacted
+//  library file, and that a journal entry cut short by a crash is dropped.
+//Every test works on a temporary library file, never on the user's library.
+//It is run from the command line with --run-tests
+class LibraryDatabaseTests : public juce::UnitTest
+{
+public:
+    LibraryDatabaseTests()
+        : juce::UnitTest("LibraryDatabase", "OtoDecks")
+    {
+    }
+
+    void runTest() override
+    {
+        const juce::File libraryFile{ juce::File::createTempFile(".odl") };
+        const juce::File journalFile{ libraryFile.withFileExtension("journal") };
+        const juce::File folder{ libraryFile.getParentDirectory() };
+        const juce::File first{ folder.getChildFile("OtoDecks test 1.mp3") };
+        const juce::File second{ folder.getChildFile("OtoDecks test 2.mp3") };
+        const juce::File third{ folder.getChildFile("OtoDecks test 3.mp3") };
+        const juce::File moved{ folder.getChildFile("OtoDecks test moved.mp3") };
+
+        juce::uint32 firstId{ 0 };
+        juce::uint32 secondId{ 0 };
+
+        beginTest("Added tracks are there after reopening");
+        {
+            LibraryDatabase library{ libraryFile };
+            firstId = library.addTrack(first);
+            secondId = library.addTrack(second);
+            expect(firstId != 0 && secondId != 0 && firstId != secondId);
+        }
+        {
+            LibraryDatabase library{ libraryFile };
+            expectEquals(library.getNumTracks(), 2);
+            expect(library.findTrack(first) == firstId);
+            expect(library.getFile(secondId) == second);
+        }
+
+        //The last entry is the second track, so cutting into it leaves only the first one
+        beginTest("A cut short journal entry is dropped and the next write follows the last good entry");
+        {
+            juce::FileOutputStream journal{ journalFile };
+            expect(journal.setPosition(journalFile.getSize() - 10));
+            expect(journal.truncate().wasOk());
+        }
+        {
+            LibraryDatabase library{ libraryFile };
+            expectEquals(library.getNumTracks(), 1);
+            expect(library.findTrack(second) == 0);
+
+            secondId = library.addTrack(third);
+        }
+        {
+            LibraryDatabase library{ libraryFile };
+            expectEquals(library.getNumTracks(), 2);
+            expect(library.findTrack(first) == firstId);
+            expect(library.findTrack(third) == secondId);
+        }
+
+        beginTest("Moved and removed tracks stay that way after the journal is replayed");
+        {
+            LibraryDatabase library{ libraryFile };
+            expect(library.moveTrack(firstId, moved));
+            library.removeTrack(secondId);
+        }
+        {
+            LibraryDatabase library{ libraryFile };
+            expectEquals(library.getNumTracks(), 1);
+            expect(library.findTrack(first) == 0);
+            expect(library.findTrack(moved) == firstId);
+            expect(library.getRecord(secondId) == nullptr);
+        }
+
+        //The track added last is removed before compacting, so the next id is not the biggest id plus one
+        beginTest("Compacting keeps the ids, the paths and the next id");
+        juce::uint32 nextId{ 0 };
+        {
+            LibraryDatabase library{ libraryFile };
+            const juce::uint32 removedId{ library.addTrack(second) };
+            library.removeTrack(removedId);
+            nextId = removedId + 1;
+
+            expect(library.compact());
+            expect(!journalFile.existsAsFile() || journalFile.getSize() == 0);
+        }
+        {
+            LibraryDatabase library{ libraryFile };
+            expectEquals(library.getNumTracks(), 1);
+            expect(library.getFile(firstId) == moved);
+            expect(library.findTrack(moved) == firstId);
+            expect(library.addTrack(third) == nextId);
+        }
+
+        libraryFile.deleteFile();
+        journalFile.deleteFile();
+    }
+};
+
+static LibraryDatabaseTests libraryDatabaseTests;
@@ -0,0 +1,671 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.cpp
+    Created: 17 Oct 2026 3:29:51pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "LibraryWatcher.h"
+#include <set>
+#include <algorithm>
+
+#if JUCE_LINUX
+ #include <sys/inotify.h>
+ #include <poll.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    //Returns where a file in a moved folder, or the folder itself, is after the move
+    juce::File getMovedFile(const juce::File& file, const juce::File& from, const juce::File& to)
+    {
+        return file == from ? to : to.getChildFile(file.getRelativePathFrom(from));
+    }
+}
+
+//The extensions are taken from a format manager, so only files that can be played are watched
+LibraryWatcher::LibraryWatcher()
+    : juce::Thread("Library watcher")
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    extensions = formatManager.getWildcardForAllFormats().removeCharacters("*.");
+}
+
+LibraryWatcher::~LibraryWatcher()
+{
+    stopThread(2000);
+}
+
+//The snapshot is made here, since the library can only be read on the message thread
+void LibraryWatcher::start(TracksAddedCallback onTracksAdded, TracksRemovedCallback onTracksRemoved)
+{
+    if (isThreadRunning())
+    {
+        return;
+    }
+
+    tracksAddedCallback = std::move(onTracksAdded);
+    tracksRemovedCallback = std::move(onTracksRemoved);
+    safeThis = this;
+
+    snapshot.clear();
+    snapshot.reserve(library->getTrackIds().size());
+
+    for (const juce::uint32 id : library->getTrackIds())
+    {
+        const LibraryRecord* record{ library->getRecord(id) };
+        if (record != nullptr)
+        {
+            snapshot.push_back({ library->getFile(id).getFullPathName(), record->fileSize, record->modificationTime });
+        }
+    }
+
+    //The imported folders are scanned and watched whole, so new files in sub folders that hold no
+    //  track yet are found as well
+    scannedFolders.clear();
+    for (const juce::String& folder : library->getFolders())
+    {
+        scannedFolders.push_back(juce::File{ folder });
+    }
+
+    startThread(3);
+}
+
+void LibraryWatcher::watchFolder(const juce::File& folder)
+{
+    library->addFolder(folder);
+
+    const juce::ScopedLock scopedLock(folderLock);
+    newFolders.push_back(folder);
+}
+
+bool LibraryWatcher::Changes::isEmpty() const
+{
+    return written.empty() && removed.empty() && moved.empty() && movedFolders.empty() && removedFolders.empty();
+}
+
+//==============================================================================
+void LibraryWatcher::run()
+{
+    post(reconcile());
+
+#if JUCE_LINUX
+    const int inotify{ inotify_init1(IN_NONBLOCK | IN_CLOEXEC) };
+
+    if (inotify >= 0)
+    {
+        watch(inotify);
+        close(inotify);
+        return;
+    }
+    DBG("LibraryWatcher could not start inotify, the tracks are checked every " << pollSeconds << " s instead");
+#endif
+
+    while (!threadShouldExit())
+    {
+        wait(pollSeconds * 1000);
+
+        {
+            const juce::ScopedLock scopedLock(folderLock);
+            scannedFolders.insert(scannedFolders.end(), newFolders.begin(), newFolders.end());
+            newFolders.clear();
+        }
+
+        if (!threadShouldExit())
+        {
+            post(reconcile());
+        }
+    }
+}
+
+//Only the directory entries are read. The folders of the tracks, and the folders given to watchFolder with
+//  their sub folders, are scanned for audio files that are not in the snapshot. A new file with the same name,
+//  size and modification time as a missing one is that file moved, eg. with its folder. Any other missing file
+//  is only reported if its folder is still there
+LibraryWatcher::Changes LibraryWatcher::reconcile()
+{
+    Changes changes;
+    std::vector<size_t> missing;
+    std::set<juce::String> known;
+    std::set<juce::String> folders;
+
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        if (threadShouldExit())
+        {
+            return changes;
+        }
+
+        WatchedFile& watched{ snapshot[i] };
+        const juce::File file{ watched.path };
+        known.insert(watched.path);
+
+        if (!file.existsAsFile())
+        {
+            missing.push_back(i);
+            continue;
+        }
+        folders.insert(file.getParentDirectory().getFullPathName());
+
+        const juce::int64 fileSize{ file.getSize() };
+        const juce::int64 modificationTime{ file.getLastModificationTime().toMilliseconds() };
+
+        if (fileSize != watched.fileSize || modificationTime != watched.modificationTime)
+        {
+            changes.written.push_back(file);
+            watched.fileSize = fileSize;
+            watched.modificationTime = modificationTime;
+        }
+    }
+
+    std::vector<WatchedFile> newFiles;
+    for (const juce::String& folder : folders)
+    {
+        scanFolder(juce::File{ folder }, false, known, newFiles);
+    }
+    for (const juce::File& folder : scannedFolders)
+    {
+        scanFolder(folder, true, known, newFiles);
+    }
+
+    for (const WatchedFile& newFile : newFiles)
+    {
+        const juce::File file{ newFile.path };
+
+        auto moved = std::find_if(missing.begin(), missing.end(), [this, &file, &newFile](size_t i)
+        {
+            const WatchedFile& watched{ snapshot[i] };
+            return watched.fileSize == newFile.fileSize && watched.modificationTime == newFile.modificationTime
+                && juce::File{ watched.path }.getFileName() == file.getFileName();
+        });
+
+        if (moved != missing.end())
+        {
+            changes.moved.push_back({ juce::File{ snapshot[*moved].path }, file });
+            snapshot[*moved].path = newFile.path;
+            missing.erase(moved);
+        }
+        else
+        {
+            changes.written.push_back(file);
+            snapshot.push_back(newFile);
+        }
+    }
+
+    for (const size_t i : missing)
+    {
+        const juce::File file{ snapshot[i].path };
+
+        if (file.getParentDirectory().isDirectory())
+        {
+            changes.removed.push_back(file);
+            snapshot[i].path.clear();
+        }
+    }
+
+    snapshot.erase(std::remove_if(snapshot.begin(), snapshot.end(), [](const WatchedFile& watched)
+    {
+        return watched.path.isEmpty();
+    }), snapshot.end());
+
+    return changes;
+}
+
+void LibraryWatcher::scanFolder(const juce::File& folder, bool recursive, std::set<juce::String>& known,
+                                std::vector<WatchedFile>& newFiles)
+{
+    for (const juce::DirectoryEntry& entry : juce::RangedDirectoryIterator(folder, recursive, "*", juce::File::findFiles))
+    {
+        if (threadShouldExit())
+        {
+            return;
+        }
+
+        const juce::File file{ entry.getFile() };
+
+        if (isAudioFile(file) && known.insert(file.getFullPathName()).second)
+        {
+            newFiles.push_back({ file.getFullPathName(), entry.getFileSize(), entry.getModificationTime().toMilliseconds() });
+        }
+    }
+}
+
+void LibraryWatcher::post(Changes changes)
+{
+    if (changes.isEmpty())
+    {
+        return;
+    }
+
+    auto readStats = [&changes](const juce::File& file)
+    {
+        FileStats& fileStats{ changes.stats[file.getFullPathName()] };
+
+        if (file.existsAsFile())
+        {
+            fileStats.fileSize = file.getSize();
+            fileStats.modificationTime = file.getLastModificationTime().toMilliseconds();
+        }
+    };
+
+    for (const juce::File& file : changes.written)
+    {
+        readStats(file);
+    }
+    for (const std::pair<juce::File, juce::File>& move : changes.moved)
+    {
+        readStats(move.second);
+    }
+
+    juce::WeakReference<LibraryWatcher> watcher{ safeThis };
+    auto shared = std::make_shared<Changes>(std::move(changes));
+
+    juce::MessageManager::callAsync([watcher, shared]
+    {
+        if (watcher != nullptr)
+        {
+            watcher->apply(*shared);
+        }
+    });
+}
+
+//All the changes go into the library with a single flush of the journal.
+//The folders are handled first, so a file moved after its folder was is found under its new path.
+//A written file that is not in the library is added. One that is, and whose size or modification time
+//  changed, loses its analysis and is probed and analysed again. The sizes and times were read on the watcher thread
+void LibraryWatcher::apply(const Changes& changes)
+{
+    std::vector<FolderImporter::ImportedTrack> added;
+    std::vector<juce::uint32> removed;
+    std::vector<juce::File> written{ changes.written };
+
+    library->beginBatch();
+
+    for (const std::pair<juce::File, juce::File>& move : changes.movedFolders)
+    {
+        for (const juce::uint32 id : findTracksIn(move.first))
+        {
+            const juce::File oldFile{ library->getFile(id) };
+            const juce::File newFile{ getMovedFile(oldFile, move.first, move.second) };
+
+            if (library->moveTrack(id, newFile))
+            {
+                metadataStore->remove(oldFile);
+                removed.push_back(id);
+                added.push_back({ newFile, id });
+            }
+        }
+    }
+
+    for (const juce::File& folder : changes.removedFolders)
+    {
+        for (const juce::uint32 id : findTracksIn(folder))
+        {
+            metadataStore->remove(library->getFile(id));
+            library->removeTrack(id);
+            removed.push_back(id);
+        }
+    }
+
+    for (const std::pair<juce::File, juce::File>& move : changes.moved)
+    {
+        const juce::uint32 id{ library->findTrack(move.first) };
+
+        if (id != 0 && library->moveTrack(id, move.second))
+        {
+            metadataStore->remove(move.first);
+            removed.push_back(id);
+            added.push_back({ move.second, id });
+        }
+        else
+        {
+            written.push_back(move.second);
+        }
+    }
+
+    for (const juce::File& file : changes.removed)
+    {
+        const juce::uint32 id{ library->findTrack(file) };
+
+        if (id != 0)
+        {
+            library->removeTrack(id);
+            metadataStore->remove(file);
+            removed.push_back(id);
+        }
+    }
+
+    std::set<juce::String> handled;
+    for (const juce::File& file : written)
+    {
+        const juce::String path{ file.getFullPathName() };
+        auto fileStats = changes.stats.find(path);
+
+        if (!handled.insert(path).second || fileStats == changes.stats.end() || fileStats->second.fileSize < 0)
+        {
+            continue;
+        }
+
+        const juce::uint32 id{ library->findTrack(file) };
+
+        if (id == 0)
+        {
+            added.push_back({ file, library->addTrack(file) });
+        }
+        else
+        {
+            const LibraryRecord* record{ library->getRecord(id) };
+
+            if (record->fileSize == fileStats->second.fileSize
+                && record->modificationTime == fileStats->second.modificationTime)
+            {
+                continue;
+            }
+
+            LibraryRecord updated{ *record };
+            updated.analysisFlags = 0;
+            library->updateRecord(updated);
+        }
+
+        metadataStore->request(file);
+        analysisEngine->analyseLater(file);
+    }
+
+    library->endBatch();
+
+    if (!removed.empty() && tracksRemovedCallback != nullptr)
+    {
+        tracksRemovedCallback(removed);
+    }
+    if (!added.empty() && tracksAddedCallback != nullptr)
+    {
+        tracksAddedCallback(added);
+    }
+}
+
+bool LibraryWatcher::isAudioFile(const juce::File& file) const
+{
+    return file.hasFileExtension(extensions);
+}
+
+//The paths are compared as strings, so no juce::File is made for every track of the library
+std::vector<juce::uint32> LibraryWatcher::findTracksIn(const juce::File& folder) const
+{
+    std::vector<juce::uint32> ids;
+    const juce::String prefix{ juce::File::addTrailingSeparator(folder.getFullPathName()) };
+    const bool ignoreCase{ !juce::File::areFileNamesCaseSensitive() };
+
+    for (const juce::uint32 id : library->getTrackIds())
+    {
+        const juce::String path{ library->getPath(id) };
+
+        if (ignoreCase ? path.startsWithIgnoreCase(prefix) : path.startsWith(prefix))
+        {
+            ids.push_back(id);
+        }
+    }
+
+    return ids;
+}
+
+//==============================================================================
+#if JUCE_LINUX
+//The imported folders are watched with every sub folder, and every other folder that holds a track is
+//  watched on its own. inotify watches are not recursive, so a new sub folder gets its own watch when it appears
+void LibraryWatcher::watch(int inotify)
+{
+    {
+        for (const juce::File& folder : scannedFolders)
+        {
+            addWatch(inotify, folder, true, nullptr);
+        }
+
+        std::set<juce::String> folders;
+        for (const WatchedFile& watched : snapshot)
+        {
+            folders.insert(juce::File{ watched.path }.getParentDirectory().getFullPathName());
+        }
+
+        for (const juce::String& path : folders)
+        {
+            const juce::File folder{ path };
+            const bool imported{ std::any_of(scannedFolders.begin(), scannedFolders.end(), [&folder](const juce::File& scanned)
+            {
+                return folder == scanned || folder.isAChildOf(scanned);
+            }) };
+
+            if (!imported)
+            {
+                addWatch(inotify, folder, false, nullptr);
+            }
+        }
+    }
+
+    Changes changes;
+    std::map<juce::uint32, juce::File> movedFrom;
+    std::map<juce::uint32, juce::File> foldersMovedFrom;
+    double lastEventTime{ 0.0 };
+
+    while (!threadShouldExit())
+    {
+        std::vector<juce::File> folders;
+        {
+            const juce::ScopedLock scopedLock(folderLock);
+            folders.swap(newFolders);
+        }
+        //The tracks of an imported folder are already in the library
+        for (const juce::File& folder : folders)
+        {
+            addWatch(inotify, folder, true, nullptr);
+        }
+
+        pollfd descriptor{ inotify, POLLIN, 0 };
+        if (poll(&descriptor, 1, 250) > 0)
+        {
+            readEvents(inotify, changes, movedFrom, foldersMovedFrom);
+            lastEventTime = juce::Time::getMillisecondCounterHiRes();
+        }
+
+        //A file or folder moved out of the watched folders is only seen leaving, so once the events settle
+        //  it is removed. inotify keeps watching a folder wherever it goes, so its watches are removed as well
+        if ((!changes.isEmpty() || !movedFrom.empty() || !foldersMovedFrom.empty())
+            && juce::Time::getMillisecondCounterHiRes() - lastEventTime > settleMilliseconds)
+        {
+            for (const std::pair<const juce::uint32, juce::File>& entry : movedFrom)
+            {
+                changes.removed.push_back(entry.second);
+            }
+            movedFrom.clear();
+
+            for (const std::pair<const juce::uint32, juce::File>& entry : foldersMovedFrom)
+            {
+                removeWatches(inotify, entry.second);
+                changes.removedFolders.push_back(entry.second);
+            }
+            foldersMovedFrom.clear();
+
+            post(std::move(changes));
+            changes = Changes{};
+        }
+    }
+}
+
+void LibraryWatcher::addWatch(int inotify, const juce::File& folder, bool recursive, Changes* changes)
+{
+    const juce::uint32 mask{ IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE | IN_CREATE | IN_ONLYDIR };
+    const int descriptor{ inotify_add_watch(inotify, folder.getFullPathName().toRawUTF8(), mask) };
+
+    if (descriptor < 0)
+    {
+        DBG("LibraryWatcher could not watch " << folder.getFullPathName());
+        return;
+    }
+    watches[descriptor] = folder;
+
+    if (!recursive)
+    {
+        return;
+    }
+
+    for (const juce::DirectoryEntry& entry : juce::RangedDirectoryIterator(folder, false, "*", juce::File::findFilesAndDirectories))
+    {
+        if (entry.isDirectory())
+        {
+            addWatch(inotify, entry.getFile(), true, changes);
+        }
+        else if (changes != nullptr && isAudioFile(entry.getFile()))
+        {
+            changes->written.push_back(entry.getFile());
+        }
+    }
+}
+
+//The watches of a moved folder stay on it, so they are only given the new path
+void LibraryWatcher::moveWatches(const juce::File& from, const juce::File& to)
+{
+    for (std::pair<const int, juce::File>& entry : watches)
+    {
+        if (entry.second == from || entry.second.isAChildOf(from))
+        {
+            entry.second = getMovedFile(entry.second, from, to);
+        }
+    }
+}
+
+void LibraryWatcher::removeWatches(int inotify, const juce::File& folder)
+{
+    for (auto entry = watches.begin(); entry != watches.end();)
+    {
+        if (entry->second == folder || entry->second.isAChildOf(folder))
+        {
+            inotify_rm_watch(inotify, entry->first);
+            entry = watches.erase(entry);
+        }
+        else
+        {
+            ++entry;
+        }
+    }
+}
+
+//A move within the watched folders is a moved from and a moved to event with the same cookie, for a file
+//  or a folder. Only the folder itself is reported moving, not the files in it, so the changes that are
+//  waiting for files in it are given their new path.
+//A file is only reported as written once it is closed, so a file being copied is not read half way
+void LibraryWatcher::readEvents(int inotify, Changes& changes, std::map<juce::uint32, juce::File>& movedFrom,
+                                std::map<juce::uint32, juce::File>& foldersMovedFrom)
+{
+    alignas(inotify_event) char buffer[16384];
+
+    for (;;)
+    {
+        const ssize_t length{ read(inotify, buffer, sizeof(buffer)) };
+        if (length <= 0)
+        {
+            return;
+        }
+
+        for (const char* position = buffer; position < buffer + length;)
+        {
+            const inotify_event* event{ reinterpret_cast<const inotify_event*>(position) };
+            position += sizeof(inotify_event) + event->len;
+
+            if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+                DBG("LibraryWatcher the inotify queue overflowed, some changes were missed");
+                continue;
+            }
+
+            if ((event->mask & IN_IGNORED) != 0)
+            {
+                watches.erase(event->wd);
+                continue;
+            }
+
+            auto folder = watches.find(event->wd);
+            if (folder == watches.end() || event->len == 0)
+            {
+                continue;
+            }
+
+            const juce::File file{ folder->second.getChildFile(juce::String::fromUTF8(event->name)) };
+
+            if ((event->mask & IN_ISDIR) != 0)
+            {
+                if ((event->mask & IN_MOVED_FROM) != 0)
+                {
+                    foldersMovedFrom[event->cookie] = file;
+                    continue;
+                }
+
+                auto from = foldersMovedFrom.find(event->cookie);
+
+                if ((event->mask & IN_MOVED_TO) != 0 && from != foldersMovedFrom.end())
+                {
+                    moveWatches(from->second, file);
+
+                    for (juce::File& written : changes.written)
+                    {
+                        if (written.isAChildOf(from->second))
+                        {
+                            written = getMovedFile(written, from->second, file);
+                        }
+                    }
+                    for (std::pair<juce::File, juce::File>& moved : changes.moved)
+                    {
+                        if (moved.second.isAChildOf(from->second))
+                        {
+                            moved.second = getMovedFile(moved.second, from->second, file);
+                        }
+                    }
+
+                    changes.movedFolders.push_back({ from->second, file });
+                    foldersMovedFrom.erase(from);
+                }
+                else if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+                {
+                    addWatch(inotify, file, true, &changes);
+                }
+                continue;
+            }
+
+            if (!isAudioFile(file))
+            {
+                continue;
+            }
+
+            if ((event->mask & IN_MOVED_FROM) != 0)
+            {
+                movedFrom[event->cookie] = file;
+            }
+            else if ((event->mask & IN_MOVED_TO) != 0)
+            {
+                auto from = movedFrom.find(event->cookie);
+
+                if (from != movedFrom.end())
+                {
+                    changes.moved.push_back({ from->second, file });
+                    movedFrom.erase(from);
+                }
+                else
+                {
+                    changes.written.push_back(file);
+                }
+            }
+            else if ((event->mask & IN_CLOSE_WRITE) != 0)
+            {
+                changes.written.push_back(file);
+            }
+            else if ((event->mask & IN_DELETE) != 0)
+            {
+                changes.removed.push_back(file);
+            }
+        }
+    }
+}
+#endif
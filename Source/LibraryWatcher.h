@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    LibraryWatcher.h
+    Created: 17 Oct 2026 3:29:51pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+#include "LibraryDatabase.h"
+#include "TrackMetadataStore.h"
+#include "AnalysisEngine.h"
+#include "FolderImporter.h"
+
+//==============================================================================
+//Keeps the library in step with the files on disk, in the background.
+//When it starts, it checks the size and modification time of every track against its library record,
+//  which only reads the directory entries and never opens a file. Changed tracks are probed and analysed
+//  again, and tracks whose file is gone from a folder that still exists are removed. A track whose folder
+//  is missing as well, eg. on a drive that is not plugged in, is kept.
+//After that it watches the folders of the library, and the imported folders with all their sub folders.
+//  On Linux inotify tells it straight away about audio files and folders that are written, deleted or moved,
+//  and a moved track keeps its record, cues and analysis.
+//  A folder moved out of the watched folders has its tracks removed.
+//  Elsewhere the tracks are checked again every pollSeconds and the folders are scanned for new files.
+//  A file that is gone and a new file with the same name, size and modification time are taken as a move.
+//The changes are handed to the message thread in batches, a short while after the last event, so a file
+//  being copied is only handled once it is complete.
+//It is used from the message thread, and every callback is called on the message thread
+class LibraryWatcher : private juce::Thread
+{
+public:
+    //Called with the tracks that were added to the library or moved, and with the ids of the tracks
+    //  that were removed from it or moved. A moved track is removed and added again with the same id
+    using TracksAddedCallback = std::function<void(const std::vector<FolderImporter::ImportedTrack>&)>;
+    using TracksRemovedCallback = std::function<void(const std::vector<juce::uint32>&)>;
+
+    //How long it waits after the last event before handing the changes over, in milliseconds
+    static constexpr int settleMilliseconds{ 500 };
+    //How often the tracks are checked again where inotify is not available, in seconds
+    static constexpr int pollSeconds{ 30 };
+
+    LibraryWatcher();
+    ~LibraryWatcher() override;
+
+    //Checking every track of the library and starting to watch its folders
+    void start(TracksAddedCallback onTracksAdded, TracksRemovedCallback onTracksRemoved);
+    //Watching a folder and its sub folders as well, eg. after it was imported.
+    //The folder is kept in the library, so it is watched again from the next start
+    void watchFolder(const juce::File& folder);
+
+private:
+    //What the watcher knows about a track file
+    struct WatchedFile
+    {
+        juce::String path;
+        juce::int64 fileSize{ 0 };
+        juce::int64 modificationTime{ 0 };
+    };
+
+    //The size and modification time of a file, read on the watcher thread. fileSize is -1 when the file is gone
+    struct FileStats
+    {
+        juce::int64 fileSize{ -1 };
+        juce::int64 modificationTime{ 0 };
+    };
+
+    //The changes handed to the message thread
+    struct Changes
+    {
+        //Files that were written or appeared, which may or may not be in the library
+        std::vector<juce::File> written;
+        std::vector<juce::File> removed;
+        //The old and new path of every moved file
+        std::vector<std::pair<juce::File, juce::File>> moved;
+        //The old and new path of every moved folder, and the folders moved out of the watched folders.
+        //They hold every track under them
+        std::vector<std::pair<juce::File, juce::File>> movedFolders;
+        std::vector<juce::File> removedFolders;
+        //The stats of every written file and of every file a move ended at, by path. They are read by post()
+        //  on the watcher thread, so apply() never touches the disk
+        std::map<juce::String, FileStats> stats;
+
+        bool isEmpty() const;
+    };
+
+    void run() override;
+
+    //Checking the size and modification time of every file in snapshot and looking for new files in
+    //  the folders, updating the snapshot with what was found
+    Changes reconcile();
+    //Adding the audio files of a folder whose path is not in known to newFiles and to known, and the ones
+    //  of its sub folders as well if recursive is true
+    void scanFolder(const juce::File& folder, bool recursive, std::set<juce::String>& known,
+                    std::vector<WatchedFile>& newFiles);
+    //Reading the stats of the files in changes and sending them to the message thread
+    void post(Changes changes);
+    //Applying changes to the library on the message thread
+    void apply(const Changes& changes);
+
+    //Returns true if a file is one the library can play
+    bool isAudioFile(const juce::File& file) const;
+    //Returns the ids of the tracks of the library in a folder or its sub folders
+    std::vector<juce::uint32> findTracksIn(const juce::File& folder) const;
+
+#if JUCE_LINUX
+    //Watching the folders of the snapshot and handing over the changes until the thread is stopped
+    void watch(int inotify);
+    //Adding an inotify watch for a folder, and for its sub folders if recursive is true.
+    //The audio files in a new folder are added to changes
+    void addWatch(int inotify, const juce::File& folder, bool recursive, Changes* changes);
+    //Reading the events that are waiting on the inotify descriptor. Files and folders that were moved
+    //  away are kept by cookie until the matching moved to event
+    void readEvents(int inotify, Changes& changes, std::map<juce::uint32, juce::File>& movedFrom,
+                    std::map<juce::uint32, juce::File>& foldersMovedFrom);
+    //Giving the watches of a moved folder and its sub folders their new path
+    void moveWatches(const juce::File& from, const juce::File& to);
+    //Removing the watches of a folder and its sub folders
+    void removeWatches(int inotify, const juce::File& folder);
+
+    //The folder of every inotify watch
+    std::map<int, juce::File> watches;
+#endif
+
+    //The tracks of the library when the watcher started. Only used on the watcher thread
+    std::vector<WatchedFile> snapshot;
+    //The folders given to watchFolder, waiting for the watcher thread
+    juce::CriticalSection folderLock;
+    std::vector<juce::File> newFolders;
+    //The imported folders of the library and the folders given to watchFolder, which are scanned and watched
+    //  with their sub folders. Only used on the watcher thread once it has started
+    std::vector<juce::File> scannedFolders;
+
+    //The extensions of the formats that can be read, like "wav;mp3;aiff"
+    juce::String extensions;
+
+    TracksAddedCallback tracksAddedCallback;
+    TracksRemovedCallback tracksRemovedCallback;
+    //Made on the message thread and copied by the watcher thread to post its changes
+    juce::WeakReference<LibraryWatcher> safeThis;
+
+    juce::SharedResourcePointer<LibraryDatabase> library;
+    juce::SharedResourcePointer<TrackMetadataStore> metadataStore;
+    juce::SharedResourcePointer<AnalysisEngine> analysisEngine;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(LibraryWatcher)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryWatcher)
+};
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyser.cpp
+    Created: 17 Oct 2026 3:27:28pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "LoudnessAnalyser.h"
+#include <cmath>
+
+//The K-weighting filters are the ones of BS.1770, worked out again for the sample rate of the track
+//  from their analogue frequencies, gains and Qs, so they match the published 48kHz coefficients
+LoudnessAnalyser::LoudnessAnalyser(double sampleRate, int _numChannels)
+    : numChannels(juce::jlimit(1, 2, _numChannels))
+{
+    const double pi{ 3.14159265358979323846 };
+
+    {
+        const double frequency{ 1681.974450955533 };
+        const double gain{ 3.999843853973347 };
+        const double q{ 0.7071752369554196 };
+
+        const double k{ std::tan(pi * frequency / sampleRate) };
+        const double vh{ std::pow(10.0, gain / 20.0) };
+        const double vb{ std::pow(vh, 0.4996667741545416) };
+        const double a0{ 1.0 + k / q + k * k };
+
+        Biquad filter;
+        filter.b0 = (vh + vb * k / q + k * k) / a0;
+        filter.b1 = 2.0 * (k * k - vh) / a0;
+        filter.b2 = (vh - vb * k / q + k * k) / a0;
+        filter.a1 = 2.0 * (k * k - 1.0) / a0;
+        filter.a2 = (1.0 - k / q + k * k) / a0;
+
+        shelf[0] = shelf[1] = filter;
+    }
+
+    {
+        const double frequency{ 38.13547087602444 };
+        const double q{ 0.5003270373238773 };
+
+        const double k{ std::tan(pi * frequency / sampleRate) };
+        const double a0{ 1.0 + k / q + k * k };
+
+        Biquad filter;
+        filter.b0 = 1.0;
+        filter.b1 = -2.0;
+        filter.b2 = 1.0;
+        filter.a1 = 2.0 * (k * k - 1.0) / a0;
+        filter.a2 = (1.0 - k / q + k * k) / a0;
+
+        highPass[0] = highPass[1] = filter;
+    }
+
+    stepSize = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+
+    //A windowed sinc low pass at the original half sample rate. Every phase is scaled to a gain of 1
+    const int numTaps{ numPhases * tapsPerPhase };
+    const double centre{ (numTaps - 1) * 0.5 };
+
+    for (int phase = 0; phase < numPhases; ++phase)
+    {
+        double phaseSum{ 0.0 };
+        double taps[tapsPerPhase]{};
+
+        for (int k = 0; k < tapsPerPhase; ++k)
+        {
+            const int n{ numPhases * k + phase };
+            const double x{ (n - centre) / numPhases };
+            const double sinc{ std::abs(x) < 1.0e-9 ? 1.0 : std::sin(pi * x) / (pi * x) };
+            const double window{ 0.42 - 0.5 * std::cos(2.0 * pi * (n + 0.5) / numTaps) + 0.08 * std::cos(4.0 * pi * (n + 0.5) / numTaps) };
+
+            taps[k] = sinc * window;
+            phaseSum += taps[k];
+        }
+
+        //The oldest sample is multiplied by the last tap
+        for (int k = 0; k < tapsPerPhase; ++k)
+        {
+            phaseCoefficients[phase][tapsPerPhase - 1 - k] = (float)(taps[k] / phaseSum);
+        }
+    }
+}
+
+LoudnessAnalyser::~LoudnessAnalyser()
+{
+
+}
+
+double LoudnessAnalyser::Biquad::process(double x)
+{
+    const double y{ b0 * x + z1 };
+    z1 = b1 * x - a1 * y + z2;
+    z2 = b2 * x - a2 * y;
+    return y;
+}
+
+//==============================================================================
+void LoudnessAnalyser::process(const float* const* channels, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float sample{ channels[channel][i] };
+
+            const double weighted{ highPass[channel].process(shelf[channel].process(sample)) };
+            stepSum += weighted * weighted;
+
+            float* h{ history[channel] };
+            h[historyPosition] = sample;
+            h[historyPosition + tapsPerPhase] = sample;
+
+            //The newest tapsPerPhase samples, oldest first
+            const float* recent{ h + historyPosition + 1 };
+            peak = juce::jmax(peak, std::abs(sample));
+
+            for (int phase = 0; phase < numPhases; ++phase)
+            {
+                const float* coefficients{ phaseCoefficients[phase] };
+                float sum{ 0.0f };
+
+                for (int k = 0; k < tapsPerPhase; ++k)
+                {
+                    sum += coefficients[k] * recent[k];
+                }
+                peak = juce::jmax(peak, std::abs(sum));
+            }
+        }
+
+        historyPosition = (historyPosition + 1) % tapsPerPhase;
+
+        if (++samplesInStep == stepSize)
+        {
+            stepSums[numSteps % 4] = stepSum;
+            ++numSteps;
+            samplesInStep = 0;
+            stepSum = 0.0;
+
+            if (numSteps >= 4)
+            {
+                const double blockSum{ (stepSums[0] + stepSums[1]) + (stepSums[2] + stepSums[3]) };
+                blockPowers.push_back(blockSum / (4.0 * stepSize));
+            }
+        }
+    }
+}
+
+//The relative gate is worked out from the blocks that passed the absolute gate
+bool LoudnessAnalyser::finish()
+{
+    const double absoluteGate{ std::pow(10.0, (-70.0 + 0.691) / 10.0) };
+
+    double sum{ 0.0 };
+    int count{ 0 };
+    for (double power : blockPowers)
+    {
+        if (power > absoluteGate)
+        {
+            sum += power;
+            ++count;
+        }
+    }
+
+    truePeak = peak > 0.0f ? (float)(20.0 * std::log10(peak)) : -70.0f;
+    integratedLoudness = -70.0f;
+
+    if (count == 0)
+    {
+        return false;
+    }
+
+    const double relativeGate{ 0.1 * sum / count };
+
+    double gatedSum{ 0.0 };
+    int gatedCount{ 0 };
+    for (double power : blockPowers)
+    {
+        if (power > absoluteGate && power > relativeGate)
+        {
+            gatedSum += power;
+            ++gatedCount;
+        }
+    }
+
+    integratedLoudness = (float)powerToLoudness(gatedSum / gatedCount);
+    return true;
+}
+
+float LoudnessAnalyser::getIntegratedLoudness() const
+{
+    return integratedLoudness;
+}
+
+float LoudnessAnalyser::getTruePeak() const
+{
+    return truePeak;
+}
+
+//A quiet track is only raised as far as its peaks allow, a loud one is always brought down to the target
+float LoudnessAnalyser::getAutoGain(float loudness, float peak)
+{
+    float gain{ targetLoudness - loudness };
+
+    if (gain > 0.0f)
+    {
+        gain = juce::jmin(gain, juce::jmax(0.0f, maxTruePeak - peak));
+    }
+    return juce::jlimit(-maxAutoGain, maxAutoGain, gain);
+}
+
+double LoudnessAnalyser::powerToLoudness(double power)
+{
+    return -0.691 + 10.0 * std::log10(juce::jmax(power, 1.0e-20));
+}
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    LoudnessAnalyser.h
+    Created: 17 Oct 2026 3:27:28pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+//==============================================================================
+//Measures the integrated loudness and the true peak of a track as EBU R128 (ITU-R BS.1770) defines them,
+//  from its audio fed in blocks of any size.
+//Every channel is K-weighted by 2 biquad filters, a high shelf and a high pass, and the mean square is
+//  summed over blocks of 400 ms that overlap by 75%. Only the power of each block is kept, 10 per second.
+//When the track is finished the blocks are gated, first at -70 LUFS and then at 10 LU below the loudness
+//  of what is left, and the loudness of the blocks that pass both gates is the integrated loudness.
+//The true peak is the highest sample of the audio upsampled 4 times with a polyphase FIR filter,
+//  so peaks between the samples are found
+class LoudnessAnalyser
+{
+public:
+    //The loudness tracks are brought to by the auto gain, and the highest true peak it lets through
+    static constexpr float targetLoudness{ -14.0f };
+    static constexpr float maxTruePeak{ -1.0f };
+    //The auto gain is never more than this many decibels up or down
+    static constexpr float maxAutoGain{ 12.0f };
+
+    //Only the first 2 channels are measured
+    LoudnessAnalyser(double sampleRate, int numChannels);
+    ~LoudnessAnalyser();
+
+    //Adding the next block of audio, one pointer per channel
+    void process(const float* const* channels, int numSamples);
+
+    //Working out the integrated loudness from everything that was fed. Returns false if the track was
+    //  shorter than a block or silent
+    bool finish();
+
+    //The results of finish(), in LUFS and dBTP
+    float getIntegratedLoudness() const;
+    float getTruePeak() const;
+
+    //The gain in decibels that brings a track to targetLoudness without pushing its true peak above maxTruePeak
+    static float getAutoGain(float integratedLoudness, float truePeak);
+
+private:
+    //A biquad filter in the transposed direct form II, run in double so the 38Hz high pass stays accurate
+    struct Biquad
+    {
+        double b0{ 1.0 }, b1{ 0.0 }, b2{ 0.0 }, a1{ 0.0 }, a2{ 0.0 };
+        double z1{ 0.0 }, z2{ 0.0 };
+
+        double process(double x);
+    };
+
+    //The number of taps of every phase of the true peak filter, and the number of phases
+    static constexpr int tapsPerPhase{ 12 };
+    static constexpr int numPhases{ 4 };
+
+    //The loudness of a mean square power, in LUFS
+    static double powerToLoudness(double power);
+
+    int numChannels;
+
+    //The 2 K-weighting filters of every channel
+    Biquad shelf[2];
+    Biquad highPass[2];
+
+    //Blocks are made of 4 steps of 100 ms. The sums of the last 4 steps are kept to make the next block
+    int stepSize{ 0 };
+    int samplesInStep{ 0 };
+    double stepSum{ 0.0 };
+    double stepSums[4]{};
+    int numSteps{ 0 };
+    std::vector<double> blockPowers;
+
+    //The coefficients of every phase of the true peak filter, oldest sample first, and the last samples
+    //  of every channel. The history is stored twice in a row, so the newest tapsPerPhase samples can
+    //  always be read without wrapping around
+    float phaseCoefficients[numPhases][tapsPerPhase]{};
+    float history[2][2 * tapsPerPhase]{};
+    int historyPosition{ 0 };
+    float peak{ 0.0f };
+
+    float integratedLoudness{ -70.0f };
+    float truePeak{ -70.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessAnalyser)
+};
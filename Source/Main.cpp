@@ -8,6 +8,8 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "MixerBenchmark.h"
+#include <iostream>
 
 //==============================================================================
 class OtoDecks_V2Application  : public juce::JUCEApplication
@@ -25,6 +27,31 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
+        //Running the mixer micro-benchmark instead of the app when asked for on the command line
+        if (commandLine.contains ("--benchmark-mixer"))
+        {
+            std::cout << MixerBenchmark::run() << std::endl;
+            quit();
+            return;
+        }
+
+        //Running the unit tests instead of the app, the exit code is 1 if any of them failed
+        if (commandLine.contains ("--run-tests"))
+        {
+            juce::UnitTestRunner runner;
+            runner.runAllTests();
+
+            int failures{ 0 };
+            for (int i = 0; i < runner.getNumResults(); ++i)
+            {
+                failures += runner.getResult (i)->failures;
+            }
+
+            setApplicationReturnValue (failures > 0 ? 1 : 0);
+            quit();
+            return;
+        }
+
         mainWindow.reset (new MainWindow (getApplicationName()));
     }
 
@@ -5,7 +5,33 @@ MainComponent::MainComponent()
 {
     // Make sure you set the size of the component after
     // you add any child components.
-    setSize (800, 700);
+    setSize (800, 785);
+
+    //The players are added to the mixer before the audio device starts,
+    //player 1 on the left of the crossfader and player 2 on the right
+    deck1Channel = mixer.addInput(&player1, MixerEngine::CrossfaderSide::left);
+    deck2Channel = mixer.addInput(&player2, MixerEngine::CrossfaderSide::right);
+    mixer.setHeadroomDecibels(defaultHeadroomDecibels);
+
+    //The gain slider of each deck is the fader of its channel
+    deck1.onGainChanged = [this](float gain) { mixer.setChannelGain(deck1Channel, gain); };
+    deck2.onGainChanged = [this](float gain) { mixer.setChannelGain(deck2Channel, gain); };
+
+    //The monitor times each deck through the mixer, and shows the read-ahead underruns and the key-lock
+    //  cost of each deck and the decoding the shared decode passes saved
+    mixer.setPerformanceMonitor(&monitor);
+    monitor.setSectionName(0, "Deck 1");
+    monitor.setSectionName(1, "Deck 2");
+    monitor.setSectionName(MixerEngine::mixSection, "Mixer");
+    monitor.addCounter("Deck 1 read-ahead underruns", player1.getReadAheadStats().underruns);
+    monitor.addCounter("Deck 2 read-ahead underruns", player2.getReadAheadStats().underruns);
+    monitor.addCounter("Deck 1 key-lock load %", player1.getKeyLockCpuLoad(), 100.0);
+    monitor.addCounter("Deck 2 key-lock load %", player2.getKeyLockCpuLoad(), 100.0);
+    monitor.addCounter("Deck 1 key-lock peak us", player1.getKeyLockPeakMicroseconds());
+    monitor.addCounter("Deck 2 key-lock peak us", player2.getKeyLockPeakMicroseconds());
+    monitor.addCounter("Decode passes shared", trackLoader->getDecodeStats().passes);
+    monitor.addCounter("Decode time saved on the last load (ms)", trackLoader->getDecodeStats().lastMillisecondsSaved);
+    monitor.addCounter("Decode time saved in total (ms)", trackLoader->getDecodeStats().millisecondsSaved);
 
     DBG("Height of title is: " << getHeight() / 5);
 
@@ -30,6 +56,43 @@ MainComponent::MainComponent()
     addAndMakeVisible(title_d2);
     addAndMakeVisible(waveformDisplay1);
     addAndMakeVisible(waveformDisplay2);
+    addAndMakeVisible(nearWaveform1);
+    addAndMakeVisible(nearWaveform2);
+    addAndMakeVisible(crossfader);
+    addAndMakeVisible(crossfaderCurve);
+    addAndMakeVisible(headroom);
+    addAndMakeVisible(statsButton);
+    //The overlay sits on top of everything and is hidden until the stats button is clicked
+    addChildComponent(statsOverlay);
+
+    statsButton.setClickingTogglesState(true);
+    statsButton.setColour(juce::TextButton::buttonColourId, juce::Colours::darkslategrey);
+    statsButton.setColour(juce::TextButton::buttonOnColourId, juce::Colours::darkorange);
+    statsButton.addListener(this);
+
+    //The crossfader starts in the middle, where both decks play at full level
+    crossfader.setRange(0.0, 1.0);
+    crossfader.setValue(0.5, juce::dontSendNotification);
+    crossfader.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    crossfader.setColour(juce::Slider::thumbColourId, juce::Colours::darkorange);
+    crossfader.setColour(juce::Slider::trackColourId, juce::Colours::lightseagreen);
+    crossfader.addListener(this);
+
+    //The ids of the curves are their MixerEngine::CrossfaderCurve plus 1, since 0 is no selection
+    crossfaderCurve.addItem("Linear", (int)MixerEngine::CrossfaderCurve::linear + 1);
+    crossfaderCurve.addItem("Constant power", (int)MixerEngine::CrossfaderCurve::constantPower + 1);
+    crossfaderCurve.addItem("Sharp", (int)MixerEngine::CrossfaderCurve::sharp + 1);
+    crossfaderCurve.setSelectedId((int)MixerEngine::CrossfaderCurve::linear + 1, juce::dontSendNotification);
+    crossfaderCurve.addListener(this);
+
+    //The ids of the headroom settings are their decibels plus 1
+    headroom.addItem("0 dB headroom", 1);
+    headroom.addItem("3 dB headroom", 4);
+    headroom.addItem("6 dB headroom", 7);
+    headroom.addItem("9 dB headroom", 10);
+    headroom.addItem("12 dB headroom", 13);
+    headroom.setSelectedId((int)defaultHeadroomDecibels + 1, juce::dontSendNotification);
+    headroom.addListener(this);
 
     //This lets the format manager register and learn about the formats eg. mp3 wav etc
     //without it, it will not load any file
@@ -43,32 +106,39 @@ MainComponent::~MainComponent()
 }
 
 //==============================================================================
-//Preparing the players and the mixersource to play 
+//Preparing the mixer to play, which prepares both players
 void MainComponent::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
     // This function will be called when the audio device is started, or when
     // its settings (i.e. sample rate, block size, etc) are changed.
     
-    player1.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    player2.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    //The monitor counts the xruns reported by the device
+    juce::AudioIODevice* device{ deviceManager.getCurrentAudioDevice() };
+    monitor.prepare(samplesPerBlockExpected, sampleRate, device);
 
-    mixerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    mixerSource.addInputSource(&player1, false);
-    mixerSource.addInputSource(&player2, false);    
+    //The mixer adds every output channel of the decks, not only the first 2
+    if (device != nullptr)
+    {
+        mixer.setNumOutputChannels(device->getActiveOutputChannels().countNumberOfSetBits());
+    }
+    mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
 }
 
 //Getting the next audio block from the buffer to play
+//The whole callback is timed against the time the block lasts
 void MainComponent::getNextAudioBlock (const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    mixerSource.getNextAudioBlock(bufferToFill);    
+    const juce::int64 startTicks{ juce::Time::getHighResolutionTicks() };
+
+    mixer.getNextAudioBlock(bufferToFill);    
+
+    monitor.callbackFinished(startTicks, bufferToFill.numSamples);
 }
 
-//Releasing any resource used by player1, player 2 and MixerSource
+//Releasing any resource used by the mixer and both players
 void MainComponent::releaseResources()
 {
-    player1.releaseResources();
-    player2.releaseResources();
-    mixerSource.releaseResources();
+    mixer.releaseResources();
 }
 
 //==============================================================================
@@ -88,11 +158,54 @@ void MainComponent::resized()
 
     title_d1.setBounds(0, 0, getWidth() / 2, 100);
     title_d2.setBounds(getWidth() / 2,0, getWidth() / 2, 100);
-    deck1.setBounds(0, getHeight()/14+50, getWidth()/2, 250);
-    deck2.setBounds(getWidth()/2, getHeight() / 14+50, getWidth()/2, 250);
-    waveformDisplay1.setBounds(0, 350, getWidth() / 2, 100);
-    waveformDisplay2.setBounds(getWidth()/2, 350, getWidth() / 2, 100);
-    playlist1.setBounds(0, 450, getWidth(), 275);   
+    //The decks sit right under the titles and are tall enough for the hot cue row
+    deck1.setBounds(0, 100, getWidth()/2, 275);
+    deck2.setBounds(getWidth()/2, 100, getWidth()/2, 275);
+    //The zoomed in waveforms sit over the waveforms of the whole tracks
+    nearWaveform1.setBounds(0, 375, getWidth() / 2, 80);
+    nearWaveform2.setBounds(getWidth() / 2, 375, getWidth() / 2, 80);
+    waveformDisplay1.setBounds(0, 455, getWidth() / 2, 80);
+    waveformDisplay2.setBounds(getWidth()/2, 455, getWidth() / 2, 80);
+    crossfaderCurve.setBounds(0, 535, getWidth() / 8, 30);
+    headroom.setBounds(getWidth() / 8, 535, getWidth() / 8, 30);
+    crossfader.setBounds(getWidth() / 4, 535, getWidth() / 2, 30);
+    playlist1.setBounds(0, 565, getWidth(), getHeight() - 565);   
+    statsButton.setBounds(getWidth() - 70, 535, 70, 30);
+    //The overlay opens upwards from the stats button and is as tall as its lines and histogram need
+    const int overlayHeight{ juce::jmin(statsOverlay.getPreferredHeight(), 535) };
+    statsOverlay.setBounds(getWidth() - 320, 535 - overlayHeight, 320, overlayHeight);
+}
+
+//Moving the crossfader of the mixer whenever the crossfader slider moves
+void MainComponent::sliderValueChanged(juce::Slider* slider)
+{
+    if (slider == &crossfader)
+    {
+        mixer.setCrossfader((float)slider->getValue());
+    }
+}
+
+//Showing or hiding the performance overlay
+void MainComponent::buttonClicked(juce::Button* button)
+{
+    if (button == &statsButton)
+    {
+        statsOverlay.setVisible(statsButton.getToggleState());
+    }
+}
+
+//Changing the crossfader curve or the headroom of the mixer
+void MainComponent::comboBoxChanged(juce::ComboBox* comboBox)
+{
+    if (comboBox == &crossfaderCurve)
+    {
+        mixer.setCrossfaderCurve((MixerEngine::CrossfaderCurve)(crossfaderCurve.getSelectedId() - 1));
+    }
+
+    if (comboBox == &headroom)
+    {
+        mixer.setHeadroomDecibels((float)(headroom.getSelectedId() - 1));
+    }
 }
 
 
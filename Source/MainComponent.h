@@ -5,13 +5,20 @@
 #include "AudioPlayer.h"
 #include "PlaylistComponent.h"
 #include "TrackTitle.h"
+#include "MixerEngine.h"
+#include "AudioPerformanceMonitor.h"
+#include "PerformanceOverlay.h"
+#include "NearWaveformDisplay.h"
 
 //==============================================================================
 /*
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent : public juce::AudioAppComponent                      
+class MainComponent : public juce::AudioAppComponent,
+                      public juce::Slider::Listener,
+                      public juce::Button::Listener,
+                      public juce::ComboBox::Listener
 {
 public:
     //==============================================================================
@@ -27,6 +34,15 @@ public:
     void paint (juce::Graphics& g) override;
     void resized() override; 
 
+    //Implement a slider listener for the crossfader
+    void sliderValueChanged(juce::Slider* slider) override;
+
+    //Implement a button listener for the stats button
+    void buttonClicked(juce::Button* button) override;
+
+    //Implement a combo box listener for the crossfader curve and the headroom
+    void comboBoxChanged(juce::ComboBox* comboBox) override;
+
 private:
     //==============================================================================
     // Your private member variables go here...
@@ -34,13 +50,6 @@ private:
     //An audioFormatManager object that is able to read the formats of file
     juce::AudioFormatManager formatManager;  
 
-    //An audioThumbnailCache object used by the waveform display
-    juce::AudioThumbnailCache thumbCache{ 100 };
-
-    //A temporary audio player. It is used mainly by the playlist component
-    //  to be able to calculate the time of each track in the playlist
-    AudioPlayer tmp_player{ formatManager };
-
     // Initialization of a player and the Deck that goes with it
     AudioPlayer player1{ formatManager };
     DeckGUI deck1{&player1, &playlist1, &title_d1, &waveformDisplay1};
@@ -54,21 +63,45 @@ private:
     TrackTitle title_d2;    
 
     //2 WaveformDisplays that work together with the playlist component and deckGUI
-    WaveformDisplay waveformDisplay1{formatManager, thumbCache};
-    WaveformDisplay waveformDisplay2{ formatManager, thumbCache };
+    WaveformDisplay waveformDisplay1;
+    WaveformDisplay waveformDisplay2;
 
-    //A playlist component initialized with both players, the temporary player, 2 waveform displays
+    //2 zoomed in waveforms that scroll with the playhead of each player
+    NearWaveformDisplay nearWaveform1{ &player1 };
+    NearWaveformDisplay nearWaveform2{ &player2 };
+
+    //A playlist component initialized with both players, 2 waveform displays
     //  and 2 track titles as parameters
     PlaylistComponent playlist1{&player1, 
                                     &player2, 
-                                    &tmp_player, 
                                     &waveformDisplay1, 
                                     &waveformDisplay2, 
                                     &title_d1, 
                                     &title_d2};
 
-    //The mixerAudioSource object needed to be able to play 2 tracks at the same time
-    juce::MixerAudioSource mixerSource;
+    //The mixer that sums both players through the crossfader into the output
+    MixerEngine mixer;
+
+    //The channels of the mixer the players are in
+    int deck1Channel{ -1 };
+    int deck2Channel{ -1 };
+
+    //The crossfader between deck 1 (left) and deck 2 (right)
+    juce::Slider crossfader;
+    //The shape of the crossfader curve and the headroom of the master output
+    juce::ComboBox crossfaderCurve;
+    juce::ComboBox headroom;
+    //The headroom the master output leaves by default, enough for both decks at full level
+    static constexpr float defaultHeadroomDecibels{ 6.0f };
+
+    //The loader shared by the players, kept here for the counters of its decode passes, which the monitor shows
+    juce::SharedResourcePointer<TrackLoader> trackLoader;
+
+    //Times the audio callback, each deck and the mixer
+    AudioPerformanceMonitor monitor;
+    //The panel showing the figures of the monitor, and the button that shows and hides it
+    PerformanceOverlay statsOverlay{ monitor };
+    juce::TextButton statsButton{ "Stats" };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
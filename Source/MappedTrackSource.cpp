@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    MappedTrackSource.cpp
+    Created: 17 Oct 2026 2:35:51pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "MappedTrackSource.h"
+
+//The readerSource does not own the reader, it is owned by this class
+MappedTrackSource::MappedTrackSource(juce::MemoryMappedAudioFormatReader* _reader)
+    : reader(_reader),
+      readerSource(_reader, false)
+{
+    const juce::int64 bytesPerFrame{ juce::jmax((juce::int64)1, (juce::int64)(reader->numChannels * reader->bitsPerSample / 8)) };
+    samplesPerPage = juce::jmax((juce::int64)1, (juce::int64)4096 / bytesPerFrame);
+
+    diskThread->addTimeSliceClient(this);
+}
+
+MappedTrackSource::~MappedTrackSource()
+{
+    //Waits for the DiskIOThread to finish with this source if it is using it right now
+    diskThread->removeTimeSliceClient(this);
+}
+
+//Looking for a format that can map the file, eg. WAV and AIFF, and mapping the whole file
+std::unique_ptr<MappedTrackSource> MappedTrackSource::createFor(juce::AudioFormatManager& formatManager, const juce::File& file)
+{
+    juce::AudioFormat* format{ formatManager.findFormatForFileExtension(file.getFileExtension()) };
+
+    if (format == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader{ format->createMemoryMappedReader(file) };
+
+    if (mappedReader == nullptr || !mappedReader->mapEntireFile())
+    {
+        return nullptr;
+    }
+
+    return std::make_unique<MappedTrackSource>(mappedReader.release());
+}
+
+//==============================================================================
+void MappedTrackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    readerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+//Copying the samples from the mapped pages and letting the prefetch know where the playhead is
+void MappedTrackSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    readerSource.getNextAudioBlock(bufferToFill);
+    playhead = readerSource.getNextReadPosition();
+}
+
+void MappedTrackSource::releaseResources()
+{
+    readerSource.releaseResources();
+}
+
+//==============================================================================
+void MappedTrackSource::setNextReadPosition(juce::int64 newPosition)
+{
+    readerSource.setNextReadPosition(newPosition);
+    playhead = newPosition;
+}
+
+juce::int64 MappedTrackSource::getNextReadPosition() const
+{
+    return readerSource.getNextReadPosition();
+}
+
+juce::int64 MappedTrackSource::getTotalLength() const
+{
+    return readerSource.getTotalLength();
+}
+
+bool MappedTrackSource::isLooping() const
+{
+    return readerSource.isLooping();
+}
+
+void MappedTrackSource::setLooping(bool shouldLoop)
+{
+    readerSource.setLooping(shouldLoop);
+}
+
+double MappedTrackSource::getSampleRate() const
+{
+    return reader->sampleRate;
+}
+
+int MappedTrackSource::getNumChannels() const
+{
+    return (int)reader->numChannels;
+}
+
+//==============================================================================
+//Touching one sample in every page between the playhead and the prefetch window,
+//so that the pages are faulted in here rather than on the audio thread
+int MappedTrackSource::useTimeSlice()
+{
+    const juce::int64 current{ playhead };
+    const juce::int64 windowEnd{ juce::jmin(reader->lengthInSamples,
+        current + (juce::int64)(reader->sampleRate * prefetchSeconds)) };
+
+    //After a seek the prefetch starts again from the new playhead
+    if (prefetchedUpTo < current || prefetchedUpTo > windowEnd + samplesPerPage)
+    {
+        prefetchedUpTo = current;
+    }
+
+    for (; prefetchedUpTo < windowEnd; prefetchedUpTo += samplesPerPage)
+    {
+        reader->touchSample(prefetchedUpTo);
+    }
+
+    //Checking again in 20ms, well within the prefetch window
+    return 20;
+}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    MappedTrackSource.h
+    Created: 17 Oct 2026 2:35:51pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include "DiskIOThread.h"
+
+//==============================================================================
+//A PositionableAudioSource that plays an uncompressed file (WAV or AIFF) straight from a memory-mapped view of it.
+//The audio thread only copies samples out of the mapped pages, and the DiskIOThread touches
+//  the pages ahead of the playhead so that they are already in memory when they are needed
+class MappedTrackSource : public juce::PositionableAudioSource,
+                          private juce::TimeSliceClient
+{
+public:
+    //Takes ownership of a reader that has already mapped the file
+    MappedTrackSource(juce::MemoryMappedAudioFormatReader* _reader);
+    ~MappedTrackSource() override;
+
+    //Tries to open a file with a memory-mapped reader. Returns nullptr if the format of the file
+    //  does not support memory mapping (eg. compressed formats) or the file could not be mapped
+    static std::unique_ptr<MappedTrackSource> createFor(juce::AudioFormatManager& formatManager, const juce::File& file);
+
+    //The 3 functions that need to be implemented since we inherit from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //The functions that need to be implemented since we inherit from PositionableAudioSource
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+    //The sample rate and number of channels of the mapped file
+    double getSampleRate() const;
+    int getNumChannels() const;
+
+    //The number of seconds of audio touched ahead of the playhead
+    static constexpr double prefetchSeconds{ 2.0 };
+
+private:
+    //Called on the DiskIOThread to touch the pages ahead of the playhead
+    int useTimeSlice() override;
+
+    //The reader that owns the mapped view of the file
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader;
+    //The source that reads from the mapped reader
+    juce::AudioFormatReaderSource readerSource;
+
+    //The playhead as last seen by the audio thread, read by the prefetch
+    std::atomic<juce::int64> playhead{ 0 };
+    //The last sample touched by the prefetch, only used on the DiskIOThread
+    juce::int64 prefetchedUpTo{ 0 };
+    //The number of samples in one page of memory
+    juce::int64 samplesPerPage{ 1024 };
+
+    juce::SharedResourcePointer<DiskIOThread> diskThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MappedTrackSource)
+};
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    MixerBenchmark.cpp
+    Created: 17 Oct 2026 2:44:43pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "MixerBenchmark.h"
+#include "MixerEngine.h"
+#include <memory>
+#include <vector>
+
+namespace
+{
+    //A deck stand-in that costs as little as possible, so that only the mixing is measured
+    class ConstantSource : public juce::AudioSource
+    {
+    public:
+        void prepareToPlay(int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override
+        {
+            for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch)
+            {
+                juce::FloatVectorOperations::fill(bufferToFill.buffer->getWritePointer(ch, bufferToFill.startSample),
+                    0.1f,
+                    bufferToFill.numSamples);
+            }
+        }
+    };
+
+    //Runs a source for a number of blocks and returns the average time of one block in microseconds
+    double timeBlocks(juce::AudioSource& source, int blockSize, int numBlocks)
+    {
+        juce::AudioBuffer<float> output{ 2, blockSize };
+        juce::AudioSourceChannelInfo info{ &output, 0, blockSize };
+
+        //A few blocks to warm up the caches before timing
+        for (int i = 0; i < 100; ++i)
+        {
+            source.getNextAudioBlock(info);
+        }
+
+        const juce::int64 start{ juce::Time::getHighResolutionTicks() };
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            source.getNextAudioBlock(info);
+        }
+
+        const double seconds{ juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) };
+
+        return seconds * 1.0e6 / numBlocks;
+    }
+}
+
+//Timing both mixers with the same number of identical inputs
+juce::String MixerBenchmark::run(int blockSize, int numBlocks)
+{
+    const double sampleRate{ 44100.0 };
+    juce::String results;
+
+    results << "Mixer cost per block of " << blockSize << " samples (microseconds)\n";
+    results << "decks   MixerAudioSource   MixerEngine   speed-up\n";
+
+    for (int numDecks : { 2, 4, 8 })
+    {
+        std::vector<std::unique_ptr<ConstantSource>> inputs;
+        for (int i = 0; i < numDecks; ++i)
+        {
+            inputs.push_back(std::make_unique<ConstantSource>());
+        }
+
+        juce::MixerAudioSource juceMixer;
+        MixerEngine engine;
+
+        for (int i = 0; i < numDecks; ++i)
+        {
+            juceMixer.addInputSource(inputs[i].get(), false);
+            engine.addInput(inputs[i].get(), i % 2 == 0 ? MixerEngine::CrossfaderSide::left
+                                                          : MixerEngine::CrossfaderSide::right);
+        }
+
+        juceMixer.prepareToPlay(blockSize, sampleRate);
+        engine.prepareToPlay(blockSize, sampleRate);
+
+        const double juceTime{ timeBlocks(juceMixer, blockSize, numBlocks) };
+        const double engineTime{ timeBlocks(engine, blockSize, numBlocks) };
+
+        juceMixer.removeAllInputs();
+        engine.releaseResources();
+
+        results << juce::String(numDecks).paddedRight(' ', 8)
+                << juce::String(juceTime, 3).paddedRight(' ', 19)
+                << juce::String(engineTime, 3).paddedRight(' ', 14)
+                << juce::String(engineTime > 0.0 ? juceTime / engineTime : 0.0, 2) << "x\n";
+    }
+
+    return results;
+}
@@ -0,0 +1,23 @@
+/*
+  ==============================================================================
+
+    MixerBenchmark.h
+    Created: 17 Oct 2026 2:44:43pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+//A micro-benchmark that measures the cost of one audio block in the MixerEngine
+//  compared with juce::MixerAudioSource, for 2, 4 and 8 decks.
+//It is run from the command line with --benchmark-mixer
+namespace MixerBenchmark
+{
+    //Runs the benchmark and returns a table of the results, one row per number of decks
+    juce::String run(int blockSize = 512, int numBlocks = 20000);
+}
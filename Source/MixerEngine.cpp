@@ -0,0 +1,285 @@
+/*
+  ==============================================================================
+
+    MixerEngine.cpp
+    Created: 17 Oct 2026 2:45:04pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "MixerEngine.h"
+
+MixerEngine::MixerEngine()
+{
+
+}
+
+MixerEngine::~MixerEngine()
+{
+
+}
+
+//==============================================================================
+//The input is stored in the next free slot before the channel count is published,
+//so the audio thread never sees a channel without its input
+int MixerEngine::addInput(juce::AudioSource* input, CrossfaderSide side)
+{
+    const int index{ numChannels.load() };
+
+    if (input == nullptr || index >= maxChannels)
+    {
+        DBG("MixerEngine::addInput the mixer is full");
+        return -1;
+    }
+
+    channels[index].input = input;
+    channels[index].side = (int)side;
+    numChannels.store(index + 1);
+
+    return index;
+}
+
+int MixerEngine::getNumChannels() const
+{
+    return numChannels;
+}
+
+void MixerEngine::setPerformanceMonitor(AudioPerformanceMonitor* newMonitor)
+{
+    monitor = newMonitor;
+}
+
+void MixerEngine::setChannelGain(int channel, float gain)
+{
+    if (channel < 0 || channel >= numChannels)
+    {
+        DBG("MixerEngine::setChannelGain channel out of range");
+        return;
+    }
+
+    channels[channel].gain = juce::jlimit(0.0f, 1.0f, gain);
+}
+
+void MixerEngine::setChannelSide(int channel, CrossfaderSide side)
+{
+    if (channel < 0 || channel >= numChannels)
+    {
+        DBG("MixerEngine::setChannelSide channel out of range");
+        return;
+    }
+
+    channels[channel].side = (int)side;
+}
+
+void MixerEngine::setCrossfader(float position)
+{
+    crossfader = juce::jlimit(0.0f, 1.0f, position);
+}
+
+void MixerEngine::setCrossfaderCurve(CrossfaderCurve curve)
+{
+    crossfaderCurve = (int)curve;
+}
+
+void MixerEngine::setHeadroomDecibels(float decibels)
+{
+    masterGain = juce::Decibels::decibelsToGain(-juce::jmax(0.0f, decibels));
+}
+
+//==============================================================================
+void MixerEngine::setNumOutputChannels(int numOutputChannels)
+{
+    numScratchChannels = juce::jmax(1, numOutputChannels);
+}
+
+//Preparing every input and allocating the scratch buffer once, outside the audio callback
+void MixerEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    scratch.setSize(numScratchChannels, juce::jmax(1, samplesPerBlockExpected));
+
+    float leftGain, rightGain;
+    getCrossfaderGains(crossfader, (CrossfaderCurve)crossfaderCurve.load(), leftGain, rightGain);
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        channels[i].input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        channels[i].lastGain = getTargetGain(i, leftGain, rightGain, masterGain);
+    }
+}
+
+//Mixing the block in chunks that fit in the scratch buffer, in case the device
+//sends a bigger block than it said it would.
+//Before prepareToPlay or after releaseResources there is no scratch buffer, and the output is silence.
+//The time the mixing itself takes is the whole block minus the time spent in the inputs
+void MixerEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const juce::int64 startTicks{ monitor != nullptr ? juce::Time::getHighResolutionTicks() : 0 };
+    inputTicks = 0;
+
+    if (scratch.getNumSamples() == 0)
+    {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    int done{ 0 };
+
+    while (done < bufferToFill.numSamples)
+    {
+        const int chunk{ juce::jmin(bufferToFill.numSamples - done, scratch.getNumSamples()) };
+        mixChunk(*bufferToFill.buffer, bufferToFill.startSample + done, chunk);
+        done += chunk;
+    }
+
+    if (monitor != nullptr)
+    {
+        monitor->addSectionTicks(mixSection, juce::Time::getHighResolutionTicks() - startTicks - inputTicks);
+    }
+}
+
+void MixerEngine::releaseResources()
+{
+    for (int i = 0; i < numChannels; ++i)
+    {
+        channels[i].input->releaseResources();
+    }
+
+    scratch.setSize(0, 0);
+}
+
+//==============================================================================
+//The first input renders straight into the output and is scaled in place, the other inputs
+//render into the scratch buffer and are added to the output with a vectorised multiply-add.
+//A gain that changed since the last block is ramped across the chunk
+void MixerEngine::mixChunk(juce::AudioBuffer<float>& output, int startSample, int numSamples)
+{
+    const int count{ numChannels };
+
+    if (count == 0)
+    {
+        output.clear(startSample, numSamples);
+        return;
+    }
+
+    float leftGain, rightGain;
+    getCrossfaderGains(crossfader, (CrossfaderCurve)crossfaderCurve.load(), leftGain, rightGain);
+    const float master{ masterGain };
+
+    const int numOutputChannels{ output.getNumChannels() };
+    const int numMixChannels{ juce::jmin(numOutputChannels, scratch.getNumChannels()) };
+
+    for (int i = 0; i < count; ++i)
+    {
+        Channel& channel{ channels[i] };
+        const float startGain{ channel.lastGain };
+        const float endGain{ getTargetGain(i, leftGain, rightGain, master) };
+        channel.lastGain = endGain;
+
+        const juce::int64 inputStart{ monitor != nullptr ? juce::Time::getHighResolutionTicks() : 0 };
+
+        if (i == 0)
+        {
+            channel.input->getNextAudioBlock(juce::AudioSourceChannelInfo(&output, startSample, numSamples));
+            timeInput(i, inputStart);
+
+            for (int ch = 0; ch < numOutputChannels; ++ch)
+            {
+                if (startGain == endGain)
+                {
+                    juce::FloatVectorOperations::multiply(output.getWritePointer(ch, startSample), endGain, numSamples);
+                }
+                else
+                {
+                    output.applyGainRamp(ch, startSample, numSamples, startGain, endGain);
+                }
+            }
+            continue;
+        }
+
+        //An input that is silenced by its fader or the crossfader is still rendered, so that it
+        //  keeps its position, but nothing is added to the output
+        juce::AudioSourceChannelInfo info{ &scratch, 0, numSamples };
+        channel.input->getNextAudioBlock(info);
+        timeInput(i, inputStart);
+
+        if (startGain == 0.0f && endGain == 0.0f)
+        {
+            continue;
+        }
+
+        for (int ch = 0; ch < numMixChannels; ++ch)
+        {
+            if (startGain == endGain)
+            {
+                juce::FloatVectorOperations::addWithMultiply(output.getWritePointer(ch, startSample),
+                    scratch.getReadPointer(ch),
+                    endGain,
+                    numSamples);
+            }
+            else
+            {
+                output.addFromWithRamp(ch, startSample, scratch.getReadPointer(ch), numSamples, startGain, endGain);
+            }
+        }
+    }
+}
+
+//Adding the time an input took to render to its section
+void MixerEngine::timeInput(int channel, juce::int64 startTicks)
+{
+    if (monitor == nullptr)
+    {
+        return;
+    }
+
+    const juce::int64 ticks{ juce::Time::getHighResolutionTicks() - startTicks };
+    inputTicks += ticks;
+    monitor->addSectionTicks(channel, ticks);
+}
+
+//The gain of a channel is its fader times its side of the crossfader times the master gain
+float MixerEngine::getTargetGain(int channel, float leftGain, float rightGain, float master) const
+{
+    float gain{ channels[channel].gain * master };
+
+    switch ((CrossfaderSide)channels[channel].side.load())
+    {
+        case CrossfaderSide::left:
+            gain *= leftGain;
+            break;
+
+        case CrossfaderSide::right:
+            gain *= rightGain;
+            break;
+
+        case CrossfaderSide::thru:
+            break;
+    }
+
+    return gain;
+}
+
+//The crossfader curves, the position going from 0 (fully left) to 1 (fully right)
+void MixerEngine::getCrossfaderGains(float position, CrossfaderCurve curve, float& leftGain, float& rightGain)
+{
+    const float x{ juce::jlimit(0.0f, 1.0f, position) };
+
+    switch (curve)
+    {
+        case CrossfaderCurve::linear:
+            leftGain = juce::jmin(1.0f, 2.0f * (1.0f - x));
+            rightGain = juce::jmin(1.0f, 2.0f * x);
+            break;
+
+        case CrossfaderCurve::constantPower:
+            leftGain = std::cos(x * juce::MathConstants<float>::halfPi);
+            rightGain = std::sin(x * juce::MathConstants<float>::halfPi);
+            break;
+
+        case CrossfaderCurve::sharp:
+            leftGain = juce::jmin(1.0f, 16.0f * (1.0f - x));
+            rightGain = juce::jmin(1.0f, 16.0f * x);
+            break;
+    }
+}
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    MixerEngine.h
+    Created: 17 Oct 2026 2:45:04pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "AudioPerformanceMonitor.h"
+
+//==============================================================================
+//The mixer that sums the decks into the master output.
+//Every input is a channel with its own fader and a crossfader assignment, and the sum goes through
+//  a master gain used to leave headroom. The summing is done with juce::FloatVectorOperations
+//  and nothing is allocated or locked in the audio callback
+class MixerEngine : public juce::AudioSource
+{
+public:
+    //Which side of the crossfader a channel is assigned to. Channels set to thru ignore the crossfader
+    enum class CrossfaderSide
+    {
+        left,
+        right,
+        thru
+    };
+
+    //The shape of the crossfader curve
+    enum class CrossfaderCurve
+    {
+        //Both sides stay at full level in the middle and fade out linearly towards the far end
+        linear,
+        //Constant power, cos/sin, with a 3dB dip in the middle
+        constantPower,
+        //A sharp cut at both ends, for scratching
+        sharp
+    };
+
+    //The highest number of channels the mixer can take
+    static constexpr int maxChannels{ 16 };
+
+    MixerEngine();
+    ~MixerEngine() override;
+
+    //Adding an input to the mixer, returns the index of its channel or -1 if the mixer is full.
+    //The mixer does not own the input. Inputs should be added before the audio device is started
+    int addInput(juce::AudioSource* input, CrossfaderSide side);
+
+    //The number of channels in use
+    int getNumChannels() const;
+
+    //Setting the fader of a channel, as a gain between 0 and 1
+    void setChannelGain(int channel, float gain);
+    //Assigning a channel to a side of the crossfader
+    void setChannelSide(int channel, CrossfaderSide side);
+
+    //Setting the crossfader position between 0 (fully left) and 1 (fully right)
+    void setCrossfader(float position);
+    //Choosing the shape of the crossfader curve
+    void setCrossfaderCurve(CrossfaderCurve curve);
+
+    //Setting how many decibels of headroom the master output leaves, 0 meaning unity gain
+    void setHeadroomDecibels(float decibels);
+
+    //Setting the number of output channels the scratch buffer is sized for at the next prepareToPlay.
+    //Defaults to 2
+    void setNumOutputChannels(int numOutputChannels);
+
+    //The 3 functions that need to be implemented since we inherit from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //Timing every input and the mixing itself into a monitor. Input i is timed as section i and the
+    //  mixing as section mixSection. Should be set before the audio device is started
+    void setPerformanceMonitor(AudioPerformanceMonitor* newMonitor);
+    static constexpr int mixSection{ maxChannels };
+
+    //Returns the gains of the left and right side of the crossfader for a position and a curve
+    static void getCrossfaderGains(float position, CrossfaderCurve curve, float& leftGain, float& rightGain);
+
+private:
+    //Mixing a part of the output buffer no longer than the scratch buffer
+    void mixChunk(juce::AudioBuffer<float>& output, int startSample, int numSamples);
+
+    //Adding the time an input took since startTicks to the monitor
+    void timeInput(int channel, juce::int64 startTicks);
+
+    //Computing the gain a channel should have right now from its fader, the crossfader and the master
+    float getTargetGain(int channel, float leftGain, float rightGain, float masterGain) const;
+
+    //Everything the mixer knows about one of its channels
+    struct Channel
+    {
+        juce::AudioSource* input{ nullptr };
+        std::atomic<float> gain{ 1.0f };
+        std::atomic<int> side{ (int)CrossfaderSide::thru };
+
+        //The gain used at the end of the last block, only used on the audio thread,
+        //so that gain changes are ramped over a block instead of clicking
+        float lastGain{ 1.0f };
+    };
+
+    std::array<Channel, maxChannels> channels;
+    std::atomic<int> numChannels{ 0 };
+
+    std::atomic<float> crossfader{ 0.5f };
+    std::atomic<int> crossfaderCurve{ (int)CrossfaderCurve::linear };
+    std::atomic<float> masterGain{ 1.0f };
+
+    //The buffer each input renders into before it is added to the output, allocated in prepareToPlay
+    //  with one channel per output channel
+    juce::AudioBuffer<float> scratch;
+    int numScratchChannels{ 2 };
+
+    //The monitor the timings go to, or nullptr
+    AudioPerformanceMonitor* monitor{ nullptr };
+    //The time spent in the inputs during the current block, only used on the audio thread
+    juce::int64 inputTicks{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixerEngine)
+};
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    NearWaveformDisplay.cpp
+    Created: 17 Oct 2026 3:35:40pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "NearWaveformDisplay.h"
+#include "WaveformDisplay.h"
+#include <cmath>
+#include <cstdlib>
+
+NearWaveformDisplay::NearWaveformDisplay(AudioPlayer* _player)
+    : player(_player)
+{
+    setOpaque(true);
+    startTimerHz(framesPerSecond);
+}
+
+NearWaveformDisplay::~NearWaveformDisplay()
+{
+    stopTimer();
+}
+
+//The image already holds the waveform, so painting is a single copy and the playhead on top
+void NearWaveformDisplay::paint(juce::Graphics& g)
+{
+    if (pyramid == nullptr || !image.isValid())
+    {
+        g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+    }
+    else
+    {
+        g.drawImageAt(image, 0, 0);
+    }
+
+    g.setColour(juce::Colours::darkorange);
+    g.drawRect(getLocalBounds(), 1);
+    g.fillRect(getWidth() / 2 - 1, 0, 2, getHeight());
+}
+
+void NearWaveformDisplay::resized()
+{
+    image = getWidth() > 0 && getHeight() > 0 ? juce::Image(juce::Image::RGB, getWidth(), getHeight(), false) : juce::Image();
+    imageValid = false;
+}
+
+void NearWaveformDisplay::mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel)
+{
+    if (wheel.deltaY > 0.0f)
+    {
+        setSamplesPerPixel(samplesPerPixel / 2);
+    }
+    else if (wheel.deltaY < 0.0f)
+    {
+        setSamplesPerPixel(samplesPerPixel * 2);
+    }
+}
+
+void NearWaveformDisplay::setSamplesPerPixel(int newSamplesPerPixel)
+{
+    newSamplesPerPixel = juce::jlimit(minSamplesPerPixel, maxSamplesPerPixel, juce::nextPowerOfTwo(newSamplesPerPixel));
+
+    if (newSamplesPerPixel != samplesPerPixel)
+    {
+        samplesPerPixel = newSamplesPerPixel;
+        imageValid = false;
+    }
+}
+
+int NearWaveformDisplay::getSamplesPerPixel() const
+{
+    return samplesPerPixel;
+}
+
+//==============================================================================
+//Nothing is repainted while the deck is stopped and the image is up to date
+void NearWaveformDisplay::timerCallback()
+{
+    const juce::File loadedFile{ player->getLoadedFile() };
+
+    if (loadedFile != pyramidFile)
+    {
+        pyramidFile = loadedFile;
+        pyramid.reset();
+        imageValid = false;
+        repaint();
+
+        if (loadedFile != juce::File{})
+        {
+            juce::Component::SafePointer<NearWaveformDisplay> safeThis{ this };
+
+            waveformCache->findAsync(loadedFile, [safeThis, loadedFile](std::shared_ptr<const WaveformPyramid> found)
+            {
+                if (safeThis != nullptr && safeThis->pyramidFile == loadedFile)
+                {
+                    safeThis->pyramid = found;
+                    safeThis->imageValid = false;
+                }
+            });
+        }
+    }
+
+    if (pyramid == nullptr || !image.isValid())
+    {
+        return;
+    }
+
+    const double playheadSample{ player->getPositionInSeconds() * pyramid->getSampleRate() };
+    const juce::int64 playheadColumn{ (juce::int64)std::floor(playheadSample / samplesPerPixel) };
+
+    scrollTo(playheadColumn - getWidth() / 2);
+}
+
+//A jump of the whole width or more, eg. to a hot cue, draws the whole image again
+void NearWaveformDisplay::scrollTo(juce::int64 firstColumn)
+{
+    const int width{ image.getWidth() };
+    const juce::int64 shift{ firstColumn - imageFirstColumn };
+
+    if (imageValid && shift == 0)
+    {
+        return;
+    }
+
+    if (!imageValid || std::abs(shift) >= width)
+    {
+        imageFirstColumn = firstColumn;
+        drawColumns(0, width);
+        imageValid = true;
+    }
+    else if (shift > 0)
+    {
+        const int columns{ (int)shift };
+        image.moveImageSection(0, 0, columns, 0, width - columns, image.getHeight());
+        imageFirstColumn = firstColumn;
+        drawColumns(width - columns, width);
+    }
+    else
+    {
+        const int columns{ (int)-shift };
+        image.moveImageSection(columns, 0, 0, 0, width - columns, image.getHeight());
+        imageFirstColumn = firstColumn;
+        drawColumns(0, columns);
+    }
+
+    repaint();
+}
+
+//The zoom is a power of 2, so a column covers a whole number of points of the chosen level, or is part of one point
+void NearWaveformDisplay::drawColumns(int startX, int endX)
+{
+    juce::Graphics g{ image };
+    g.reduceClipRegion(startX, 0, endX - startX, image.getHeight());
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+
+    const int level{ pyramid->findLevel(samplesPerPixel) };
+    const juce::int64 samplesPerPoint{ pyramid->getSamplesPerPoint(level) };
+    const juce::int64 lengthInColumns{ (pyramid->getLengthInSamples() + samplesPerPixel - 1) / samplesPerPixel };
+    const float centre{ image.getHeight() * 0.5f };
+
+    for (int x = startX; x < endX; ++x)
+    {
+        const juce::int64 column{ imageFirstColumn + x };
+
+        //Before the start and after the end of the track the image is left empty
+        if (column < 0 || column >= lengthInColumns)
+        {
+            continue;
+        }
+
+        const int firstPoint{ (int)(column * samplesPerPixel / samplesPerPoint) };
+        const int endPoint{ juce::jmax(firstPoint + 1, (int)((column + 1) * samplesPerPixel / samplesPerPoint)) };
+
+        WaveformDisplay::drawPoint(g, x, pyramid->getRange(level, firstPoint, endPoint), centre);
+    }
+}
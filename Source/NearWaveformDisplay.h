@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    NearWaveformDisplay.h
+    Created: 17 Oct 2026 3:35:40pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include "AudioPlayer.h"
+#include "WaveformCache.h"
+
+//==============================================================================
+//A zoomed in waveform of the track on a deck that scrolls past a fixed playhead in the middle.
+//It follows the player framesPerSecond times a second. The waveform is kept in an image one column per pixel,
+//  and when the playhead moves the image is shifted by the number of columns it moved and only the columns
+//  that came into view are drawn from the pyramid of the track. Each column reads at most a couple of points,
+//  so a frame costs the same however long the track is.
+//The mouse wheel zooms in and out
+class NearWaveformDisplay : public juce::Component,
+                            private juce::Timer
+{
+public:
+    //How often the playhead is followed
+    static constexpr int framesPerSecond{ 60 };
+    //The zoom is the number of samples under one pixel, always a power of 2 between these.
+    //It goes no further in than level 0 of the pyramid, below that a pixel would have less than a point
+    static constexpr int minSamplesPerPixel{ WaveformPyramid::baseSamplesPerPoint };
+    static constexpr int maxSamplesPerPixel{ 4096 };
+
+    NearWaveformDisplay(AudioPlayer* _player);
+    ~NearWaveformDisplay() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+    //Zooming in when the wheel moves up and out when it moves down
+    void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+
+    //Setting and getting the zoom, in samples per pixel
+    void setSamplesPerPixel(int samplesPerPixel);
+    int getSamplesPerPixel() const;
+
+private:
+    //Asking for the pyramid of a newly loaded track and scrolling the image to the playhead
+    void timerCallback() override;
+
+    //Moving the image so that its first column is the given column of the track, drawing only what came into view
+    void scrollTo(juce::int64 firstColumn);
+    //Drawing the columns of the image from startX up to, but not including, endX
+    void drawColumns(int startX, int endX);
+
+    AudioPlayer* player;
+
+    //The pyramid of the track and the file it was asked for, so a new track is noticed
+    std::shared_ptr<const WaveformPyramid> pyramid;
+    juce::File pyramidFile;
+
+    //The waveform around the playhead, and the column of the track shown in its first column
+    juce::Image image;
+    juce::int64 imageFirstColumn{ 0 };
+    //False when the whole image has to be drawn again, eg. after a zoom or a new track
+    bool imageValid{ false };
+
+    int samplesPerPixel{ 512 };
+
+    juce::SharedResourcePointer<WaveformCache> waveformCache;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NearWaveformDisplay)
+};
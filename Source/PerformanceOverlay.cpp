@@ -0,0 +1,161 @@
+/*
+  ==============================================================================
+
+    PerformanceOverlay.cpp
+    Created: 17 Oct 2026 3:00:41pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PerformanceOverlay.h"
+
+//==============================================================================
+PerformanceOverlay::PerformanceOverlay(AudioPerformanceMonitor& _monitor)
+    : monitor(_monitor)
+{
+    addAndMakeVisible(saveCsv);
+    addAndMakeVisible(resetPeaks);
+
+    saveCsv.addListener(this);
+    resetPeaks.addListener(this);
+
+    for (juce::TextButton* button : { &saveCsv, &resetPeaks })
+    {
+        button->setColour(juce::TextButton::buttonColourId, juce::Colours::darkslategrey);
+    }
+}
+
+PerformanceOverlay::~PerformanceOverlay()
+{
+    stopTimer();
+}
+
+//The lines, a gap, the histogram and the row of buttons
+int PerformanceOverlay::getPreferredHeight() const
+{
+    return 8 + getLines().size() * lineHeight + histogramHeight + 32;
+}
+
+juce::StringArray PerformanceOverlay::getLines() const
+{
+    const double sampleRate{ monitor.getSampleRate() };
+    const double periodMs{ sampleRate > 0.0 ? monitor.getBlockSize() / sampleRate * 1000.0 : 0.0 };
+
+    juce::StringArray lines;
+    lines.add("Buffer: " + juce::String(monitor.getBlockSize()) + " samples @ " + juce::String(sampleRate, 0)
+        + " Hz (" + juce::String(periodMs, 2) + " ms)");
+    lines.add("Load: " + juce::String(monitor.getLastLoad() * 100.0, 1) + "%   avg "
+        + juce::String(monitor.getAverageLoad() * 100.0, 1) + "%   peak "
+        + juce::String(monitor.getPeakLoad() * 100.0, 1) + "%");
+    lines.add("Overruns: " + juce::String(monitor.getNumOverruns()) + "   Xruns: " + juce::String(monitor.getNumXruns()));
+
+    for (int i = 0; i < AudioPerformanceMonitor::maxSections; ++i)
+    {
+        const juce::String name{ monitor.getSectionName(i) };
+        if (name.isEmpty())
+        {
+            continue;
+        }
+
+        const AudioPerformanceMonitor::SectionStats stats{ monitor.getSectionStats(i) };
+        lines.add(name + ": avg " + juce::String(juce::roundToInt(stats.averageMicroseconds)) + " us   peak "
+            + juce::String(juce::roundToInt(stats.peakMicroseconds)) + " us");
+    }
+
+    for (int i = 0; i < monitor.getNumCounters(); ++i)
+    {
+        lines.add(monitor.getCounterName(i) + ": " + monitor.getCounterText(i));
+    }
+
+    return lines;
+}
+
+//Writing the figures line by line, with the histogram under them
+void PerformanceOverlay::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colours::black.withAlpha(0.85f));
+    g.setColour(juce::Colours::darkorange);
+    g.drawRect(getLocalBounds(), 1);
+
+    const juce::StringArray lines{ getLines() };
+
+    g.setColour(juce::Colours::beige);
+    g.setFont(12.0f);
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        g.drawText(lines[i], 6, 4 + i * lineHeight, getWidth() - 12, lineHeight, juce::Justification::centredLeft);
+    }
+
+    //The histogram of the callback load, each bar scaled to the biggest bin.
+    //The bars at or over 100% of the buffer period are drawn in red
+    const juce::Rectangle<int> area{ 6, 8 + lines.size() * lineHeight, getWidth() - 12, getHeight() - 40 - lines.size() * lineHeight };
+    if (area.getHeight() <= 0)
+    {
+        return;
+    }
+
+    int biggest{ 1 };
+    for (int bin = 0; bin < AudioPerformanceMonitor::numHistogramBins; ++bin)
+    {
+        biggest = juce::jmax(biggest, monitor.getHistogramCount(bin));
+    }
+
+    const float barWidth{ area.getWidth() / (float)AudioPerformanceMonitor::numHistogramBins };
+    for (int bin = 0; bin < AudioPerformanceMonitor::numHistogramBins; ++bin)
+    {
+        const float height{ area.getHeight() * (float)monitor.getHistogramCount(bin) / (float)biggest };
+        const bool late{ bin * AudioPerformanceMonitor::histogramBinWidth >= 1.0 };
+
+        g.setColour(late ? juce::Colours::red : juce::Colours::lightseagreen);
+        g.fillRect(area.getX() + bin * barWidth + 1.0f, area.getBottom() - height, barWidth - 2.0f, height);
+    }
+}
+
+void PerformanceOverlay::resized()
+{
+    saveCsv.setBounds(6, getHeight() - 28, 100, 24);
+    resetPeaks.setBounds(112, getHeight() - 28, 100, 24);
+}
+
+void PerformanceOverlay::buttonClicked(juce::Button* button)
+{
+    //The figures are written to a CSV file chosen by the user
+    if (button == &saveCsv)
+    {
+        juce::FileChooser chooser{ "Save the audio statistics...",
+                                   juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("audio_stats.csv"),
+                                   "*.csv" };
+        if (chooser.browseForFileToSave(true))
+        {
+            if (!monitor.writeCsv(chooser.getResult()))
+            {
+                DBG("PerformanceOverlay::buttonClicked could not write " << chooser.getResult().getFullPathName());
+            }
+        }
+    }
+
+    if (button == &resetPeaks)
+    {
+        monitor.resetPeaks();
+        repaint();
+    }
+}
+
+void PerformanceOverlay::timerCallback()
+{
+    repaint();
+}
+
+void PerformanceOverlay::visibilityChanged()
+{
+    if (isVisible())
+    {
+        startTimer(250);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
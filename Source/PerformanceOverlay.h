@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    PerformanceOverlay.h
+    Created: 17 Oct 2026 3:00:41pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioPerformanceMonitor.h"
+
+//==============================================================================
+//A small panel drawn over the app that shows the figures of an AudioPerformanceMonitor:
+//  the callback load, the overruns and xruns, the timing of every section, the extra counters
+//  and a histogram of the callback load. The figures can be saved to a CSV file
+class PerformanceOverlay : public juce::Component,
+                           public juce::Button::Listener,
+                           public juce::Timer
+{
+public:
+    PerformanceOverlay(AudioPerformanceMonitor& _monitor);
+    ~PerformanceOverlay() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+    //Needs to be implemented since we inherit from Button::Listener class
+    void buttonClicked(juce::Button* button) override;
+
+    //Repainting with the latest figures
+    void timerCallback() override;
+
+    //The timer only runs while the overlay is on screen
+    void visibilityChanged() override;
+
+    //The height the overlay needs to show every line of figures and a histogram of histogramHeight.
+    //The number of lines depends on the sections and counters of the monitor, so it should be asked
+    //  for once they have all been added
+    int getPreferredHeight() const;
+
+    //The height of a line of figures and the smallest height the histogram is drawn at
+    static constexpr int lineHeight{ 14 };
+    static constexpr int histogramHeight{ 80 };
+
+private:
+    //The lines of figures, one per line of the overlay
+    juce::StringArray getLines() const;
+
+    AudioPerformanceMonitor& monitor;
+
+    juce::TextButton saveCsv{ "Save CSV" };
+    juce::TextButton resetPeaks{ "Reset peaks" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerformanceOverlay)
+};
@@ -11,24 +11,22 @@
 #include <JuceHeader.h>
 #include "PlaylistComponent.h"
 #include <iostream>
+#include <algorithm>
 
 //==============================================================================
 //Playlist Component constructor with all the variables initialized
 // -- Audio players that are used by the playlist component to choose where to load the track
 //         when the user choose to load a track from the playlist
-// -- Tmp audio player is used to calculate the track length of each track while loading it from file
 // -- Waveform displays are used to choose where to display the title
 // -- TrackTitles objects are used to choose which display is used when a track is loaded
 PlaylistComponent::PlaylistComponent(AudioPlayer* _player1, 
                                      AudioPlayer* _player2,
-                                     AudioPlayer* _tmp,
                                      WaveformDisplay* _display1,
                                      WaveformDisplay* _display2,
                                      TrackTitle* _title_d1,
                                      TrackTitle* _title_d2)
     :   player1(_player1),
         player2(_player2),
-        tmp_player(_tmp), 
         w_display1(_display1),
         w_display2(_display2),
         titled1(_title_d1),
@@ -38,7 +36,9 @@ PlaylistComponent::PlaylistComponent(AudioPlayer* _player1,
     playlist.getHeader().addColumn("Track Title", 1, 200);
     playlist.getHeader().addColumn("Location", 2, 200);
     playlist.getHeader().addColumn("Length", 3, 200);
-    playlist.getHeader().addColumn("", 4, 200);
+    playlist.getHeader().addColumn("Key", 6, 80);
+    playlist.getHeader().addColumn("BPM", 5, 80);
+    playlist.getHeader().addColumn("", 4, 200, 30, -1, juce::TableHeaderComponent::visible | juce::TableHeaderComponent::resizable);
     //The playlist is enabled to accept multiple selection of rows instead of 1 at a time
     playlist.setMultipleSelectionEnabled(true);
 
@@ -46,23 +46,51 @@ PlaylistComponent::PlaylistComponent(AudioPlayer* _player1,
     addAndMakeVisible(playlist);    
     addAndMakeVisible(searchField);
     addAndMakeVisible(inputText); 
+    addAndMakeVisible(importButton);
+    addAndMakeVisible(analyseButton);
+    addAndMakeVisible(statusLabel);
+    importButton.addListener(this);
+    analyseButton.addListener(this);
+    statusLabel.setColour(juce::Label::textColourId, juce::Colours::darkorange);
 
     //Setting this playlist component as a model to the TableListBox playlist since
     //  the playlist component is a TableListBoxModel
     playlist.setModel(this);
 
-    //The directories of each track are read from file to be displayed by the playlist
+    //The playlist is repainted whenever the metadata store learns the length of a track
+    metadataStore->addChangeListener(this);
+    //and whenever the analysis engine has stored the tempo and key of a track
+    analysisEngine->addChangeListener(this);
+
+    //The tracks of the library are read to be displayed by the playlist
     loadDirectories();
-    //As a debug message the playlist file directory is written
-    DBG("Playlist directory is " << playlistFile.getFullPathName());
+
+    //The files of the library are checked and watched in the background from now on
+    juce::Component::SafePointer<PlaylistComponent> safeThis{ this };
+    libraryWatcher.start(
+        [safeThis](const std::vector<FolderImporter::ImportedTrack>& added)
+        {
+            if (safeThis != nullptr)
+            {
+                safeThis->tracksAdded(added);
+            }
+        },
+        [safeThis](const std::vector<juce::uint32>& removed)
+        {
+            if (safeThis != nullptr)
+            {
+                safeThis->tracksRemoved(removed);
+            }
+        });
+    //As a debug message the library file directory is written
+    DBG("Library directory is " << LibraryDatabase::getDefaultFile().getFullPathName());
 }
 
+//Nothing has to be saved here, every track is written to the library as soon as it is added
 PlaylistComponent::~PlaylistComponent()
 {
-    //When this component is destructed when closing the app
-    //  the directories of all the tracks that are found in the playlist get written to file 
-    //  using the savePlaylistToFile function
-    savePlaylistToFile();
+    metadataStore->removeChangeListener(this);
+    analysisEngine->removeChangeListener(this);
 }
 
 void PlaylistComponent::paint (juce::Graphics& g)
@@ -92,14 +120,17 @@ void PlaylistComponent::resized()
 {
     // This method is where you should set the bounds of any child
     // components that your component contains..
-    inputText.setBounds(125, 0, getWidth() - 125, 25);
+    inputText.setBounds(125, 0, getWidth() - 365, 25);
+    analyseButton.setBounds(getWidth() - 240, 0, 120, 25);
+    importButton.setBounds(getWidth() - 120, 0, 120, 25);
     playlist.setBounds(0, 25, getWidth(), getHeight()-50);    
+    statusLabel.setBounds(0, getHeight() - 25, getWidth(), 25);
 }
 
 //Implemented because it is a pure virtual function of the TableListBoxModel abstract class
 int PlaylistComponent::getNumRows()
 {
-    return tracks.size();   
+    return (int)rows.size();   
 }
 
 void PlaylistComponent::paintRowBackground(juce::Graphics& g,
@@ -126,14 +157,17 @@ void PlaylistComponent::paintCell(juce::Graphics& g,
     int height,
     bool rowIsSelected)
 {
-    //The next file in the tracks vector is loaded into the tmp player so that the songlength
-    // is extracted
-    tmp_player->loadURL(juce::URL(tracks[rowNumber]));
-    
+    //The table only paints the rows that are on screen, so the strings are made here and never kept
+    if (rowNumber < 0 || rowNumber >= (int)rows.size())
+    {
+        return;
+    }
+    const int track{ rows[rowNumber] };
+
     //At column 1 the file name / track title is displayed
     if (columnId == 1)
     {
-        g.drawText(tracks[rowNumber].getFileNameWithoutExtension(),
+        g.drawText(trackStore.getTitle(track),
             2,
             0,
             width - 4,
@@ -145,7 +179,7 @@ void PlaylistComponent::paintCell(juce::Graphics& g,
     //At column 2 the location of the file is displayed
     if (columnId == 2)
     {
-        g.drawText(tracks[rowNumber].getFullPathName(),
+        g.drawText(trackStore.getPath(track),
             2,
             0,
             width - 4,
@@ -154,10 +188,13 @@ void PlaylistComponent::paintCell(juce::Graphics& g,
             true);
     }
 
-    //At column 3 the song length in minutes and seconds is displayed
+    //At column 3 the song length in minutes and seconds is displayed.
+    //A track that has not been probed yet shows "..."
     if (columnId == 3)
     {            
-        g.drawText(tmp_player->getSongLength(),
+        const float length{ trackStore.getLength(track) };
+
+        g.drawText(length >= 0.0f ? TrackMetadata::formatLength(length) : juce::String("..."),
             2,
             0,
             width - 4,
@@ -165,6 +202,35 @@ void PlaylistComponent::paintCell(juce::Graphics& g,
             juce::Justification::horizontallyCentred,
             true);
     }    
+
+    //At column 5 the tempo found by the analysis engine is displayed, empty until the track is analysed
+    //  and "-" for a track with no beat
+    if (columnId == 5)
+    {
+        const float bpm{ trackStore.getBpm(track) };
+
+        g.drawText(bpm < 0.0f ? juce::String() : bpm == 0.0f ? juce::String("-") : juce::String(bpm, 1),
+            2,
+            0,
+            width - 4,
+            height,
+            juce::Justification::horizontallyCentred,
+            true);
+    }
+
+    //At column 6 the key is displayed with its Camelot code, so the keys that mix well are easy to find
+    if (columnId == 6)
+    {
+        const int key{ trackStore.getKey(track) };
+
+        g.drawText(key < 0 ? juce::String() : KeyAnalyser::getCamelotCode(key) + "  " + KeyAnalyser::getKeyName(key),
+            2,
+            0,
+            width - 4,
+            height,
+            juce::Justification::horizontallyCentred,
+            true);
+    }
 }
 
 juce::Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
@@ -174,156 +240,571 @@ juce::Component* PlaylistComponent::refreshComponentForCell(int rowNumber,
 {
     //We re attaching a text button to eachcell in column 4 that enables 
     //the user to load a track into a player 
-    if (columnId == 4)
+    //The table only asks for the rows that are on screen and hands back the buttons of the rows
+    //  that scrolled away, so there are only ever as many buttons as visible rows
+    if (columnId != 4)
+    {
+        delete existingComponentToUpdate;
+        return nullptr;
+    }
+
+    LoadButton* btn{ dynamic_cast<LoadButton*>(existingComponentToUpdate) };
+
+    if (btn == nullptr)
+    {
+        delete existingComponentToUpdate;
+        btn = new LoadButton();
+        btn->addListener(this);
+    }
+    btn->row = rowNumber;
+
+    return btn;
+}
+
+void PlaylistComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    if (source == metadataStore.get())
+    {
+        const std::vector<DuplicateTrack> duplicates{ metadataStore->takeDuplicates() };
+
+        if (!duplicates.empty())
+        {
+            std::vector<juce::uint32> removed;
+            for (const DuplicateTrack& duplicate : duplicates)
+            {
+                removed.push_back(duplicate.libraryId);
+            }
+            tracksRemoved(removed);
+            showDuplicates(duplicates);
+        }
+
+        tracksChanged(metadataStore->takeChangedTracks(), 3, 3);
+    }
+
+    if (source == analysisEngine.get())
     {
-        if (existingComponentToUpdate == nullptr)
+        tracksChanged(analysisEngine->takeChangedTracks(), 5, 6);
+        showAnalysisProgress();
+    }
+}
+
+//Only the tracks that changed are read from the library
+void PlaylistComponent::tracksChanged(const std::vector<juce::uint32>& changed, int firstColumn, int lastColumn)
+{
+    bool anyChanged{ false };
+
+    for (const juce::uint32 id : changed)
+    {
+        const int track{ trackStore.findTrack(id) };
+
+        if (track >= 0)
         {
-            juce::TextButton* btn = new juce::TextButton{ "Load Track" };
-            juce::String id{ std::to_string(rowNumber) };
-            btn->setComponentID(id);
-            btn->addListener(this);
-            existingComponentToUpdate = btn;           
+            updateColumns(track);
+            anyChanged = true;
         }
     }
-    
-    return existingComponentToUpdate;
+
+    if (anyChanged && sortColumn >= firstColumn && sortColumn <= lastColumn)
+    {
+        sortNeeded = true;
+        updateRows();
+        return;
+    }
+
+    playlist.repaint();
 }
 
 //This function is called whenever a button is clicked in the playlist component
 //A button is passed as a parameter, whenever a button is clicked inside this component
 void PlaylistComponent::buttonClicked(juce::Button* button)
 {
-    //The component id set in the refreshComponentForCell function is extracted from each button
-    int id = std::stoi(button->getComponentID().toStdString());
+    if (button == &importButton)
+    {
+        importFolder();
+        return;
+    }
+
+    if (button == &analyseButton)
+    {
+        analyseLibrary();
+        return;
+    }
+
+    //The row set in the refreshComponentForCell function is read back from the button
+    LoadButton* loadButton{ dynamic_cast<LoadButton*>(button) };
+
+    if (loadButton == nullptr || loadButton->row < 0 || loadButton->row >= (int)rows.size())
+    {
+        return;
+    }
+    const juce::File file{ trackStore.getFile(rows[loadButton->row]) };
 
     //If player 1 is playing and player 2 is not, the track is loaded into player 2
     //Also, the title is sent to the title2 pointer and same is done to the w_display2 pointer
-    if (player1->transportSource.isPlaying() == true && player2->transportSource.isPlaying()==false)
+    if (player1->isPlaying() == true && player2->isPlaying()==false)
     {
-        player2->loadURL(juce::URL{ tracks[id] });
-        titled2->setTitle(tracks[id].getFileNameWithoutExtension().toUpperCase(), player2->getSongLength());
-        w_display2->loadURL(juce::URL{ tracks[id] });
+        loadTrackIntoDeck(file, player2, titled2, w_display2);
     }
 
     //Vice versa, if player 1 is not playing and player 2 is playing, the track is loaded into player 1
     //As above, the track title and waveform display are sent to the according pointers
-    if (player1->transportSource.isPlaying() == false && player2->transportSource.isPlaying() == true)
+    if (player1->isPlaying() == false && player2->isPlaying() == true)
     {
-        player1->loadURL(juce::URL{ tracks[id] });
-        titled1->setTitle(tracks[id].getFileNameWithoutExtension().toUpperCase(), player1->getSongLength());
-        w_display1->loadURL(juce::URL{ tracks[id] });
+        loadTrackIntoDeck(file, player1, titled1, w_display1);
     }
 
     //If both players are playing, track is loaded into player 1
-    if (player1->transportSource.isPlaying() == true && player2->transportSource.isPlaying() == true)
+    if (player1->isPlaying() == true && player2->isPlaying() == true)
     {
-        player1->loadURL(juce::URL{ tracks[id] });
-        titled1->setTitle(tracks[id].getFileNameWithoutExtension().toUpperCase(), player1->getSongLength());
-        w_display1->loadURL(juce::URL{ tracks[id] });
+        loadTrackIntoDeck(file, player1, titled1, w_display1);
     }
 
     //If player 1 is not playing, track is loaded into player 1
-    if (player1->transportSource.isPlaying() == false)
+    if (player1->isPlaying() == false)
     {
-        player1->loadURL(juce::URL{ tracks[id] });
-        titled1->setTitle(tracks[id].getFileNameWithoutExtension().toUpperCase(), player1->getSongLength());
-        w_display1->loadURL(juce::URL{ tracks[id] });
+        loadTrackIntoDeck(file, player1, titled1, w_display1);
     }   
 }
 
-//A function that enables adding of file to the tracklist
-void PlaylistComponent::addAudioFile(juce::File* audioFile)
+//Loading a track into one of the decks in the background, so that the playlist and the
+//other deck keep running while the file is opened. The title shows the load progress and
+//the waveform and song length are updated once the track is ready
+void PlaylistComponent::loadTrackIntoDeck(juce::File file,
+    AudioPlayer* player,
+    TrackTitle* title,
+    WaveformDisplay* display)
 {
-    //bool variable used as a signal whether the file already exists or not
-    bool alreadyExists{ false };
+    juce::String trackName{ file.getFileNameWithoutExtension().toUpperCase() };
+    title->setTitle(trackName, "Loading...");
 
-    for (juce::File& file : tracks)
-    {
-        //if the filename of the file in the tracks vector is equal to the filename of the audiofile passed
-        //  the bool variable is set to true and loop exits
-        if (file.getFileName().equalsIgnoreCase(audioFile->getFileName()))
+    juce::Component::SafePointer<PlaylistComponent> safeThis{ this };
+
+    player->loadURLAsync(juce::URL{ file },
+        [safeThis, title, trackName](float progress)
         {
-            alreadyExists = true;
-            break;
-        }
-    }  
+            if (safeThis != nullptr)
+            {
+                title->setTitle(trackName, "Loading " + juce::String(juce::roundToInt(progress * 100.0f)) + "%");
+            }
+        },
+        [safeThis, player, title, display, trackName, file](bool loadedOk)
+        {
+            if (safeThis == nullptr)
+            {
+                return;
+            }
+
+            if (loadedOk)
+            {
+                title->setTitle(trackName, player->getSongLength());
+                display->loadURL(juce::URL{ file });
+            }
+            else
+            {
+                title->setTitle(trackName, "Could not load the file");
+            }
+        });
+}
+
+//A function that enables adding of file to the tracklist
+void PlaylistComponent::addAudioFile(juce::File* audioFile)
+{
+    //bool variable used as a signal whether the file is already in the library
+    //The library looks the path up in a hash index, so the check does not depend on the size of the playlist
+    bool alreadyExists{ library->findTrack(*audioFile) != 0 };
 
     //If alreadyExists is still false and the file's passed directory string is empty
-    //the file is pushed back the vector
-    //The playlist's content is updated and the paint function is recalled
+    //the file is added to the trackStore and the library
+    //The rows of the playlist are rebuilt, which updates its content and recalls the paint function
     if (alreadyExists == false && audioFile->getFullPathName() != "")
     {
-        tracks.push_back(*audioFile);        
-        playlist.updateContent();
-        playlist.repaint();
+        appendTrack(*audioFile, library->addTrack(*audioFile));
+        metadataStore->request(*audioFile);
+        sortNeeded = true;
+        updateRows();
     }    
 }
 
-//A function that reads the playlist and saves the URLs to file
-void PlaylistComponent::savePlaylistToFile()
+//A function to load the tracks of the library
+void PlaylistComponent::loadDirectories()
 {
-    //A file output stream used to write to file
-    juce::FileOutputStream stream{ playlistFile };
-
-    //If the file output stream opened ok, the stream position is set at the beginning of the file
-    //For each file in tracks vector the directory string is written to file added a carriage return 
-    //for ease of reading when the file is read back
-    if (stream.openedOk() == true)
-    {     
-        stream.setPosition(0);
-        
-        for (auto &file : tracks)
+    //The first time the library is used, the tracks of the old playlist text file are added to it
+    //The text file is then renamed so that it is not imported again
+    if (library->getNumTracks() == 0 && playlistFile.existsAsFile())
+    {
+        juce::FileInputStream stream{ playlistFile };
+
+        if (stream.openedOk() == true)
         {
-            juce::String directory{ file.getFullPathName()+"\n"};
-            DBG(directory);            
-            stream.writeText(directory, false, false, nullptr);           
+            while (!stream.isExhausted())
+            {
+                juce::String str = stream.readNextLine();
+                if (str.isNotEmpty())
+                {
+                    library->addTrack(juce::File{ str });
+                }
+            }
         }
-        //stream is flushed to make sure that everything in the stream is written to file
-        stream.flush();
+        else
+        {
+            DBG("INPUT STREAM failed to open");
+        }
+
+        playlistFile.moveFileTo(playlistFile.withFileExtension("imported"));
     }
+
+    //A file is created from the path of every track in the library and added to the trackStore
+    //The files are not touched here. The libraryWatcher checks them in the background and has the
+    //  ones that changed since the last run probed again
+    for (juce::uint32 id : library->getTrackIds())
+    {
+        appendTrack(library->getFile(id), id);
+    }
+
+    sortNeeded = true;
+    updateRows();
 }
 
-//A function to load the URLs of the files found in the playlist textfiles
-void PlaylistComponent::loadDirectories()
+void PlaylistComponent::tracksAdded(const std::vector<FolderImporter::ImportedTrack>& added)
 {
-    //An input stream is opened indicating the file that is used to read from
-    juce::FileInputStream stream{ playlistFile };    
-
-    //if stream opened ok, a string is created for each line and a new file
-    //is created from the line read and added to the tracks vector
-    if (stream.openedOk() == true)
-    {      
-        while (!stream.isExhausted())
-        {           
-            juce::String str =  stream.readNextLine();                  
-            tracks.push_back( juce::File{ str });             
+    for (const FolderImporter::ImportedTrack& track : added)
+    {
+        appendTrack(track.file, track.libraryId);
+    }
+    sortNeeded = true;
+    updateRows();
+}
+
+//The removed tracks are only marked in the trackStore, so the numbers of the other tracks stay the same
+void PlaylistComponent::tracksRemoved(const std::vector<juce::uint32>& removed)
+{
+    for (const juce::uint32 id : removed)
+    {
+        const int track{ trackStore.findTrack(id) };
+
+        if (track >= 0)
+        {
+            trackStore.remove(track);
         }
     }
-    else
+
+    playlist.deselectAllRows();
+    sortNeeded = true;
+    updateRows();
+}
+
+//Only the first few duplicates are listed, so the message stays on the screen
+void PlaylistComponent::showDuplicates(const std::vector<DuplicateTrack>& duplicates)
+{
+    const int maxListed{ 10 };
+    juce::String text;
+
+    for (int i = 0; i < juce::jmin(maxListed, (int)duplicates.size()); ++i)
+    {
+        text << duplicates[i].file.getFullPathName() << "\n    is the same audio as "
+             << duplicates[i].original.getFullPathName() << "\n";
+    }
+
+    if ((int)duplicates.size() > maxListed)
+    {
+        text << "and " << (int)duplicates.size() - maxListed << " more";
+    }
+
+    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+        juce::String((int)duplicates.size()) + " duplicates left out of the library",
+        text);
+}
+
+//The title is searched together with the two folders above it, which are usually the artist and the album.
+//The rest of the path is the same for most tracks, so it is left out of the index
+void PlaylistComponent::appendTrack(const juce::File& file, juce::uint32 libraryId)
+{
+    const juce::File album{ file.getParentDirectory() };
+    const juce::File artist{ album.getParentDirectory() };
+    const int track{ trackStore.add(file, libraryId) };
+
+    searchIndex.addTrack(track,
+        file.getFileNameWithoutExtension() + "\n" + album.getFileName() + "\n" + artist.getFileName());
+    updateColumns(track);
+}
+
+//A track that has not been probed or analysed yet gets -1, so it is sorted before the others
+void PlaylistComponent::updateColumns(int track)
+{
+    const LibraryRecord* record{ library->getRecord(trackStore.getLibraryId(track)) };
+
+    if (record == nullptr)
     {
-        DBG("INPUT STREAM failed to open");
+        return;
     }
+
+    trackStore.setLength(track, record->sampleRate > 0.0 ? (float)record->lengthInSeconds : -1.0f);
+    trackStore.setBpm(track, (record->analysisFlags & LibraryDatabase::hasBpm) != 0 ? record->bpm : -1.0f);
+    trackStore.setKey(track, (record->analysisFlags & LibraryDatabase::hasKey) != 0 ? record->key : -1);
 }
 
 //A function that lets the user search for a track
+//The matching tracks are looked up in the search index and the table is updated a single time
+//  however many tracks match. An empty search field shows every track
 void PlaylistComponent::searchTrack(juce::String text)
 {
-    //At the beginning of each call of this function all the rows in the playlist are deselected
+    searchText = text;
     playlist.deselectAllRows();
+    updateRows();
+}
+
+void PlaylistComponent::sortOrderChanged(int newSortColumnId, bool isForwards)
+{
+    sortColumn = newSortColumnId;
+    sortForwards = isForwards;
+    sortNeeded = true;
+    updateRows();
+}
+
+//The tracks are only sorted when the sort column or the tracks changed, so typing never sorts anything.
+//A search costs as much as the tracks it matches, not the size of the library:
+//  - in the order the tracks were added in, the result of the index is already in row order
+//  - a query that extends the one the rows were made from only narrows the current rows
+//  - only a new query over sorted rows walks sortedTracks
+//The rows only hold track numbers, so searching and sorting never copy a file or a string
+void PlaylistComponent::updateRows()
+{
+    if (sortNeeded)
+    {
+        sortTracks();
+        sortNeeded = false;
+        rowsSearchText.clear();
+        rowsFromSortedTracks = false;
+    }
+
+    if (searchText.isEmpty())
+    {
+        rows = sortedTracks;
+    }
+    else
+    {
+        const std::vector<int>& found{ searchIndex.search(searchText) };
+        const bool extendsRows{ rowsFromSortedTracks
+            && rowsSearchText.isNotEmpty()
+            && searchText.toLowerCase().startsWith(rowsSearchText.toLowerCase()) };
+
+        if (sortColumn == 0)
+        {
+            rows.clear();
+            for (const int track : found)
+            {
+                if (!trackStore.isRemoved(track))
+                {
+                    rows.push_back(track);
+                }
+            }
+        }
+        else if (extendsRows)
+        {
+            rows.erase(std::remove_if(rows.begin(), rows.end(), [&found](int track)
+            {
+                return !std::binary_search(found.begin(), found.end(), track);
+            }), rows.end());
+        }
+        else
+        {
+            matching.assign((size_t)trackStore.size(), false);
+            for (const int track : found)
+            {
+                matching[(size_t)track] = true;
+            }
+
+            rows.clear();
+            for (const int track : sortedTracks)
+            {
+                if (matching[(size_t)track])
+                {
+                    rows.push_back(track);
+                }
+            }
+        }
+    }
+
+    rowsSearchText = searchText;
+    rowsFromSortedTracks = true;
+
+    playlist.updateContent();
+    playlist.repaint();
+}
+
+//A stable sort, so tracks that compare equal stay in the order they were added in.
+//Every value is read from the columns of the trackStore
+void PlaylistComponent::sortTracks()
+{
+    sortedTracks.clear();
+    for (int track = 0; track < trackStore.size(); ++track)
+    {
+        if (!trackStore.isRemoved(track))
+        {
+            sortedTracks.push_back(track);
+        }
+    }
+
+    const int column{ sortColumn };
+    const bool forwards{ sortForwards };
+
+    if (column < 1 || column == 4 || column > 6)
+    {
+        return;
+    }
+
+    const TrackStore& store{ trackStore };
+
+    //Keys are sorted around the Camelot wheel, so the keys that mix well end up next to each other
+    auto getValue = [&store, column](int track)
+    {
+        if (column == 3)
+        {
+            return store.getLength(track);
+        }
+        if (column == 5)
+        {
+            return store.getBpm(track);
+        }
+
+        const int key{ store.getKey(track) };
+        return key < 0 ? -1.0f : (float)KeyAnalyser::getCamelotIndex(key);
+    };
 
-    //Looping through each file in the tracks vector, 
-    //the file name is compared with the text passed as an exact match or 
-    //if it contains the text as a substring
-    for (int i = 0; i < tracks.size(); ++i)
+    std::stable_sort(sortedTracks.begin(), sortedTracks.end(), [&store, &getValue, column, forwards](int first, int second)
     {
-        if (tracks[i].getFileNameWithoutExtension().equalsIgnoreCase(text) 
-            || tracks[i].getFileNameWithoutExtension().containsIgnoreCase(text))
+        int result{ 0 };
+
+        if (column == 1)
+        {
+            result = store.compareTitles(first, second);
+        }
+        else if (column == 2)
         {
-            //if one of the above conditions return true, the respective row is set as selected
-            //content is updated and repaint function is called
-            playlist.selectRow(i, false, false);
-            playlist.updateContent();
-            playlist.repaint();
-        }        
-    }
-}
\ No newline at end of file
+            result = store.comparePaths(first, second);
+        }
+        else
+        {
+            const float firstValue{ getValue(first) };
+            const float secondValue{ getValue(second) };
+
+            if (firstValue != secondValue)
+            {
+                result = firstValue < secondValue ? -1 : 1;
+            }
+        }
+
+        return forwards ? result < 0 : result > 0;
+    });
+}
+
+//The tracks of every batch are shown as soon as the batch is in the library, while the rest of the
+//  folder is still being probed in the background
+void PlaylistComponent::importFolder()
+{
+    if (folderImporter.isImporting())
+    {
+        folderImporter.cancel();
+        return;
+    }
+
+    juce::FileChooser chooser{ "Please select a folder to import..." };
+    if (!chooser.browseForDirectory())
+    {
+        return;
+    }
+
+    juce::Component::SafePointer<PlaylistComponent> safeThis{ this };
+
+    const juce::File folder{ chooser.getResult() };
+    const bool started{ folderImporter.importFolder(folder,
+        [safeThis](const std::vector<FolderImporter::ImportedTrack>& added)
+        {
+            if (safeThis != nullptr)
+            {
+                safeThis->tracksAdded(added);
+            }
+        },
+        [safeThis, folder](const ImportProgress& progress)
+        {
+            if (safeThis == nullptr)
+            {
+                return;
+            }
+
+            safeThis->showImportProgress(progress);
+
+            //From now on files added to the folder show up in the library by themselves
+            if (progress.finished && !progress.cancelled)
+            {
+                safeThis->libraryWatcher.watchFolder(folder);
+            }
+        }) };
+
+    if (started)
+    {
+        importButton.setButtonText("Cancel Import");
+        statusLabel.setText("Looking for audio files...", juce::dontSendNotification);
+    }
+}
+
+void PlaylistComponent::showImportProgress(const ImportProgress& progress)
+{
+    juce::String text{ "Imported " + juce::String(progress.filesDone) + " of " + juce::String(progress.filesFound)
+        + (progress.walkFinished ? "" : "+") + " files, "
+        + juce::String(progress.filesPerSecond, 0) + " files/s" };
+
+    if (progress.finished)
+    {
+        text = juce::String(progress.cancelled ? "Import cancelled after " : "Import finished in ")
+            + juce::String(progress.elapsedSeconds, 1) + " s: "
+            + juce::String(progress.tracksAdded) + " added, "
+            + juce::String(progress.tracksSkipped) + " already in the library, "
+            + juce::String((int)progress.duplicates.size()) + " duplicates left out, "
+            + juce::String(progress.filesFailed) + " could not be read, "
+            + juce::String(progress.filesPerSecond, 0) + " files/s";
+        importButton.setButtonText("Import Folder");
+
+        if (!progress.duplicates.empty())
+        {
+            showDuplicates(progress.duplicates);
+        }
+    }
+
+    statusLabel.setText(text, juce::dontSendNotification);
+}
+
+//The tracks are analysed in the background, and a track loaded on a deck meanwhile is analysed first
+void PlaylistComponent::analyseLibrary()
+{
+    if (analysisEngine->getNumWaiting() > 0)
+    {
+        analysisEngine->cancelBatch();
+        showAnalysisProgress();
+        return;
+    }
+
+    if (analysisEngine->analyseLibrary() == 0)
+    {
+        statusLabel.setText("Every track has already been analysed", juce::dontSendNotification);
+        return;
+    }
+
+    showAnalysisProgress();
+}
+
+void PlaylistComponent::showAnalysisProgress()
+{
+    const int waiting{ analysisEngine->getNumWaiting() };
+
+    if (waiting > 0)
+    {
+        analyseButton.setButtonText("Cancel Analysis");
+        statusLabel.setText("Analysing, " + juce::String(waiting) + " tracks left", juce::dontSendNotification);
+    }
+    else
+    {
+        analyseButton.setButtonText("Analyse Library");
+        statusLabel.setText("Analysis finished", juce::dontSendNotification);
+    }
+}
@@ -16,19 +16,27 @@
 #include "AudioPlayer.h"
 #include "TrackTitle.h"
 #include "WaveformDisplay.h"
+#include "TrackMetadataStore.h"
+#include "LibraryDatabase.h"
+#include "SearchIndex.h"
+#include "TrackStore.h"
+#include "FolderImporter.h"
+#include "AnalysisEngine.h"
+#include "KeyAnalyser.h"
+#include "LibraryWatcher.h"
 
 //==============================================================================
 
-//The playlistComponent that inherits from Component, TableListBoxModel and Button Listener classes
+//The playlistComponent that inherits from Component, TableListBoxModel, Button Listener and ChangeListener classes
 class PlaylistComponent : public juce::Component,
     public juce::TableListBoxModel,
-    public juce::Button::Listener   
+    public juce::Button::Listener,
+    public juce::ChangeListener
 {
 public:
     //Constructor for PlaylistComponent with relevant arguments
     PlaylistComponent(AudioPlayer* _player1, 
                         AudioPlayer* _player2, 
-                        AudioPlayer* _tmp,
                         WaveformDisplay* _display1,
                         WaveformDisplay* _display2,
                         TrackTitle* _title_d1, 
@@ -61,31 +69,106 @@ public:
         bool isRowSelected, 
         juce::Component* existingComponentToUpdate) override;
 
+    //Called when the user clicks on a column header, the rows are sorted by that column
+    void sortOrderChanged(int newSortColumnId, bool isForwards) override;
+
     //Needs to be implemented since we inherit from Button::Listener class
     void buttonClicked(juce::Button* button) override;
 
+    //Called when the metadata store has new track lengths or the analysis engine has new results,
+    //  so the tracks they changed are updated and the playlist is repainted
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
     //A function that enables adding of file to the tracklist
     void addAudioFile(juce::File* audioFile); 
 
-    //A function that reads the playlist and saves the directories to file
-    void savePlaylistToFile();
-
-    //A function to load the directories of the files found in the playlist textfiles
+    //A function to load the tracks of the library. The first time it is run the old playlist text file is imported
     void loadDirectories();
 
-    //A function that lets the user search for a track
+    //A function that lets the user search for a track, only the matching tracks are shown
     void searchTrack(juce::String text);   
 
 private:
-    //A vector of type File is used to store the tracks added to the playlist
-    std::vector<juce::File> tracks;
+    //The button in the last column of a row. The table reuses the buttons of the rows that scroll out
+    //  of view, so the row a button belongs to is updated every time it is reused
+    class LoadButton : public juce::TextButton
+    {
+    public:
+        LoadButton() : juce::TextButton{ "Load Track" } {}
+
+        int row{ 0 };
+    };
+
+    //Rebuilding the rows from the search and the sort order and updating the table.
+    //The tracks are only sorted again when sortNeeded is set
+    void updateRows();
+    //Putting every track that is not removed into sortedTracks, sorted by the current sort column
+    void sortTracks();
+    //Copying the length, tempo and key of a track from its library record into the trackStore
+    void updateColumns(int track);
+    //Updating the columns of the tracks a broadcaster says changed. The tracks are sorted again if
+    //  the rows are sorted by one of the given columns
+    void tracksChanged(const std::vector<juce::uint32>& changed, int firstColumn, int lastColumn);
+
+    //Letting the user choose a folder and importing it, or cancelling the import that is running
+    void importFolder();
+    //Showing the progress of an import under the playlist
+    void showImportProgress(const ImportProgress& progress);
+
+    //Analysing every track of the library that has not been analysed yet, or cancelling the analysis
+    void analyseLibrary();
+    //Showing how many tracks are left to analyse under the playlist
+    void showAnalysisProgress();
+
+    //A function that loads a track into a deck in the background and updates its title and waveform display
+    void loadTrackIntoDeck(juce::File file,
+        AudioPlayer* player,
+        TrackTitle* title,
+        WaveformDisplay* display);
+
+    //Adding a file to the end of the trackStore and to the search index
+    void appendTrack(const juce::File& file, juce::uint32 libraryId);
+    //Showing the tracks that were added to the library by an import or the watcher, and taking out the
+    //  tracks the watcher removed from it
+    void tracksAdded(const std::vector<FolderImporter::ImportedTrack>& added);
+    void tracksRemoved(const std::vector<juce::uint32>& removed);
+    //Telling the user which files were left out of the library because they are duplicates
+    void showDuplicates(const std::vector<DuplicateTrack>& duplicates);
+
+    //The tracks added to the playlist
+    TrackStore trackStore;
+    //The index the search field uses, holding the text of every track in the trackStore
+    SearchIndex searchIndex;
+    //Every track that is not removed in the current sort order, and the track shown in each row of the
+    //  table, which are the tracks of sortedTracks that match the search
+    std::vector<int> sortedTracks;
+    bool sortNeeded{ true };
+    std::vector<int> rows;
+    //One flag per track, set for the tracks that match a new search over sorted rows while they are rebuilt
+    std::vector<bool> matching;
+    //The search the rows were made from, and whether they were made from the current sortedTracks,
+    //  so that typing more only narrows them
+    juce::String rowsSearchText;
+    bool rowsFromSortedTracks{ false };
+    //The text in the search field and the column the rows are sorted by, 0 for the order they were added in
+    juce::String searchText;
+    int sortColumn{ 0 };
+    bool sortForwards{ true };
     //TableListBox object used to display a table used for the playlist
     juce::TableListBox playlist;
 
-    //3 pointers of type Audioplayers
+    //2 pointers of type Audioplayers
     AudioPlayer* player1;
     AudioPlayer* player2;
-    AudioPlayer* tmp_player;
+
+    //The lengths of the tracks, probed in the background and kept between runs
+    juce::SharedResourcePointer<TrackMetadataStore> metadataStore;
+
+    //The library the tracks of the playlist are saved in
+    juce::SharedResourcePointer<LibraryDatabase> library;
+
+    //Finds the tempo and the key of the tracks in the background and stores them in the library
+    juce::SharedResourcePointer<AnalysisEngine> analysisEngine;
     
     //2 pointers of type TrackTitle
     TrackTitle* titled1;
@@ -98,8 +181,20 @@ private:
     //2 Label objects that are used to let the user search for music
     juce::Label searchField;
     juce::Label inputText;
+
+    //The button that imports a whole folder, the label that shows how the import or the analysis is going
+    //  and the importer
+    juce::TextButton importButton{ "Import Folder" };
+    juce::Label statusLabel;
+    FolderImporter folderImporter;
+
+    //The button that analyses the whole library
+    juce::TextButton analyseButton{ "Analyse Library" };
+
+    //Keeps the library and the playlist in step with the files on disk
+    LibraryWatcher libraryWatcher;
     
-    //The text file that is used to store the directories of the tracks in the playlist
+    //The text file the directories of the tracks were stored in before the library, only read to import it
     //It is passed the default directory used by the user to store application data added with the name of the file
     juce::File playlistFile{ juce::File::getSpecialLocation(
         juce::File::SpecialLocationType::userApplicationDataDirectory).getFullPathName() + "\\playlist.txt" };
@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+
+    ReadAheadSource.cpp
+    Created: 17 Oct 2026 2:59:16pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "ReadAheadSource.h"
+
+//The ring is allocated here, on the message thread, and the DiskIOThread starts filling it straight away
+ReadAheadSource::ReadAheadSource(std::unique_ptr<juce::PositionableAudioSource> _input,
+                                 double _sampleRate,
+                                 double bufferSeconds,
+                                 ReadAheadStats& _stats)
+    : input(std::move(_input)),
+      sampleRate(_sampleRate),
+      stats(_stats),
+      totalLength(input->getTotalLength())
+{
+    ringSize = juce::jmax(65536, (int)(bufferSeconds * sampleRate));
+    historySize = (int)(ringSize * historyFraction);
+    ring.setSize(2, ringSize);
+    ring.clear();
+
+    //The input is only ever read by the DiskIOThread, so it is prepared once here
+    input->prepareToPlay(8192, sampleRate);
+
+    position = juce::jmax((juce::int64)0, input->getNextReadPosition());
+    playhead = position;
+    seekTarget = position;
+
+    diskThread->addTimeSliceClient(this);
+}
+
+ReadAheadSource::~ReadAheadSource()
+{
+    //Waits for the DiskIOThread to finish with this source if it is using it right now
+    diskThread->removeTimeSliceClient(this);
+    input->releaseResources();
+}
+
+//==============================================================================
+//Nothing to prepare, the input was prepared when the source was made
+void ReadAheadSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+
+}
+
+//Copying the samples from the ring. Whatever is not in the ring yet is played as silence,
+//  the playhead still moves on so that the deck stays in time, and the DiskIOThread is asked to catch up
+void ReadAheadSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const juce::int64 start{ position };
+    const int numSamples{ bufferToFill.numSamples };
+    const bool isLooping{ looping };
+    int copied{ 0 };
+
+    //The end is read before the start, so the range seen is never bigger than the one in the ring
+    const int epoch{ rangeEpoch.load(std::memory_order_acquire) };
+    const juce::int64 end{ validEnd.load(std::memory_order_acquire) };
+    const juce::int64 begin{ validStart.load(std::memory_order_acquire) };
+
+    if ((epoch & 1) == 0 && start >= begin && start < end)
+    {
+        juce::int64 available{ end - start };
+        if (!isLooping)
+        {
+            available = juce::jmin(available, totalLength - start);
+        }
+        copied = (int)juce::jlimit((juce::int64)0, (juce::int64)numSamples, available);
+
+        //The copy is split where the ring wraps around
+        const int index{ (int)(start % ringSize) };
+        const int first{ juce::jmin(copied, ringSize - index) };
+
+        for (int ch = 0; ch < bufferToFill.buffer->getNumChannels(); ++ch)
+        {
+            const int sourceChannel{ juce::jmin(ch, ring.getNumChannels() - 1) };
+            bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample, ring, sourceChannel, index, first);
+            if (copied > first)
+            {
+                bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample + first, ring, sourceChannel, 0, copied - first);
+            }
+        }
+
+        //If the DiskIOThread started the ring again, or wrote over the first samples, while they were
+        //  being copied, the copy may be torn and is played as silence instead
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (rangeEpoch.load(std::memory_order_relaxed) != epoch || validStart.load(std::memory_order_relaxed) > start)
+        {
+            copied = 0;
+        }
+    }
+
+    if (copied < numSamples)
+    {
+        bufferToFill.buffer->clear(bufferToFill.startSample + copied, numSamples - copied);
+
+        //Silence after the end of a track that does not loop is not an underrun
+        juce::int64 missing{ numSamples - copied };
+        if (!isLooping)
+        {
+            missing = juce::jlimit((juce::int64)0, missing, totalLength - (start + copied));
+        }
+
+        if (missing > 0)
+        {
+            ++stats.underruns;
+            stats.underrunSamples += missing;
+            seekTarget = start + copied;
+        }
+    }
+
+    position = start + numSamples;
+    playhead = position;
+}
+
+void ReadAheadSource::releaseResources()
+{
+
+}
+
+//==============================================================================
+//Called on the audio thread. The DiskIOThread decides whether the target is already buffered
+void ReadAheadSource::setNextReadPosition(juce::int64 newPosition)
+{
+    position = juce::jmax((juce::int64)0, newPosition);
+    playhead = position;
+    seekTarget = position;
+
+    ++stats.seeks;
+
+    if (position >= validStart.load(std::memory_order_acquire) && position < validEnd.load(std::memory_order_acquire))
+    {
+        ++stats.seekHits;
+    }
+}
+
+juce::int64 ReadAheadSource::getNextReadPosition() const
+{
+    return (looping && totalLength > 0) ? position % totalLength : position;
+}
+
+juce::int64 ReadAheadSource::getTotalLength() const
+{
+    return totalLength;
+}
+
+bool ReadAheadSource::isLooping() const
+{
+    return looping;
+}
+
+//When looping is switched off after the track has wrapped, the playhead is brought back inside the track
+void ReadAheadSource::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+
+    if (!shouldLoop && totalLength > 0 && position >= totalLength)
+    {
+        setNextReadPosition(position % totalLength);
+    }
+}
+
+//==============================================================================
+//Keeping the ring filled up to (ring size - history) ahead of the playhead, one chunk at a time.
+//Only this thread changes the valid range, so it reads its own values without any ordering
+int ReadAheadSource::useTimeSlice()
+{
+    const juce::int64 target{ seekTarget.exchange(-1) };
+    juce::int64 start{ validStart.load(std::memory_order_relaxed) };
+    juce::int64 end{ validEnd.load(std::memory_order_relaxed) };
+
+    //A target inside the buffer, or a little after it, is reached by filling on as normal.
+    //Otherwise the ring starts again from a little before the target
+    if (target >= 0 && (target < start || target > end + ringSize / 4))
+    {
+        start = juce::jmax((juce::int64)0, target - (juce::int64)(seekPrerollSeconds * sampleRate));
+        end = start;
+
+        rangeEpoch.fetch_add(1);
+        validStart.store(start, std::memory_order_relaxed);
+        validEnd.store(end, std::memory_order_relaxed);
+        rangeEpoch.fetch_add(1);
+    }
+
+    const juce::int64 fillLimit{ playhead + ringSize - historySize };
+    juce::int64 wanted{ fillLimit - end };
+    if (!looping)
+    {
+        wanted = juce::jmin(wanted, totalLength - end);
+    }
+
+    //Nothing to do, checking again in 5ms
+    if (wanted <= 0)
+    {
+        return 5;
+    }
+
+    const int chunk{ (int)juce::jmin(wanted, (juce::int64)8192) };
+
+    //The oldest samples leave the ring before their place is written over
+    validStart.store(juce::jmax(start, end + chunk - ringSize), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    decodeInto(end, chunk);
+
+    validEnd.store(end + chunk, std::memory_order_release);
+
+    //Coming straight back to fill the next chunk
+    return 0;
+}
+
+//Reading from the input into the ring in pieces that stop where the ring wraps and,
+//  for a looping track, where the track wraps
+void ReadAheadSource::decodeInto(juce::int64 start, int numSamples)
+{
+    int done{ 0 };
+
+    while (done < numSamples)
+    {
+        const juce::int64 streamPosition{ start + done };
+        const juce::int64 trackPosition{ (looping && totalLength > 0) ? streamPosition % totalLength : streamPosition };
+        const int index{ (int)(streamPosition % ringSize) };
+
+        int count{ juce::jmin(numSamples - done, ringSize - index) };
+        if (looping && totalLength > 0)
+        {
+            count = (int)juce::jmin((juce::int64)count, totalLength - trackPosition);
+        }
+
+        if (inputPosition != trackPosition)
+        {
+            input->setNextReadPosition(trackPosition);
+        }
+
+        input->getNextAudioBlock(juce::AudioSourceChannelInfo(&ring, index, count));
+        inputPosition = trackPosition + count;
+        done += count;
+    }
+}
@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    ReadAheadSource.h
+    Created: 17 Oct 2026 2:59:16pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include "DiskIOThread.h"
+
+//==============================================================================
+//The counters of a deck's read-ahead buffer, owned by the AudioPlayer so they add up across tracks.
+//They are written by the audio thread and the DiskIOThread and can be read from anywhere
+struct ReadAheadStats
+{
+    //The number of blocks that found samples missing from the buffer, and how many samples were missing
+    std::atomic<int> underruns{ 0 };
+    std::atomic<juce::int64> underrunSamples{ 0 };
+    //The number of seeks, and how many of them landed inside the buffer (eg. a loop going back)
+    std::atomic<int> seeks{ 0 };
+    std::atomic<int> seekHits{ 0 };
+};
+
+//==============================================================================
+//A PositionableAudioSource that plays a streamed track from a ring buffer filled on the DiskIOThread,
+//  so the track is never decoded inside the audio callback.
+//The DiskIOThread keeps the buffer full ahead of the playhead and keeps part of it as history behind
+//  the playhead, so jumping back for a loop or a short scratch is still read from memory.
+//After a seek outside the buffer it is refilled from a little before the seek target.
+//The audio thread never waits and never takes a lock: if the samples it needs are not there yet it plays
+//  silence and counts an underrun
+class ReadAheadSource : public juce::PositionableAudioSource,
+                        private juce::TimeSliceClient
+{
+public:
+    //Takes ownership of the track's source. The buffer holds bufferSeconds of audio at the track's sample rate
+    ReadAheadSource(std::unique_ptr<juce::PositionableAudioSource> _input,
+                    double _sampleRate,
+                    double bufferSeconds,
+                    ReadAheadStats& _stats);
+    ~ReadAheadSource() override;
+
+    //The 3 functions that need to be implemented since we inherit from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //The functions that need to be implemented since we inherit from PositionableAudioSource
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+    //The default size of the buffer, and the part of it kept behind the playhead
+    static constexpr double defaultBufferSeconds{ 16.0 };
+    static constexpr double historyFraction{ 0.5 };
+    //How much is buffered before the target of a seek, so scrubbing back a little is still a hit
+    static constexpr double seekPrerollSeconds{ 0.25 };
+
+private:
+    //Called on the DiskIOThread to refill the buffer
+    int useTimeSlice() override;
+    //Decodes the samples from validEnd onwards into the ring, on the DiskIOThread
+    void decodeInto(juce::int64 start, int numSamples);
+
+    std::unique_ptr<juce::PositionableAudioSource> input;
+    const double sampleRate;
+    ReadAheadStats& stats;
+
+    //The ring of decoded samples. Sample n of the stream is kept at index n % ring size
+    juce::AudioBuffer<float> ring;
+    int ringSize{ 0 };
+    int historySize{ 0 };
+
+    //The samples that are in the ring, from validStart up to validEnd. The positions keep counting
+    //  past the end of the track when it loops, so a looping track is buffered without a gap.
+    //Only the DiskIOThread changes them. While it fills the ring both only grow: validStart is moved on
+    //  before the oldest samples are written over, and validEnd after the new samples are written
+    std::atomic<juce::int64> validStart{ 0 };
+    std::atomic<juce::int64> validEnd{ 0 };
+    //Increased by the DiskIOThread before and after it starts the ring again somewhere else, so it is odd
+    //  while the range is being moved. The audio thread checks it did not change while it copied
+    std::atomic<int> rangeEpoch{ 0 };
+
+    //The position of the next sample to be played, only changed by the audio thread
+    juce::int64 position{ 0 };
+    //The same position for the DiskIOThread
+    std::atomic<juce::int64> playhead{ 0 };
+    //A position the DiskIOThread should buffer from, or -1
+    std::atomic<juce::int64> seekTarget{ 0 };
+    //The position the input will read from next, only used on the DiskIOThread
+    juce::int64 inputPosition{ -1 };
+
+    std::atomic<bool> looping{ false };
+    const juce::int64 totalLength;
+
+    juce::SharedResourcePointer<DiskIOThread> diskThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadSource)
+};
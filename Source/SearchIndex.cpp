@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    SearchIndex.cpp
+    Created: 17 Oct 2026 3:09:23pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "SearchIndex.h"
+#include <algorithm>
+#include <cstring>
+
+SearchIndex::SearchIndex()
+{
+
+}
+
+SearchIndex::~SearchIndex()
+{
+
+}
+
+//==============================================================================
+//The text is indexed once, when the track is added
+void SearchIndex::addTrack(int trackIndex, const juce::String& text)
+{
+    if (trackIndex != getNumTracks())
+    {
+        DBG("SearchIndex::addTrack tracks should be added in order");
+        return;
+    }
+
+    const std::string lower{ text.toLowerCase().toStdString() };
+    textData.insert(textData.end(), lower.begin(), lower.end());
+    textStarts.push_back(textData.size());
+
+    for (size_t i = 0; i < lower.size(); ++i)
+    {
+        for (int length = 1; length <= maxGramLength && i + length <= lower.size(); ++length)
+        {
+            addPosting(makeKey(lower.data() + i, length), trackIndex);
+        }
+    }
+
+    //A track added while a search is showing is added to its results if it matches
+    if (hasLastQuery && contains(trackIndex, lastQuery))
+    {
+        lastResults.push_back(trackIndex);
+    }
+}
+
+void SearchIndex::clear()
+{
+    textData.clear();
+    textStarts.assign(1, 0);
+    postings.clear();
+    lastQuery.clear();
+    lastResults.clear();
+    hasLastQuery = false;
+}
+
+int SearchIndex::getNumTracks() const
+{
+    return (int)textStarts.size() - 1;
+}
+
+//==============================================================================
+//An empty query matches every track. A query that contains the previous query can only match tracks
+//  that the previous query matched, so only those are checked
+const std::vector<int>& SearchIndex::search(const juce::String& query)
+{
+    const std::string lower{ query.toLowerCase().toStdString() };
+    const bool narrowing{ hasLastQuery && !lastQuery.empty() && lower.find(lastQuery) != std::string::npos };
+    scratch.clear();
+
+    if (lower.empty())
+    {
+        for (int i = 0; i < getNumTracks(); ++i)
+        {
+            scratch.push_back(i);
+        }
+    }
+    else
+    {
+        searchGrams(lower, narrowing ? &lastResults : nullptr, scratch);
+    }
+
+    lastResults.swap(scratch);
+    lastQuery = lower;
+    hasLastQuery = true;
+
+    return lastResults;
+}
+
+//==============================================================================
+//The length goes in the top byte, so n-grams of different lengths never share a key
+juce::uint32 SearchIndex::makeKey(const char* text, int length)
+{
+    juce::uint32 key{ (juce::uint32)length << 24 };
+
+    for (int i = 0; i < length; ++i)
+    {
+        key |= (juce::uint32)(juce::uint8)text[i] << (8 * i);
+    }
+    return key;
+}
+
+//Since tracks are added in order, an n-gram that appears twice in the same text is only recorded once
+//  by checking the end of its list
+void SearchIndex::addPosting(juce::uint32 key, int trackIndex)
+{
+    std::vector<int>& tracks{ postings[key] };
+
+    if (tracks.empty() || tracks.back() != trackIndex)
+    {
+        tracks.push_back(trackIndex);
+    }
+}
+
+//Looking for the first byte of the query with memchr and comparing the rest from there
+bool SearchIndex::contains(int track, const std::string& query) const
+{
+    const size_t length{ textStarts[track + 1] - textStarts[track] };
+
+    if (query.empty())
+    {
+        return true;
+    }
+    if (query.size() > length)
+    {
+        return false;
+    }
+
+    const char* text{ textData.data() + textStarts[track] };
+    const char* last{ text + (length - query.size()) };
+
+    while (text <= last)
+    {
+        text = (const char*)std::memchr(text, query[0], (size_t)(last - text) + 1);
+
+        if (text == nullptr)
+        {
+            return false;
+        }
+
+        if (std::memcmp(text, query.data(), query.size()) == 0)
+        {
+            return true;
+        }
+        ++text;
+    }
+    return false;
+}
+
+void SearchIndex::filter(const std::vector<int>& tracks, const std::string& query, std::vector<int>& result) const
+{
+    for (int track : tracks)
+    {
+        if (contains(track, query))
+        {
+            result.push_back(track);
+        }
+    }
+}
+
+//The lists are intersected starting from the shortest, so the work depends on the rarest n-gram rather
+//  than on the size of the library. Each candidate is looked up in the longer lists with a binary search
+//  that starts where the last one ended. A query longer than an n-gram can have all of its trigrams
+//  in the wrong order, so what is left is checked against the text
+void SearchIndex::searchGrams(const std::string& query, const std::vector<int>* previous, std::vector<int>& result)
+{
+    const size_t gramLength{ juce::jmin(query.size(), (size_t)maxGramLength) };
+    std::vector<const std::vector<int>*> lists;
+
+    if (previous != nullptr)
+    {
+        lists.push_back(previous);
+    }
+
+    for (size_t i = 0; i + gramLength <= query.size(); ++i)
+    {
+        auto entry = postings.find(makeKey(query.data() + i, (int)gramLength));
+
+        if (entry == postings.end())
+        {
+            return;
+        }
+
+        if (std::find(lists.begin(), lists.end(), &entry->second) == lists.end())
+        {
+            lists.push_back(&entry->second);
+        }
+    }
+
+    //A query that is a single n-gram is answered by its list. A longer query made of one trigram repeated,
+    //  eg. "aaaa", also has a single list but still has to be checked against the text
+    if (lists.size() == 1 && previous == nullptr && query.size() == gramLength)
+    {
+        result = *lists[0];
+        return;
+    }
+
+    std::sort(lists.begin(), lists.end(),
+        [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+    candidates.assign(lists[0]->begin(), lists[0]->end());
+
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i)
+    {
+        intersection.clear();
+        auto from = lists[i]->begin();
+
+        for (int track : candidates)
+        {
+            from = std::lower_bound(from, lists[i]->end(), track);
+
+            if (from == lists[i]->end())
+            {
+                break;
+            }
+            if (*from == track)
+            {
+                intersection.push_back(track);
+            }
+        }
+        candidates.swap(intersection);
+    }
+
+    if (query.size() == gramLength)
+    {
+        result.swap(candidates);
+    }
+    else
+    {
+        filter(candidates, query, result);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    SearchIndex.h
+    Created: 17 Oct 2026 3:09:23pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//==============================================================================
+//An n-gram index over the text of the tracks of the playlist, used by the search field.
+//Every track is stored as lower case UTF-8 text, and every run of 1 to 3 bytes of that text points back
+//  to the tracks it appears in. A query of up to 3 bytes is answered straight from its list, a longer query
+//  only looks at the tracks that have all of its trigrams, and a query that extends the previous one
+//  only looks at the previous results.
+//The texts are kept one after the other in a single block, so checking a lot of them stays cache friendly.
+//Tracks are numbered by the caller from 0 upwards and added in that order.
+//It is only used on the message thread
+class SearchIndex
+{
+public:
+    SearchIndex();
+    ~SearchIndex();
+
+    //Adds the text of the next track. The index of the track must be the number of tracks added so far
+    void addTrack(int trackIndex, const juce::String& text);
+    //Removes every track
+    void clear();
+
+    int getNumTracks() const;
+
+    //Returns the tracks whose text contains the query, ignoring case, in ascending order.
+    //The result is valid until the next call that changes the index or searches it
+    const std::vector<int>& search(const juce::String& query);
+
+private:
+    //The longest n-gram that is indexed
+    static constexpr int maxGramLength{ 3 };
+
+    //Packing 1 to 3 bytes into a key
+    static juce::uint32 makeKey(const char* text, int length);
+    //Adding a track to the list of a key, unless it is already at the end of it
+    void addPosting(juce::uint32 key, int trackIndex);
+
+    //Returns true if the text of a track contains the query
+    bool contains(int track, const std::string& query) const;
+    //Narrowing a list of tracks down to the ones whose text contains the query
+    void filter(const std::vector<int>& candidates, const std::string& query, std::vector<int>& result) const;
+    //Finding the tracks that have every n-gram of the query and are in previous, if it is not nullptr,
+    //  then checking each of them
+    void searchGrams(const std::string& query, const std::vector<int>* previous, std::vector<int>& result);
+
+    //The lower case text of every track, one after the other, and where the text of each track starts.
+    //textStarts has one more entry than there are tracks, holding the end of the last text
+    std::vector<char> textData;
+    std::vector<size_t> textStarts{ 0 };
+    //For every n-gram, the tracks it appears in, in ascending order
+    std::unordered_map<juce::uint32, std::vector<int>> postings;
+
+    //The last query and its results, so that typing more narrows them instead of starting again
+    std::string lastQuery;
+    std::vector<int> lastResults;
+    bool hasLastQuery{ false };
+
+    //Scratch lists reused between queries
+    std::vector<int> scratch;
+    std::vector<int> candidates;
+    std::vector<int> intersection;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SearchIndex)
+};
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    SearchIndexTests.cpp
+    Created: 17 Oct 2026 4:01:07pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "SearchIndex.h"
+
+//==============================================================================
+//Checks the answers of the SearchIndex against the texts it was given.
+//It is run from the command line with --run-tests
+class SearchIndexTests : public juce::UnitTest
+{
+public:
+    SearchIndexTests()
+        : juce::UnitTest("SearchIndex", "OtoDecks")
+    {
+    }
+
+    void runTest() override
+    {
+        SearchIndex index;
+        index.addTrack(0, "Aaa Band - Intro");
+        index.addTrack(1, "Aaaa Band - Outro");
+        index.addTrack(2, "Track 000");
+        index.addTrack(3, "Track 0000");
+
+        beginTest("A query of one n-gram is answered from its list");
+        expect(index.search("aaa") == std::vector<int>{ 0, 1 });
+        expect(index.search("000") == std::vector<int>{ 2, 3 });
+
+        //Every trigram of these is the same one, so its list holds tracks that do not contain the query
+        beginTest("A query made of one trigram repeated is checked against the text");
+        expect(index.search("aaaa") == std::vector<int>{ 1 });
+        expect(index.search("0000") == std::vector<int>{ 3 });
+        expect(index.search("00000").empty());
+
+        beginTest("A query that extends the previous one narrows its results");
+        expect(index.search("track") == std::vector<int>{ 2, 3 });
+        expect(index.search("track 0000") == std::vector<int>{ 3 });
+    }
+};
+
+static SearchIndexTests searchIndexTests;
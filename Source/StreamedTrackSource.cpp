@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    StreamedTrackSource.cpp
+    Created: 17 Oct 2026 3:56:06pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "StreamedTrackSource.h"
+
+StreamedTrackSource::StreamedTrackSource(juce::AudioFormatReader* _reader, std::shared_ptr<const PartialTrack> _decoded)
+    : readerSource(_reader, true),
+      decoded(std::move(_decoded))
+{
+    if (decoded != nullptr && (decoded->track == nullptr || decoded->track->buffer.getNumChannels() == 0))
+    {
+        decoded = nullptr;
+    }
+}
+
+StreamedTrackSource::~StreamedTrackSource()
+{
+
+}
+
+//==============================================================================
+void StreamedTrackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    readerSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+}
+
+//Reading the block in pieces: the decoded part is copied, the rest is decoded by the readerSource,
+//  which is only moved when the playhead is not where it stopped last time
+void StreamedTrackSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const juce::int64 totalLength{ getTotalLength() };
+    const juce::int64 decodedLength{ getDecodedLength() };
+    int done{ 0 };
+
+    while (done < bufferToFill.numSamples)
+    {
+        if (looping && totalLength > 0 && position >= totalLength)
+        {
+            position = position % totalLength;
+        }
+
+        const int wanted{ bufferToFill.numSamples - done };
+        const int available{ (int)juce::jlimit((juce::int64)0, (juce::int64)wanted, totalLength - position) };
+
+        //At the end of a track that does not loop, the rest of the block is silence
+        if (available <= 0)
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + done, wanted);
+            position += wanted;
+            break;
+        }
+
+        const juce::AudioSourceChannelInfo part{ bufferToFill.buffer, bufferToFill.startSample + done, available };
+
+        if (position < decodedLength)
+        {
+            const int count{ (int)juce::jmin((juce::int64)available, decodedLength - position) };
+            copyDecoded(juce::AudioSourceChannelInfo(bufferToFill.buffer, part.startSample, count));
+            done += count;
+            position += count;
+            continue;
+        }
+
+        if (readerSource.getNextReadPosition() != position)
+        {
+            readerSource.setNextReadPosition(position);
+        }
+        readerSource.getNextAudioBlock(part);
+
+        done += available;
+        position += available;
+    }
+}
+
+void StreamedTrackSource::releaseResources()
+{
+    readerSource.releaseResources();
+}
+
+void StreamedTrackSource::copyDecoded(const juce::AudioSourceChannelInfo& info)
+{
+    const juce::AudioBuffer<float>& samples{ decoded->track->buffer };
+    const int numSourceChannels{ samples.getNumChannels() };
+
+    for (int channel = 0; channel < info.buffer->getNumChannels(); ++channel)
+    {
+        info.buffer->copyFrom(channel,
+            info.startSample,
+            samples,
+            juce::jmin(channel, numSourceChannels - 1),
+            (int)position,
+            info.numSamples);
+    }
+}
+
+juce::int64 StreamedTrackSource::getDecodedLength() const
+{
+    if (decoded == nullptr)
+    {
+        return 0;
+    }
+
+    return juce::jmin(decoded->decodedLength.load(std::memory_order_acquire), (juce::int64)decoded->track->buffer.getNumSamples());
+}
+
+//==============================================================================
+void StreamedTrackSource::setNextReadPosition(juce::int64 newPosition)
+{
+    position = juce::jmax((juce::int64)0, newPosition);
+}
+
+juce::int64 StreamedTrackSource::getNextReadPosition() const
+{
+    const juce::int64 totalLength{ getTotalLength() };
+
+    return (looping && totalLength > 0) ? position % totalLength : position;
+}
+
+juce::int64 StreamedTrackSource::getTotalLength() const
+{
+    return readerSource.getTotalLength();
+}
+
+bool StreamedTrackSource::isLooping() const
+{
+    return looping;
+}
+
+void StreamedTrackSource::setLooping(bool shouldLoop)
+{
+    looping = shouldLoop;
+}
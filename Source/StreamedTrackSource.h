@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    StreamedTrackSource.h
+    Created: 17 Oct 2026 3:56:06pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include "DecodedTrackCache.h"
+
+//==============================================================================
+//A PositionableAudioSource that streams a track from its reader, except for the start of the track that
+//  is already decoded. That part is copied from memory, so the samples decoded while loading are played
+//  instead of being thrown away and decoded again.
+//The decoded part can grow while the track plays, when it is the buffer a decode pass of the TrackLoader
+//  is filling, so once the pass has got past the playhead the track is no longer decoded twice
+class StreamedTrackSource : public juce::PositionableAudioSource
+{
+public:
+    //Takes ownership of the reader. The decoded start of the track is in decoded, which can be nullptr
+    StreamedTrackSource(juce::AudioFormatReader* _reader, std::shared_ptr<const PartialTrack> _decoded);
+    ~StreamedTrackSource() override;
+
+    //The 3 functions that need to be implemented since we inherit from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //The functions that need to be implemented since we inherit from PositionableAudioSource
+    void setNextReadPosition(juce::int64 newPosition) override;
+    juce::int64 getNextReadPosition() const override;
+    juce::int64 getTotalLength() const override;
+    bool isLooping() const override;
+    void setLooping(bool shouldLoop) override;
+
+private:
+    //Copying decoded samples into the output, a mono track into every output channel
+    void copyDecoded(const juce::AudioSourceChannelInfo& info);
+    //The number of samples at the start of the track that can be copied, read once per block
+    juce::int64 getDecodedLength() const;
+
+    //Decodes everything after the decoded part. It never loops by itself, the looping is done here
+    juce::AudioFormatReaderSource readerSource;
+
+    //The decoded start of the track, growing while a decode pass fills it
+    std::shared_ptr<const PartialTrack> decoded;
+
+    //The position of the next sample to be read
+    juce::int64 position{ 0 };
+
+    //True if the source goes back to the start when it reaches the end
+    bool looping{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamedTrackSource)
+};
@@ -0,0 +1,373 @@
+/*
+  ==============================================================================
+
+    TimeStretchAudioSource.cpp
+    Created: 17 Oct 2026 2:48:15pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "TimeStretchAudioSource.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define OTODECKS_STRETCH_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+ #include <arm_neon.h>
+ #define OTODECKS_STRETCH_NEON 1
+#endif
+
+TimeStretchAudioSource::TimeStretchAudioSource(juce::AudioSource* _input)
+    : input(_input)
+{
+
+}
+
+TimeStretchAudioSource::~TimeStretchAudioSource()
+{
+
+}
+
+//==============================================================================
+void TimeStretchAudioSource::setTempo(double ratio)
+{
+    tempo = juce::jlimit(minTempo, maxTempo, ratio);
+}
+
+void TimeStretchAudioSource::setQuality(Quality newQuality)
+{
+    quality = (int)newQuality;
+}
+
+TimeStretchAudioSource::Quality TimeStretchAudioSource::getQuality() const
+{
+    return (Quality)quality.load();
+}
+
+void TimeStretchAudioSource::reset()
+{
+    resetRequested = true;
+}
+
+const std::atomic<double>& TimeStretchAudioSource::getCpuLoad() const
+{
+    return cpuLoad;
+}
+
+const std::atomic<double>& TimeStretchAudioSource::getPeakBlockMicroseconds() const
+{
+    return peakMicroseconds;
+}
+
+//==============================================================================
+//Allocating every buffer for the largest settings (high quality), so that switching quality
+//on the audio thread never allocates
+void TimeStretchAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
+{
+    input->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+
+    maxWindowSize = juce::nextPowerOfTwo((int)(currentSampleRate * 0.04));
+    maxTolerance = maxWindowSize / 4;
+
+    const int capacity{ 3 * maxWindowSize + 2 * maxTolerance + (int)std::ceil(maxTempo * maxWindowSize / 2) };
+
+    inputBuffer.setSize(numChannels, capacity);
+    monoBuffer.setSize(1, capacity);
+    overlap.setSize(numChannels, maxWindowSize / 2);
+    output.setSize(numChannels, maxWindowSize / 2);
+    window.allocate((size_t)maxWindowSize, true);
+
+    appliedQuality = -1;
+    resetRequested = true;
+}
+
+//Serving the block from the stretched output, making new frames whenever it runs out
+void TimeStretchAudioSource::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    const juce::int64 startTicks{ juce::Time::getHighResolutionTicks() };
+    inputTicks = 0;
+
+    if (resetRequested.exchange(false) || quality != appliedQuality)
+    {
+        applySettings();
+    }
+
+    const int numOutputChannels{ juce::jmin(numChannels, bufferToFill.buffer->getNumChannels()) };
+    int done{ 0 };
+
+    while (done < bufferToFill.numSamples)
+    {
+        if (outputRead == outputFill && !produceFrame())
+        {
+            bufferToFill.buffer->clear(bufferToFill.startSample + done, bufferToFill.numSamples - done);
+            break;
+        }
+
+        const int count{ juce::jmin(outputFill - outputRead, bufferToFill.numSamples - done) };
+
+        for (int ch = 0; ch < numOutputChannels; ++ch)
+        {
+            bufferToFill.buffer->copyFrom(ch, bufferToFill.startSample + done, output, ch, outputRead, count);
+        }
+
+        outputRead += count;
+        done += count;
+    }
+
+    //Any extra output channels are left silent
+    for (int ch = numChannels; ch < bufferToFill.buffer->getNumChannels(); ++ch)
+    {
+        bufferToFill.buffer->clear(ch, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+
+    //Timing only the stretching, the time spent reading the input belongs to the input
+    const double seconds{ juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks - inputTicks) };
+    const double blockSeconds{ bufferToFill.numSamples / currentSampleRate };
+
+    if (blockSeconds > 0.0)
+    {
+        cpuLoad = 0.9 * cpuLoad + 0.1 * (seconds / blockSeconds);
+    }
+    peakMicroseconds = juce::jmax(seconds * 1.0e6, peakMicroseconds * 0.999);
+}
+
+void TimeStretchAudioSource::releaseResources()
+{
+    input->releaseResources();
+
+    inputBuffer.setSize(0, 0);
+    monoBuffer.setSize(0, 0);
+    overlap.setSize(0, 0);
+    output.setSize(0, 0);
+    window.free();
+}
+
+//==============================================================================
+//Live uses ~20ms frames and a +/- 1/8 frame search on every 4th sample,
+//high quality uses ~40ms frames and a +/- 1/4 frame search on every 2nd sample.
+//Both refine the best match to the exact sample
+void TimeStretchAudioSource::applySettings()
+{
+    appliedQuality = quality;
+
+    if ((Quality)appliedQuality == Quality::high)
+    {
+        windowSize = maxWindowSize;
+        tolerance = maxTolerance;
+        candidateStep = 2;
+    }
+    else
+    {
+        windowSize = juce::nextPowerOfTwo((int)(currentSampleRate * 0.02));
+        tolerance = windowSize / 8;
+        candidateStep = 4;
+    }
+
+    synthesisHop = windowSize / 2;
+
+    //A periodic Hann window, two of them overlapping by half add up to exactly 1
+    for (int i = 0; i < windowSize; ++i)
+    {
+        window[i] = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float)i / (float)windowSize);
+    }
+
+    overlap.clear();
+    output.clear();
+    inputFill = 0;
+    outputRead = 0;
+    outputFill = 0;
+    analysisPosition = 0.0;
+    previousPosition = 0;
+    hasPreviousFrame = false;
+}
+
+//Cutting the next frame out of the input, windowing it and adding it to the second half of the previous frame
+bool TimeStretchAudioSource::produceFrame()
+{
+    const int nominal{ (int)analysisPosition };
+
+    while (inputFill < nominal + tolerance + windowSize)
+    {
+        if (!pullInput())
+        {
+            return false;
+        }
+    }
+
+    const int best{ hasPreviousFrame ? findBestOffset(nominal) : nominal };
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* frame{ inputBuffer.getReadPointer(ch, best) };
+        float* out{ output.getWritePointer(ch) };
+        float* tail{ overlap.getWritePointer(ch) };
+
+        juce::FloatVectorOperations::multiply(out, frame, window, synthesisHop);
+        juce::FloatVectorOperations::add(out, tail, synthesisHop);
+        juce::FloatVectorOperations::multiply(tail, frame + synthesisHop, window + synthesisHop, synthesisHop);
+    }
+
+    outputRead = 0;
+    outputFill = synthesisHop;
+
+    previousPosition = best;
+    hasPreviousFrame = true;
+    analysisPosition += synthesisHop * tempo.load();
+
+    compactInput();
+
+    return true;
+}
+
+//Reading up to one frame of the input onto the end of the input buffer
+bool TimeStretchAudioSource::pullInput()
+{
+    const int space{ inputBuffer.getNumSamples() - inputFill };
+
+    if (space <= 0)
+    {
+        return false;
+    }
+
+    const int count{ juce::jmin(space, windowSize) };
+
+    const juce::int64 startTicks{ juce::Time::getHighResolutionTicks() };
+    input->getNextAudioBlock(juce::AudioSourceChannelInfo(&inputBuffer, inputFill, count));
+    inputTicks += juce::Time::getHighResolutionTicks() - startTicks;
+
+    //The search works on a mono mix of the channels
+    float* mono{ monoBuffer.getWritePointer(0, inputFill) };
+    juce::FloatVectorOperations::copy(mono, inputBuffer.getReadPointer(0, inputFill), count);
+    for (int ch = 1; ch < numChannels; ++ch)
+    {
+        juce::FloatVectorOperations::add(mono, inputBuffer.getReadPointer(ch, inputFill), count);
+    }
+    juce::FloatVectorOperations::multiply(mono, 1.0f / numChannels, count);
+
+    inputFill += count;
+
+    return true;
+}
+
+//Comparing the natural continuation of the previous frame with the start of every candidate frame
+//around the nominal position, first on a coarse grid and then sample by sample around the best one
+int TimeStretchAudioSource::findBestOffset(int nominal) const
+{
+    const float* mono{ monoBuffer.getReadPointer(0) };
+    const float* reference{ mono + previousPosition + synthesisHop };
+
+    const int lowest{ juce::jmax(0, nominal - tolerance) };
+    const int highest{ nominal + tolerance };
+
+    int best{ juce::jmax(0, nominal) };
+    float bestScore{ -1.0e30f };
+
+    for (int candidate = lowest; candidate <= highest; candidate += candidateStep)
+    {
+        const float score{ correlate(reference, mono + candidate, synthesisHop) };
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = candidate;
+        }
+    }
+
+    const int coarseBest{ best };
+    const int refineFrom{ juce::jmax(lowest, coarseBest - candidateStep + 1) };
+    const int refineTo{ juce::jmin(highest, coarseBest + candidateStep - 1) };
+
+    for (int candidate = refineFrom; candidate <= refineTo; ++candidate)
+    {
+        const float score{ correlate(reference, mono + candidate, synthesisHop) };
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = candidate;
+        }
+    }
+
+    return best;
+}
+
+//Moving what is still needed to the start of the input buffer
+void TimeStretchAudioSource::compactInput()
+{
+    const int keepFrom{ juce::jmin(inputFill, juce::jmin(previousPosition + synthesisHop, (int)analysisPosition - tolerance)) };
+
+    if (keepFrom <= 0)
+    {
+        return;
+    }
+
+    const int remaining{ inputFill - keepFrom };
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* data{ inputBuffer.getWritePointer(ch) };
+        std::memmove(data, data + keepFrom, sizeof(float) * (size_t)remaining);
+    }
+
+    float* mono{ monoBuffer.getWritePointer(0) };
+    std::memmove(mono, mono + keepFrom, sizeof(float) * (size_t)remaining);
+
+    inputFill = remaining;
+    previousPosition -= keepFrom;
+    analysisPosition -= keepFrom;
+}
+
+//The dot product of a and b divided by the energy of b, so that loud candidates are not favoured.
+//This runs for every candidate of every frame, so it is written with SSE or NEON intrinsics
+float TimeStretchAudioSource::correlate(const float* a, const float* b, int numSamples)
+{
+    float dot{ 0.0f };
+    float energy{ 0.0f };
+    int i{ 0 };
+
+   #if OTODECKS_STRETCH_SSE
+    __m128 dotSum{ _mm_setzero_ps() };
+    __m128 energySum{ _mm_setzero_ps() };
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const __m128 va{ _mm_loadu_ps(a + i) };
+        const __m128 vb{ _mm_loadu_ps(b + i) };
+        dotSum = _mm_add_ps(dotSum, _mm_mul_ps(va, vb));
+        energySum = _mm_add_ps(energySum, _mm_mul_ps(vb, vb));
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, dotSum);
+    dot = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_store_ps(lanes, energySum);
+    energy = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+   #elif OTODECKS_STRETCH_NEON
+    float32x4_t dotSum{ vdupq_n_f32(0.0f) };
+    float32x4_t energySum{ vdupq_n_f32(0.0f) };
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        const float32x4_t va{ vld1q_f32(a + i) };
+        const float32x4_t vb{ vld1q_f32(b + i) };
+        dotSum = vmlaq_f32(dotSum, va, vb);
+        energySum = vmlaq_f32(energySum, vb, vb);
+    }
+
+    float lanes[4];
+    vst1q_f32(lanes, dotSum);
+    dot = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    vst1q_f32(lanes, energySum);
+    energy = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+   #endif
+
+    for (; i < numSamples; ++i)
+    {
+        dot += a[i] * b[i];
+        energy += b[i] * b[i];
+    }
+
+    return dot / std::sqrt(energy + 1.0e-9f);
+}
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    TimeStretchAudioSource.h
+    Created: 17 Oct 2026 2:48:15pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+//==============================================================================
+//An AudioSource that changes the tempo of its input without changing its pitch (key-lock).
+//It uses WSOLA (waveform similarity overlap-add): the input is cut into overlapping Hann windowed frames,
+//  read at a rate set by the tempo and written at a fixed rate, and each frame is shifted by a few samples
+//  to the position where it lines up best with the previous one so that the seams do not phase.
+//The search for that position is the expensive part and is done with SSE or NEON where available.
+//Everything is allocated in prepareToPlay, so nothing is allocated on the audio thread
+class TimeStretchAudioSource : public juce::AudioSource
+{
+public:
+    //The quality of the stretching. Live uses short frames and a coarse search,
+    //high quality uses longer frames and a wider, finer search
+    enum class Quality
+    {
+        live,
+        high
+    };
+
+    //The source is not owned, it should outlive this object
+    TimeStretchAudioSource(juce::AudioSource* _input);
+    ~TimeStretchAudioSource() override;
+
+    //Setting the tempo as a ratio of the original tempo, limited between minTempo and maxTempo
+    void setTempo(double ratio);
+    //Choosing the quality, this resets the stretcher at the next block
+    void setQuality(Quality newQuality);
+    Quality getQuality() const;
+
+    //Throwing away everything buffered, eg. after a seek or when key-lock is switched on
+    void reset();
+
+    //The 3 functions that need to be implemented since we inherit from AudioSource
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+    void releaseResources() override;
+
+    //The average time spent stretching one block (without the time spent in the input) as a
+    //  fraction of the duration of the block, and the longest time spent on one block in microseconds.
+    //They are atomics written on the audio thread, so the AudioPerformanceMonitor can show them
+    const std::atomic<double>& getCpuLoad() const;
+    const std::atomic<double>& getPeakBlockMicroseconds() const;
+
+    //The range of tempos the stretcher accepts. The AudioPlayer plays resampled outside it
+    static constexpr double minTempo{ 0.25 };
+    static constexpr double maxTempo{ 4.0 };
+    static bool isTempoInRange(double ratio) { return ratio >= minTempo && ratio <= maxTempo; }
+
+    //The number of channels stretched
+    static constexpr int numChannels{ 2 };
+
+private:
+    //Applying the quality settings for the current sample rate and clearing the buffers
+    void applySettings();
+    //Making one output frame of synthesisHop samples
+    bool produceFrame();
+    //Reading more of the input into the input buffer, returns false if the buffer is full
+    bool pullInput();
+    //Finding the start of the frame, around the nominal position, that lines up best with the previous frame
+    int findBestOffset(int nominal) const;
+    //Dropping the part of the input buffer that will never be used again
+    void compactInput();
+
+    //Returns the normalised cross-correlation of two runs of samples
+    static float correlate(const float* a, const float* b, int numSamples);
+
+    juce::AudioSource* input;
+
+    //The settings requested by the GUI thread, applied on the audio thread
+    std::atomic<double> tempo{ 1.0 };
+    std::atomic<int> quality{ (int)Quality::live };
+    std::atomic<bool> resetRequested{ true };
+
+    //The settings in use on the audio thread
+    double currentSampleRate{ 44100.0 };
+    int appliedQuality{ -1 };
+    int windowSize{ 1024 };
+    int synthesisHop{ 512 };
+    int tolerance{ 128 };
+    int candidateStep{ 4 };
+
+    //The largest settings, used to size the buffers
+    int maxWindowSize{ 0 };
+    int maxTolerance{ 0 };
+
+    //The input waiting to be stretched and its mono mix, used for the search
+    juce::AudioBuffer<float> inputBuffer;
+    juce::AudioBuffer<float> monoBuffer;
+    int inputFill{ 0 };
+
+    //The Hann window, the second half of the previous frame and the finished output
+    juce::HeapBlock<float> window;
+    juce::AudioBuffer<float> overlap;
+    juce::AudioBuffer<float> output;
+    int outputRead{ 0 };
+    int outputFill{ 0 };
+
+    //Where the next frame should start in the input buffer and where the previous one started.
+    //Only the second half of the previous frame is kept, so previousPosition can be negative
+    double analysisPosition{ 0.0 };
+    int previousPosition{ 0 };
+    bool hasPreviousFrame{ false };
+
+    //The ticks spent reading the input during the current block, so they can be left out of the timing
+    juce::int64 inputTicks{ 0 };
+
+    //The timing of the last blocks, written on the audio thread and read by the GUI
+    std::atomic<double> cpuLoad{ 0.0 };
+    std::atomic<double> peakMicroseconds{ 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretchAudioSource)
+};
@@ -0,0 +1,672 @@
+/*
+  ==============================================================================
+
+    TrackLoader.cpp
+    Created: 17 Oct 2026 11:40:05am
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "TrackLoader.h"
+#include "CachedTrackSource.h"
+#include "MappedTrackSource.h"
+#include "StreamedTrackSource.h"
+#include <vector>
+
+//==============================================================================
+//The job that opens, probes and pre-decodes a single track on a worker thread
+class TrackLoader::LoadJob : public juce::ThreadPoolJob
+{
+public:
+    LoadJob(TrackLoader& _owner,
+            juce::AudioFormatManager& _formatManager,
+            juce::URL _audioURL,
+            ProgressCallback _onProgress,
+            CompletionCallback _onComplete)
+        : juce::ThreadPoolJob("Track loader"),
+          owner(_owner),
+          formatManager(_formatManager),
+          audioURL(_audioURL),
+          onProgress(std::move(_onProgress)),
+          onComplete(std::move(_onComplete))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        auto track = std::make_shared<LoadedTrack>();
+        track->url = audioURL;
+
+        reportProgress(0.0f);
+
+        if (audioURL.isLocalFile())
+        {
+            const juce::File file{ audioURL.getLocalFile() };
+
+            //Uncompressed files are played straight from a memory-mapped view of the file,
+            //  so nothing has to be decoded or copied into the cache.
+            //They are tried first, since they never go into the cache and would only count a miss there
+            std::unique_ptr<MappedTrackSource> mapped{ MappedTrackSource::createFor(formatManager, file) };
+
+            if (mapped != nullptr)
+            {
+                track->sampleRate = mapped->getSampleRate();
+                track->lengthInSeconds = mapped->getTotalLength() / mapped->getSampleRate();
+                track->numChannels = mapped->getNumChannels();
+                track->source = std::move(mapped);
+                track->loadedOk = true;
+                track->memoryMapped = true;
+
+                finish(track);
+                return jobHasFinished;
+            }
+
+            //A track that was decoded before is played straight from memory, so the load is instant
+            std::shared_ptr<const DecodedTrack> decoded{ owner.getCache().find(DecodedTrackCache::makeKey(file)) };
+
+            if (decoded != nullptr)
+            {
+                track->sampleRate = decoded->sampleRate;
+                track->numChannels = decoded->buffer.getNumChannels();
+                track->lengthInSeconds = decoded->buffer.getNumSamples() / decoded->sampleRate;
+                track->source.reset(new CachedTrackSource(decoded));
+                track->loadedOk = true;
+                track->fromCache = true;
+
+                finish(track);
+                return jobHasFinished;
+            }
+        }
+
+        //Opening the file and letting the format manager find a reader that understands it
+        juce::AudioFormatReader* reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+
+        if (reader != nullptr)
+        {
+            //Probing the header of the file
+            track->sampleRate = reader->sampleRate;
+            track->numChannels = (int)reader->numChannels;
+            if (reader->sampleRate > 0)
+            {
+                track->lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
+            }
+            reportProgress(0.1f);
+
+            //The whole track is decoded once in the background, into the cache so the next load is instant,
+            //  and for the analysis and the waveform of the track.
+            //Tracks that would not fit in the cache are left to be streamed and get no pass
+            const size_t size{ (size_t)reader->numChannels * (size_t)reader->lengthInSamples * sizeof(float) };
+            const bool decodeWhole{ audioURL.isLocalFile()
+                && reader->numChannels > 0
+                && reader->lengthInSamples > 0
+                && reader->lengthInSamples <= std::numeric_limits<int>::max()
+                && size <= owner.getCache().getMemoryBudget() };
+
+            //The pass is reserved before anything is allocated, so only the job that owns a new pass
+            //  makes a buffer for the whole track. A deck loading a track another deck is decoding
+            //  plays from the buffer of that pass
+            std::shared_ptr<PartialTrack> running;
+            const bool ownsPass{ decodeWhole && owner.reserveDecodePass(audioURL.getLocalFile(), running) };
+
+            //Decoding the first seconds of the track. This primes the decoder (eg. the mp3 frame
+            //  index and the file system cache), and the decoded seconds are played from memory
+            //  by the source, so the first blocks on the audio thread are only a copy.
+            //When this job owns the pass they are decoded into a buffer for the whole track, which the pass
+            //  fills from where they end while the deck plays from it
+            auto start = std::make_shared<PartialTrack>();
+            start->track = std::make_shared<DecodedTrack>();
+            preDecode(*reader, *start, ownsPass ? reader->lengthInSamples : 0);
+
+            std::shared_ptr<PartialTrack> playing{ start };
+            if (ownsPass)
+            {
+                owner.startDecodePass(formatManager, audioURL.getLocalFile(), start);
+            }
+            else if (running != nullptr)
+            {
+                playing = running;
+            }
+
+            track->source.reset(new StreamedTrackSource(reader, playing));
+            track->loadedOk = true;
+        }
+        else
+        {
+            DBG("TrackLoader::LoadJob could not open " << audioURL.toString(false));
+        }
+
+        finish(track);
+        return jobHasFinished;
+    }
+
+private:
+    //Handing the finished track to the message thread
+    void finish(std::shared_ptr<LoadedTrack> track)
+    {
+        reportProgress(1.0f);
+
+        auto callback = onComplete;
+        juce::MessageManager::callAsync([callback, track]
+        {
+            if (callback != nullptr)
+            {
+                callback(track);
+            }
+        });
+    }
+
+    //Reading the first few seconds of the track in chunks into decoded, reporting the progress as it goes.
+    //The buffer is made bufferLength samples long if that is longer than the part decoded.
+    //Fewer samples than asked for are decoded if the job was stopped
+    void preDecode(juce::AudioFormatReader& reader, PartialTrack& decoded, juce::int64 bufferLength)
+    {
+        const int chunkSize{ 8192 };
+        const juce::int64 samplesToDecode{ juce::jmax((juce::int64)0, juce::jmin(reader.lengthInSamples,
+            (juce::int64)(reader.sampleRate * TrackLoader::preDecodeSeconds))) };
+
+        juce::AudioBuffer<float>& buffer{ decoded.track->buffer };
+        decoded.track->sampleRate = reader.sampleRate;
+        buffer.setSize((int)juce::jmax(1u, reader.numChannels), (int)juce::jmax(samplesToDecode, bufferLength));
+
+        juce::int64 pos{ 0 };
+        for (; pos < samplesToDecode && !shouldExit(); pos += chunkSize)
+        {
+            const int numSamples{ (int)juce::jmin((juce::int64)chunkSize, samplesToDecode - pos) };
+            reader.read(&buffer, (int)pos, numSamples, pos, true, true);
+
+            reportProgress(0.1f + 0.9f * (float)(pos + numSamples) / (float)samplesToDecode);
+        }
+
+        decoded.decodedLength.store(juce::jmin(pos, samplesToDecode), std::memory_order_release);
+    }
+
+    //Sending the progress to the message thread
+    void reportProgress(float progress)
+    {
+        if (onProgress == nullptr)
+        {
+            return;
+        }
+
+        auto callback = onProgress;
+        juce::MessageManager::callAsync([callback, progress] { callback(progress); });
+    }
+
+    TrackLoader& owner;
+    juce::AudioFormatManager& formatManager;
+    juce::URL audioURL;
+    ProgressCallback onProgress;
+    CompletionCallback onComplete;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoadJob)
+};
+
+//==============================================================================
+//A consumer of a decode pass and how far it was fed.
+//It is run by jobs on the feed pool, one at a time: the pass wakes the feed whenever it decoded a chunk, and
+//  a job is only added when none is scheduled yet. The job feeds everything decoded by then and ends, so a
+//  slow consumer is fed bigger blocks and never holds up the pass
+class TrackLoader::Feed
+{
+public:
+    Feed(std::shared_ptr<const PartialTrack> _decoded, std::shared_ptr<DecodeConsumer> _consumer)
+        : decoded(std::move(_decoded)),
+          consumer(std::move(_consumer))
+    {
+    }
+
+    //Called by the pass after it decoded more, and with passEnded set once it decoded its last chunk or stopped.
+    //Returns true if a job has to be added to run the feed, false if one is already scheduled
+    bool wake(bool passEnded, bool passCompleted)
+    {
+        const juce::ScopedLock sl(lock);
+
+        if (passEnded)
+        {
+            ended = true;
+            completed = passCompleted;
+        }
+
+        if (scheduled || consumerFinished)
+        {
+            return false;
+        }
+        scheduled = true;
+        return true;
+    }
+
+    //Called by a job of the feed pool. Feeds the consumer everything decoded so far, preparing it first if
+    //  it is new, and finishes it once the pass has ended and every block was fed.
+    //The decoded length is checked again under the lock, so a chunk the pass decoded while the job was
+    //  ending is either fed here or wakes a new job
+    void run()
+    {
+        const juce::AudioBuffer<float>& buffer{ decoded->track->buffer };
+
+        if (position < 0)
+        {
+            consumer->prepare(decoded->track->sampleRate, buffer.getNumChannels(), buffer.getNumSamples());
+            position = 0;
+        }
+
+        for (;;)
+        {
+            const juce::int64 available{ decoded->decodedLength.load(std::memory_order_acquire) };
+
+            if (position < available)
+            {
+                std::vector<const float*> channels((size_t)buffer.getNumChannels());
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                {
+                    channels[(size_t)ch] = buffer.getReadPointer(ch, (int)position);
+                }
+
+                consumer->process(channels.data(), buffer.getNumChannels(), (int)(available - position));
+                position = available;
+            }
+
+            bool finish{ false };
+            bool finishedCompleted{ false };
+            {
+                const juce::ScopedLock sl(lock);
+
+                if (position < decoded->decodedLength.load(std::memory_order_acquire))
+                {
+                    continue;
+                }
+
+                scheduled = false;
+                if (ended)
+                {
+                    finish = true;
+                    finishedCompleted = completed;
+                    consumerFinished = true;
+                }
+            }
+
+            if (finish)
+            {
+                consumer->finished(finishedCompleted);
+            }
+            return;
+        }
+    }
+
+private:
+    std::shared_ptr<const PartialTrack> decoded;
+    std::shared_ptr<DecodeConsumer> consumer;
+
+    //The number of samples fed so far, -1 before the consumer is prepared. Only used by the jobs
+    juce::int64 position{ -1 };
+
+    //Whether a job is scheduled, whether the pass has ended and how, and whether the consumer was finished
+    juce::CriticalSection lock;
+    bool scheduled{ false };
+    bool ended{ false };
+    bool completed{ false };
+    bool consumerFinished{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Feed)
+};
+
+//==============================================================================
+//The job that decodes a whole track into float PCM, adds it to the DecodedTrackCache and wakes the feeds
+//  of every consumer that joined it.
+//It carries on from the start the LoadJob decoded, into the same buffer, which the deck plays from as it
+//  fills. The consumers are fed from that buffer too, so a consumer that joins late is first fed every
+//  chunk it missed without decoding it again.
+//Consumers only join under the lock
+class TrackLoader::DecodePassJob : public juce::ThreadPoolJob
+{
+public:
+    DecodePassJob(TrackLoader& _owner,
+                  juce::AudioFormatManager& _formatManager,
+                  juce::File _file,
+                  juce::String _key,
+                  std::shared_ptr<PartialTrack> _decoded)
+        : juce::ThreadPoolJob("Track decode pass"),
+          owner(_owner),
+          formatManager(_formatManager),
+          file(_file),
+          key(_key),
+          decoded(std::move(_decoded))
+    {
+    }
+
+    //The track the pass is filling
+    std::shared_ptr<PartialTrack> getDecoded() const
+    {
+        return decoded;
+    }
+
+    //Called by the loader under its lock, so the job cannot finish while a consumer is being added.
+    //The feed is woken straight away, so it is fed what was decoded so far
+    bool join(std::shared_ptr<DecodeConsumer> consumer)
+    {
+        const juce::ScopedLock sl(joinLock);
+
+        if (closed)
+        {
+            return false;
+        }
+
+        auto feed = std::make_shared<Feed>(decoded, consumer);
+        feeds.push_back(feed);
+
+        if (feed->wake(false, false))
+        {
+            owner.addFeedJob(feed);
+        }
+        return true;
+    }
+
+    JobStatus runJob() override
+    {
+        const bool completed{ decode() };
+        int numFed{ 0 };
+
+        //Once closed no consumer can join, so the feeds ended below are the last ones
+        {
+            const juce::ScopedLock sl(joinLock);
+            closed = true;
+
+            numFed = completed ? (int)feeds.size() : 0;
+            wakeFeeds(true, completed);
+        }
+
+        owner.decodePassFinished(key, completed ? decodeMilliseconds : 0.0, numFed);
+
+        return jobHasFinished;
+    }
+
+private:
+    //Returns true if the whole track was decoded and added to the cache
+    bool decode()
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader{ formatManager.createReaderFor(file) };
+        juce::AudioBuffer<float>& buffer{ decoded->track->buffer };
+
+        if (reader == nullptr
+            || reader->lengthInSamples != buffer.getNumSamples()
+            || (int)reader->numChannels != buffer.getNumChannels())
+        {
+            DBG("TrackLoader::DecodePassJob could not read " << file.getFullPathName());
+            return false;
+        }
+
+        //Decoding in chunks so that the job can stop quickly when the app is closing
+        const int chunkSize{ 65536 };
+
+        for (juce::int64 pos = decoded->decodedLength.load(); pos < reader->lengthInSamples; pos += chunkSize)
+        {
+            if (shouldExit())
+            {
+                return false;
+            }
+
+            const int numSamples{ (int)juce::jmin((juce::int64)chunkSize, reader->lengthInSamples - pos) };
+
+            const double startTime{ juce::Time::getMillisecondCounterHiRes() };
+            reader->read(&buffer, (int)pos, numSamples, pos, true, true);
+            decodeMilliseconds += juce::Time::getMillisecondCounterHiRes() - startTime;
+
+            decoded->decodedLength.store(pos + numSamples, std::memory_order_release);
+
+            const juce::ScopedLock sl(joinLock);
+            wakeFeeds(false, false);
+        }
+
+        owner.getCache().insert(key, decoded->track);
+        return true;
+    }
+
+    //Waking every feed, and adding a job for the ones that have none scheduled. Called under joinLock
+    void wakeFeeds(bool passEnded, bool passCompleted)
+    {
+        for (std::shared_ptr<Feed>& feed : feeds)
+        {
+            if (feed->wake(passEnded, passCompleted))
+            {
+                owner.addFeedJob(feed);
+            }
+        }
+    }
+
+    TrackLoader& owner;
+    juce::AudioFormatManager& formatManager;
+    juce::File file;
+    juce::String key;
+
+    //The track being decoded and the time spent reading it
+    std::shared_ptr<PartialTrack> decoded;
+    double decodeMilliseconds{ 0.0 };
+
+    //The feed of every consumer that joined, and whether the job still takes any
+    juce::CriticalSection joinLock;
+    std::vector<std::shared_ptr<Feed>> feeds;
+    bool closed{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodePassJob)
+};
+
+//==============================================================================
+//The job that decodes the audio after a cue point, so that the deck can jump there without waiting
+class TrackLoader::SnippetJob : public juce::ThreadPoolJob
+{
+public:
+    SnippetJob(TrackLoader& _owner,
+               juce::AudioFormatManager& _formatManager,
+               juce::URL _audioURL,
+               juce::int64 _startSample,
+               int _numSamples,
+               SnippetCallback _onDecoded)
+        : juce::ThreadPoolJob("Cue snippet"),
+          owner(_owner),
+          formatManager(_formatManager),
+          audioURL(_audioURL),
+          startSample(_startSample),
+          numSamples(_numSamples),
+          onDecoded(std::move(_onDecoded))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        std::shared_ptr<juce::AudioBuffer<float>> snippet{ decode() };
+
+        auto callback = onDecoded;
+        juce::MessageManager::callAsync([callback, snippet]
+        {
+            if (callback != nullptr)
+            {
+                callback(snippet);
+            }
+        });
+
+        return jobHasFinished;
+    }
+
+private:
+    std::shared_ptr<juce::AudioBuffer<float>> decode()
+    {
+        //A track that is in the cache is only copied
+        if (audioURL.isLocalFile())
+        {
+            std::shared_ptr<const DecodedTrack> decoded{
+                owner.getCache().peek(DecodedTrackCache::makeKey(audioURL.getLocalFile())) };
+
+            if (decoded != nullptr)
+            {
+                const juce::int64 available{ decoded->buffer.getNumSamples() - startSample };
+                const int length{ (int)juce::jmin((juce::int64)numSamples, available) };
+                if (length <= 0)
+                {
+                    return nullptr;
+                }
+
+                auto snippet = std::make_shared<juce::AudioBuffer<float>>(decoded->buffer.getNumChannels(), length);
+                for (int ch = 0; ch < snippet->getNumChannels(); ++ch)
+                {
+                    snippet->copyFrom(ch, 0, decoded->buffer, ch, (int)startSample, length);
+                }
+                return snippet;
+            }
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader{ formatManager.createReaderFor(audioURL.createInputStream(false)) };
+
+        if (reader == nullptr)
+        {
+            DBG("TrackLoader::SnippetJob could not open " << audioURL.toString(false));
+            return nullptr;
+        }
+
+        const int length{ (int)juce::jmin((juce::int64)numSamples, reader->lengthInSamples - startSample) };
+        if (length <= 0)
+        {
+            return nullptr;
+        }
+
+        auto snippet = std::make_shared<juce::AudioBuffer<float>>((int)juce::jmax(1u, reader->numChannels), length);
+        reader->read(snippet.get(), 0, length, startSample, true, true);
+
+        return snippet;
+    }
+
+    TrackLoader& owner;
+    juce::AudioFormatManager& formatManager;
+    juce::URL audioURL;
+    juce::int64 startSample;
+    int numSamples;
+    SnippetCallback onDecoded;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SnippetJob)
+};
+
+//==============================================================================
+TrackLoader::TrackLoader()
+{
+
+}
+
+TrackLoader::~TrackLoader()
+{
+    //Waiting for any load that is still running before the pools go away.
+    //The passes are stopped before the feed pool, since a pass that stops wakes its feeds
+    pool.removeAllJobs(true, 5000);
+    cachePool.removeAllJobs(true, 5000);
+    feedPool.removeAllJobs(true, 5000);
+}
+
+//Adding a new load job to the pool. The pool deletes the job once it has finished
+void TrackLoader::loadAsync(juce::AudioFormatManager& formatManager,
+                            juce::URL audioURL,
+                            ProgressCallback onProgress,
+                            CompletionCallback onComplete)
+{
+    pool.addJob(new LoadJob(*this, formatManager, audioURL, std::move(onProgress), std::move(onComplete)), true);
+}
+
+void TrackLoader::decodeSnippetAsync(juce::AudioFormatManager& formatManager,
+                                     juce::URL audioURL,
+                                     juce::int64 startSample,
+                                     int numSamples,
+                                     SnippetCallback onDecoded)
+{
+    pool.addJob(new SnippetJob(*this, formatManager, audioURL, startSample, numSamples, std::move(onDecoded)), true);
+}
+
+DecodedTrackCache& TrackLoader::getCache()
+{
+    return *cache;
+}
+
+//The reservation is an empty entry in passesInProgress, which startDecodePass() fills with the job.
+//A track that is already cached or being decoded gets no new pass
+bool TrackLoader::reserveDecodePass(const juce::File& file, std::shared_ptr<PartialTrack>& running)
+{
+    const juce::String key{ DecodedTrackCache::makeKey(file) };
+    const juce::ScopedLock sl(passLock);
+
+    running = nullptr;
+
+    auto found = passesInProgress.find(key);
+    if (found != passesInProgress.end())
+    {
+        if (found->second != nullptr)
+        {
+            running = found->second->getDecoded();
+        }
+        return false;
+    }
+
+    if (cache->contains(key))
+    {
+        return false;
+    }
+
+    passesInProgress[key] = nullptr;
+    return true;
+}
+
+void TrackLoader::startDecodePass(juce::AudioFormatManager& formatManager,
+                                  const juce::File& file,
+                                  std::shared_ptr<PartialTrack> start)
+{
+    const juce::String key{ DecodedTrackCache::makeKey(file) };
+    DecodePassJob* job{ new DecodePassJob(*this, formatManager, file, key, start) };
+
+    {
+        const juce::ScopedLock sl(passLock);
+        passesInProgress[key] = job;
+    }
+
+    cachePool.addJob(job, true);
+}
+
+void TrackLoader::addFeedJob(std::shared_ptr<Feed> feed)
+{
+    feedPool.addJob([feed] { feed->run(); });
+}
+
+//The job is only deleted after it has called decodePassFinished(), which takes the same lock,
+//  so the pointer in the map is always safe to use here. A pass that is only reserved has no job yet
+//  and takes no consumers
+bool TrackLoader::joinDecodePass(const juce::File& file, std::shared_ptr<DecodeConsumer> consumer)
+{
+    const juce::String key{ DecodedTrackCache::makeKey(file) };
+    const juce::ScopedLock sl(passLock);
+
+    auto found = passesInProgress.find(key);
+    return found != passesInProgress.end() && found->second != nullptr && found->second->join(consumer);
+}
+
+const DecodeStats& TrackLoader::getDecodeStats() const
+{
+    return decodeStats;
+}
+
+//Without the pass every consumer would have decoded the whole track itself, so each one fed saves the decoding time once
+void TrackLoader::decodePassFinished(const juce::String& key, double decodeMilliseconds, int numConsumersFed)
+{
+    {
+        const juce::ScopedLock sl(passLock);
+        passesInProgress.erase(key);
+    }
+
+    if (decodeMilliseconds <= 0.0)
+    {
+        return;
+    }
+
+    const int saved{ juce::roundToInt(decodeMilliseconds * numConsumersFed) };
+
+    ++decodeStats.passes;
+    decodeStats.consumersFed += numConsumersFed;
+    decodeStats.millisecondsSaved += saved;
+    decodeStats.lastMillisecondsSaved = saved;
+
+    DBG("TrackLoader decoded " << key << " once in " << juce::roundToInt(decodeMilliseconds) << " ms for "
+        << numConsumersFed << " consumers, saving " << saved << " ms");
+}
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    TrackLoader.h
+    Created: 17 Oct 2026 11:40:05am
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include "DecodedTrackCache.h"
+
+//==============================================================================
+//A track that has been opened and probed by the TrackLoader and is ready to be handed to a deck
+struct LoadedTrack
+{
+    //The URL that was loaded
+    juce::URL url;
+
+    //The source that plays the track, ready to be given to an AudioTransportSource.
+    //It either streams from the file or plays from the DecodedTrackCache
+    std::unique_ptr<juce::PositionableAudioSource> source;
+
+    //The details found while probing the file
+    double sampleRate{ 0.0 };
+    double lengthInSeconds{ 0.0 };
+    int numChannels{ 0 };
+
+    //True if the file was opened and probed successfully
+    bool loadedOk{ false };
+
+    //True if the track was found already decoded in the DecodedTrackCache
+    bool fromCache{ false };
+
+    //True if the track is played from a memory-mapped WAV or AIFF file
+    bool memoryMapped{ false };
+};
+
+//==============================================================================
+//Something that is fed the audio of a track by the decode pass of the TrackLoader, eg. the analysis
+//  or the waveform builder, instead of decoding the file itself.
+//Every function is called on a thread of the feed pool of the loader, never 2 at the same time
+class DecodeConsumer
+{
+public:
+    virtual ~DecodeConsumer() {}
+
+    //Called once, before the first block
+    virtual void prepare(double sampleRate, int numChannels, juce::int64 lengthInSamples) = 0;
+    //Called with the blocks of the track in order from its start, one pointer per channel
+    virtual void process(const float* const* channels, int numChannels, int numSamples) = 0;
+    //Called once the whole track was fed, or with false if the pass stopped before the end
+    virtual void finished(bool completed) = 0;
+};
+
+//==============================================================================
+//The counters of the decode passes, readable from any thread
+struct DecodeStats
+{
+    //The number of passes that finished, and the number of consumers fed by them
+    std::atomic<int> passes{ 0 };
+    std::atomic<int> consumersFed{ 0 };
+    //The decoding time the consumers did not spend because they were fed by a pass, in milliseconds,
+    //  over every pass and for the last one
+    std::atomic<int> millisecondsSaved{ 0 };
+    std::atomic<int> lastMillisecondsSaved{ 0 };
+};
+
+//==============================================================================
+//A process-wide service that opens, probes and pre-decodes tracks on a small pool of
+//  worker threads, so that loading a large file never blocks the message thread or the audio thread.
+//The first time a track is streamed it is decoded once, in full, by a decode pass in the background. The pass
+//  carries on from the seconds decoded while loading, into the same buffer the deck plays them from, so the
+//  deck plays from memory wherever the pass has got to. When it is done the track goes into the
+//  DecodedTrackCache, which the hot cue snippets and the next loads of the track play from.
+//Every DecodeConsumer that joined the pass is fed its blocks on the feed pool, so the analysis and the
+//  waveform of the track never open the file again and the pass thread only decodes. A consumer that joins
+//  after the pass started is first fed what was decoded so far.
+//It is shared between all the AudioPlayers using a juce::SharedResourcePointer
+class TrackLoader
+{
+public:
+    //Called on the message thread with the progress of a load between 0 and 1
+    using ProgressCallback = std::function<void(float)>;
+    //Called on the message thread when the load has finished, successfully or not
+    using CompletionCallback = std::function<void(std::shared_ptr<LoadedTrack>)>;
+    //Called on the message thread with a decoded snippet, or nullptr if it could not be read
+    using SnippetCallback = std::function<void(std::shared_ptr<juce::AudioBuffer<float>>)>;
+
+    TrackLoader();
+    ~TrackLoader();
+
+    //Starts loading a track on one of the worker threads and returns straight away.
+    //The format manager must outlive the load
+    void loadAsync(juce::AudioFormatManager& formatManager,
+                   juce::URL audioURL,
+                   ProgressCallback onProgress,
+                   CompletionCallback onComplete);
+
+    //Decodes a short part of a track on one of the worker threads, eg. the audio after a hot cue.
+    //It is copied from the DecodedTrackCache when the track is there
+    void decodeSnippetAsync(juce::AudioFormatManager& formatManager,
+                            juce::URL audioURL,
+                            juce::int64 startSample,
+                            int numSamples,
+                            SnippetCallback onDecoded);
+
+    //The number of seconds decoded ahead by the worker before the track is handed over.
+    //The deck plays them from memory
+    static constexpr double preDecodeSeconds{ 3.0 };
+
+    //The shared cache of decoded tracks that the loader fills and plays from
+    DecodedTrackCache& getCache();
+
+    //Feeding a consumer from the decode pass of a file, if one is waiting or running.
+    //Returns false if there is none, or it has already fed its last block, and then the consumer is never used
+    bool joinDecodePass(const juce::File& file, std::shared_ptr<DecodeConsumer> consumer);
+
+    //How much decoding the passes saved
+    const DecodeStats& getDecodeStats() const;
+
+private:
+    //The job that runs on a worker thread for every track loaded
+    class LoadJob;
+    //The job that decodes a whole track into the cache and feeds its consumers, after it was streamed for the first time
+    class DecodePassJob;
+    //A consumer of a decode pass and how far it was fed
+    class Feed;
+    //The job that decodes the snippet after a cue point
+    class SnippetJob;
+
+    //Reserves the decode pass of a file. Returns true if the caller owns a new pass and has to start it with
+    //  startDecodePass(). Otherwise running is set to the track a pass is already filling, or nullptr if the
+    //  track is cached or its pass is reserved but not started yet
+    bool reserveDecodePass(const juce::File& file, std::shared_ptr<PartialTrack>& running);
+    //Starts the DecodePassJob reserved by reserveDecodePass(), which carries on decoding the track into start
+    void startDecodePass(juce::AudioFormatManager& formatManager,
+                         const juce::File& file,
+                         std::shared_ptr<PartialTrack> start);
+    //Adding a job to the feed pool that runs a feed
+    void addFeedJob(std::shared_ptr<Feed> feed);
+    //Called by a DecodePassJob when it is done, with the time it spent decoding if it decoded the whole track
+    void decodePassFinished(const juce::String& key, double decodeMilliseconds, int numConsumersFed);
+
+    //The cache of decoded tracks shared by every player
+    juce::SharedResourcePointer<DecodedTrackCache> cache;
+
+    //The decode passes waiting or running, by the cache key of their track. A reserved pass is nullptr until it starts
+    std::map<juce::String, DecodePassJob*> passesInProgress;
+    juce::CriticalSection passLock;
+
+    DecodeStats decodeStats;
+
+    //A small pool, so that loading a track into one deck never waits for the other deck
+    juce::ThreadPool pool{ 2 };
+    //A separate pool for the decode passes, so they never hold up a deck waiting for a track
+    juce::ThreadPool cachePool{ 1 };
+    //The pool the consumers of the passes are fed on, one thread for each kind of consumer,
+    //  so the analysis and the waveform of a track are made at the same time
+    juce::ThreadPool feedPool{ 2 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackLoader)
+};
@@ -0,0 +1,226 @@
+/*
+  ==============================================================================
+
+    TrackMetadataStore.cpp
+    Created: 17 Oct 2026 3:01:43pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "TrackMetadataStore.h"
+#include "AudioFingerprint.h"
+
+//The same format the decks use for the length of a track
+juce::String TrackMetadata::formatLength(double seconds)
+{
+    double length_minutes{ seconds / 60 };
+
+    //Seperating the integer and fractional value of the minutes
+    double fractional_part, integer_part;
+    fractional_part = modf(length_minutes, &integer_part);
+
+    std::string minutes{ std::to_string((int)integer_part) };
+    std::string secs{ std::to_string((int)round(fractional_part * 60)) };
+
+    return juce::String{ minutes + " min : " + secs + " sec" };
+}
+
+//==============================================================================
+//Checks the size and modification time of a file and reads its header if they changed
+class TrackMetadataStore::ScanJob : public juce::ThreadPoolJob
+{
+public:
+    ScanJob(TrackMetadataStore& _owner,
+            juce::File _file,
+            bool _known,
+            TrackMetadata _knownMetadata)
+        : juce::ThreadPoolJob("Track metadata scan"),
+          owner(_owner),
+          file(_file),
+          known(_known),
+          knownMetadata(_knownMetadata),
+          safeOwner(&_owner)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        TrackMetadata metadata;
+        const bool exists{ file.existsAsFile() };
+        bool changed{ false };
+
+        if (exists)
+        {
+            metadata.fileSize = file.getSize();
+            metadata.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+            changed = !known
+                || metadata.fileSize != knownMetadata.fileSize
+                || metadata.modificationTime != knownMetadata.modificationTime;
+
+            //The header is read, and only the few blocks of audio the fingerprint is made from are decoded
+            if (changed)
+            {
+                std::unique_ptr<juce::AudioFormatReader> reader{ owner.formatManager.createReaderFor(file) };
+
+                if (reader != nullptr && reader->sampleRate > 0)
+                {
+                    metadata.sampleRate = reader->sampleRate;
+                    metadata.numChannels = (int)reader->numChannels;
+                    metadata.lengthInSeconds = reader->lengthInSamples / reader->sampleRate;
+                    metadata.fingerprint = AudioFingerprint::compute(*reader, metadata.fileSize);
+                }
+                else
+                {
+                    DBG("TrackMetadataStore::ScanJob could not read " << file.getFullPathName());
+                }
+            }
+        }
+
+        const juce::String path{ file.getFullPathName() };
+        juce::WeakReference<TrackMetadataStore> store{ safeOwner };
+        juce::MessageManager::callAsync([store, path, exists, changed, metadata]
+        {
+            if (store != nullptr)
+            {
+                store->scanFinished(path, exists, changed, metadata);
+            }
+        });
+
+        return jobHasFinished;
+    }
+
+private:
+    TrackMetadataStore& owner;
+    juce::File file;
+    bool known;
+    TrackMetadata knownMetadata;
+    juce::WeakReference<TrackMetadataStore> safeOwner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScanJob)
+};
+
+//==============================================================================
+//The formats are registered before anything is scanned
+TrackMetadataStore::TrackMetadataStore()
+{
+    formatManager.registerBasicFormats();
+}
+
+TrackMetadataStore::~TrackMetadataStore()
+{
+    scanner.removeAllJobs(true, 5000);
+}
+
+//A track of the library that was probed on an earlier run is read from its record
+const TrackMetadata* TrackMetadataStore::find(const juce::File& file) const
+{
+    const juce::String path{ file.getFullPathName() };
+    auto entry = entries.find(path);
+
+    if (entry != entries.end())
+    {
+        return &entry->second;
+    }
+
+    const LibraryRecord* record{ library->getRecord(library->findTrack(file)) };
+    if (record == nullptr || record->sampleRate <= 0.0)
+    {
+        return nullptr;
+    }
+
+    TrackMetadata metadata;
+    metadata.lengthInSeconds = record->lengthInSeconds;
+    metadata.sampleRate = record->sampleRate;
+    metadata.numChannels = (int)record->numChannels;
+    metadata.fileSize = record->fileSize;
+    metadata.modificationTime = record->modificationTime;
+    metadata.fingerprint = record->fingerprint;
+
+    return &(entries[path] = metadata);
+}
+
+void TrackMetadataStore::request(const juce::File& file)
+{
+    const juce::String path{ file.getFullPathName() };
+
+    if (path.isEmpty() || pending.count(path) > 0)
+    {
+        return;
+    }
+    pending.insert(path);
+
+    const TrackMetadata* known{ find(file) };
+    scanner.addJob(new ScanJob(*this, file, known != nullptr, known != nullptr ? *known : TrackMetadata{}), true);
+}
+
+void TrackMetadataStore::remove(const juce::File& file)
+{
+    entries.erase(file.getFullPathName());
+}
+
+std::vector<juce::uint32> TrackMetadataStore::takeChangedTracks()
+{
+    std::vector<juce::uint32> changed;
+    changed.swap(changedTracks);
+    return changed;
+}
+
+std::vector<DuplicateTrack> TrackMetadataStore::takeDuplicates()
+{
+    std::vector<DuplicateTrack> found;
+    found.swap(duplicates);
+    return found;
+}
+
+//A file that is gone is forgotten, a changed file gets its new metadata and the listeners are told
+void TrackMetadataStore::scanFinished(const juce::String& path, bool exists, bool changed, const TrackMetadata& metadata)
+{
+    pending.erase(path);
+
+    if (!exists)
+    {
+        if (entries.erase(path) > 0)
+        {
+            sendChangeMessage();
+        }
+    }
+    else if (changed)
+    {
+        const juce::uint32 id{ library->findTrack(juce::File{ path }) };
+        const LibraryRecord* record{ library->getRecord(id) };
+
+        //A track that was added without being probed, by the watcher or from a deck, is checked for
+        //  duplicates once its fingerprint is known, the same way the FolderImporter checks the files it imports
+        const juce::uint32 original{ record != nullptr && record->sampleRate <= 0.0
+                                     ? library->findDuplicate(metadata.fingerprint) : 0 };
+        if (original != 0 && original != id)
+        {
+            duplicates.push_back({ juce::File{ path }, library->getFile(original), id });
+            library->removeTrack(id);
+            entries.erase(path);
+            sendChangeMessage();
+            return;
+        }
+
+        entries[path] = metadata;
+
+        //The new metadata goes into the library, so it is not probed again on the next run
+        if (record != nullptr)
+        {
+            changedTracks.push_back(id);
+
+            LibraryRecord updated{ *record };
+            updated.lengthInSeconds = metadata.lengthInSeconds;
+            updated.sampleRate = metadata.sampleRate;
+            updated.numChannels = (juce::uint32)metadata.numChannels;
+            updated.fileSize = metadata.fileSize;
+            updated.modificationTime = metadata.modificationTime;
+            updated.fingerprint = metadata.fingerprint;
+            library->updateRecord(updated);
+        }
+
+        sendChangeMessage();
+    }
+}
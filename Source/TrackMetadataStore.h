@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    TrackMetadataStore.h
+    Created: 17 Oct 2026 3:01:43pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <set>
+#include <vector>
+#include "LibraryDatabase.h"
+
+//==============================================================================
+//What is known about a track file without playing it
+struct TrackMetadata
+{
+    double lengthInSeconds{ 0.0 };
+    double sampleRate{ 0.0 };
+    int numChannels{ 0 };
+
+    //The size and modification time of the file when it was probed, so a changed file is probed again
+    juce::int64 fileSize{ 0 };
+    juce::int64 modificationTime{ 0 };
+
+    //The AudioFingerprint of the file, 0 when it could not be read
+    juce::uint64 fingerprint{ 0 };
+
+    //Returns a length in seconds as "3 min : 25 sec"
+    static juce::String formatLength(double seconds);
+};
+
+//==============================================================================
+//A store of TrackMetadata for every track the app knows about, so that the playlist never opens
+//  an audio file just to show its length.
+//The files are probed by a background scanner, and the results are handed to the message thread,
+//  which is the only thread that reads or changes the store. The metadata of the tracks in the
+//  library is kept in the LibraryDatabase, so it is there on the next run.
+//It is shared using a juce::SharedResourcePointer and tells its listeners when new metadata arrives
+class TrackMetadataStore : public juce::ChangeBroadcaster
+{
+public:
+    TrackMetadataStore();
+    ~TrackMetadataStore() override;
+
+    //Returns the metadata of a file, or nullptr if it has not been probed yet. Never touches the file
+    const TrackMetadata* find(const juce::File& file) const;
+
+    //Asks the scanner to check a file. A file that is already known is only probed again if its size
+    //  or modification time changed, and a file that is gone is removed from the store
+    void request(const juce::File& file);
+
+    //Forgets a file, eg. when it is removed from the library
+    void remove(const juce::File& file);
+
+    //Returns the library ids of the tracks whose metadata changed since the last call, and forgets them.
+    //Used by the playlist when it is told about a change, to update only those tracks
+    std::vector<juce::uint32> takeChangedTracks();
+
+    //Returns the tracks that were taken out of the library since the last call, because their first
+    //  probe found the same audio already in the library under another path, and forgets them
+    std::vector<DuplicateTrack> takeDuplicates();
+
+private:
+    //The job that probes one file on the scanner thread
+    class ScanJob;
+
+    //Called on the message thread with the result of a ScanJob
+    void scanFinished(const juce::String& path, bool exists, bool changed, const TrackMetadata& metadata);
+
+    //Keyed on the full path of the file. Filled from the library the first time a track is looked up
+    mutable std::map<juce::String, TrackMetadata> entries;
+    //The paths waiting for the scanner or being scanned
+    std::set<juce::String> pending;
+    //The library ids of the tracks that changed since takeChangedTracks was last called
+    std::vector<juce::uint32> changedTracks;
+    //The duplicates found since takeDuplicates was last called
+    std::vector<DuplicateTrack> duplicates;
+
+    //The store has its own format manager, since it probes files on its own thread
+    juce::AudioFormatManager formatManager;
+    juce::ThreadPool scanner{ 1 };
+
+    //The library the metadata is saved in
+    juce::SharedResourcePointer<LibraryDatabase> library;
+
+    //Used by the scan jobs to check that the store still exists
+    JUCE_DECLARE_WEAK_REFERENCEABLE(TrackMetadataStore)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackMetadataStore)
+};
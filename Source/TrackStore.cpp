@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    TrackStore.cpp
+    Created: 17 Oct 2026 3:10:52pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "TrackStore.h"
+
+TrackStore::TrackStore()
+{
+
+}
+
+TrackStore::~TrackStore()
+{
+
+}
+
+//==============================================================================
+//The title is found once, when the track is added, as the file name without its extension at the end of the path
+int TrackStore::add(const juce::File& file, juce::uint32 libraryId)
+{
+    const juce::String path{ file.getFullPathName() };
+    const size_t pathLength{ path.getNumBytesAsUTF8() };
+    const size_t nameLength{ file.getFileName().getNumBytesAsUTF8() };
+
+    pathData.insert(pathData.end(), path.toRawUTF8(), path.toRawUTF8() + pathLength);
+    pathStarts.push_back(pathData.size());
+
+    titleStarts.push_back((juce::uint32)(pathLength - juce::jmin(nameLength, pathLength)));
+    titleLengths.push_back((juce::uint32)file.getFileNameWithoutExtension().getNumBytesAsUTF8());
+
+    libraryIds.push_back(libraryId);
+    lengths.push_back(-1.0f);
+    bpms.push_back(-1.0f);
+    keys.push_back(-1);
+
+    tracksByLibraryId[libraryId] = size() - 1;
+
+    return size() - 1;
+}
+
+void TrackStore::clear()
+{
+    pathData.clear();
+    pathStarts.assign(1, 0);
+    titleStarts.clear();
+    titleLengths.clear();
+    libraryIds.clear();
+    lengths.clear();
+    bpms.clear();
+    keys.clear();
+    tracksByLibraryId.clear();
+}
+
+//The path stays in pathData, so the paths of the tracks after it do not move
+void TrackStore::remove(int track)
+{
+    auto entry = tracksByLibraryId.find(libraryIds[track]);
+
+    if (entry != tracksByLibraryId.end() && entry->second == track)
+    {
+        tracksByLibraryId.erase(entry);
+    }
+    libraryIds[track] = 0;
+}
+
+bool TrackStore::isRemoved(int track) const
+{
+    return libraryIds[track] == 0;
+}
+
+int TrackStore::findTrack(juce::uint32 libraryId) const
+{
+    auto entry = tracksByLibraryId.find(libraryId);
+    return entry != tracksByLibraryId.end() ? entry->second : -1;
+}
+
+int TrackStore::size() const
+{
+    return (int)libraryIds.size();
+}
+
+juce::String TrackStore::getPath(int track) const
+{
+    return juce::String::fromUTF8(pathData.data() + pathStarts[track], (int)(pathStarts[track + 1] - pathStarts[track]));
+}
+
+juce::String TrackStore::getTitle(int track) const
+{
+    return juce::String::fromUTF8(pathData.data() + pathStarts[track] + titleStarts[track], (int)titleLengths[track]);
+}
+
+juce::File TrackStore::getFile(int track) const
+{
+    return juce::File{ getPath(track) };
+}
+
+juce::uint32 TrackStore::getLibraryId(int track) const
+{
+    return libraryIds[track];
+}
+
+float TrackStore::getLength(int track) const
+{
+    return lengths[track];
+}
+
+void TrackStore::setLength(int track, float lengthInSeconds)
+{
+    lengths[track] = lengthInSeconds;
+}
+
+float TrackStore::getBpm(int track) const
+{
+    return bpms[track];
+}
+
+void TrackStore::setBpm(int track, float bpm)
+{
+    bpms[track] = bpm;
+}
+
+int TrackStore::getKey(int track) const
+{
+    return keys[track];
+}
+
+void TrackStore::setKey(int track, int key)
+{
+    keys[track] = (juce::int8)key;
+}
+
+//==============================================================================
+int TrackStore::compareTitles(int first, int second) const
+{
+    return compareIgnoreCase(pathData.data() + pathStarts[first] + titleStarts[first], titleLengths[first],
+        pathData.data() + pathStarts[second] + titleStarts[second], titleLengths[second]);
+}
+
+int TrackStore::comparePaths(int first, int second) const
+{
+    return compareIgnoreCase(pathData.data() + pathStarts[first], pathStarts[first + 1] - pathStarts[first],
+        pathData.data() + pathStarts[second], pathStarts[second + 1] - pathStarts[second]);
+}
+
+int TrackStore::compareIgnoreCase(const char* first, size_t firstLength, const char* second, size_t secondLength)
+{
+    const size_t length{ juce::jmin(firstLength, secondLength) };
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        char a{ first[i] };
+        char b{ second[i] };
+
+        if (a >= 'A' && a <= 'Z')
+        {
+            a += 'a' - 'A';
+        }
+        if (b >= 'A' && b <= 'Z')
+        {
+            b += 'a' - 'A';
+        }
+
+        if (a != b)
+        {
+            return (juce::uint8)a < (juce::uint8)b ? -1 : 1;
+        }
+    }
+
+    if (firstLength == secondLength)
+    {
+        return 0;
+    }
+    return firstLength < secondLength ? -1 : 1;
+}
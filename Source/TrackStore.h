@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    TrackStore.h
+    Created: 17 Oct 2026 3:10:52pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <unordered_map>
+#include <vector>
+
+//==============================================================================
+//The tracks of the playlist, kept as a structure of arrays.
+//The paths of all the tracks are stored one after the other as UTF-8 in a single block, and every other
+//  field is an array with one entry per track, so a track costs a few bytes plus its path and no
+//  juce::File or juce::String is kept for it. Strings are only made when a row is painted.
+//The length, tempo and key are copies of the library record, updated by the playlist when it hears that
+//  they changed, so painting and sorting never look anything up.
+//Tracks are numbered from 0 in the order they were added and are never moved, so the views of the
+//  playlist are lists of track numbers. A removed track keeps its number and is only marked as removed.
+//It is only used on the message thread
+class TrackStore
+{
+public:
+    TrackStore();
+    ~TrackStore();
+
+    //Adds a track and returns its number
+    int add(const juce::File& file, juce::uint32 libraryId);
+    void clear();
+
+    //Marking a track as removed. Its number is not used again
+    void remove(int track);
+    bool isRemoved(int track) const;
+    //Returns the track with a library id, or -1 if there is none
+    int findTrack(juce::uint32 libraryId) const;
+
+    int size() const;
+
+    juce::String getPath(int track) const;
+    //The file name without its extension
+    juce::String getTitle(int track) const;
+    juce::File getFile(int track) const;
+    //The id of the track in the LibraryDatabase, 0 once the track is removed
+    juce::uint32 getLibraryId(int track) const;
+
+    //The length in seconds, or a negative number when it is not known yet
+    float getLength(int track) const;
+    void setLength(int track, float lengthInSeconds);
+    //The tempo, 0 for a track with no beat, or a negative number when it has not been analysed yet
+    float getBpm(int track) const;
+    void setBpm(int track, float bpm);
+    //The key as an index from 0 to 23, or -1 when it has not been analysed yet
+    int getKey(int track) const;
+    void setKey(int track, int key);
+
+    //Comparing 2 tracks for sorting, without making any strings.
+    //Returns a negative number, 0 or a positive number like strcmp
+    int compareTitles(int first, int second) const;
+    int comparePaths(int first, int second) const;
+
+private:
+    //Comparing 2 runs of UTF-8 bytes, ignoring the case of ASCII letters
+    static int compareIgnoreCase(const char* first, size_t firstLength, const char* second, size_t secondLength);
+
+    //The paths of every track, one after the other, and where the path of each track starts.
+    //pathStarts has one more entry than there are tracks, holding the end of the last path
+    std::vector<char> pathData;
+    std::vector<size_t> pathStarts{ 0 };
+
+    //Where the title starts in the path and how many bytes long it is
+    std::vector<juce::uint32> titleStarts;
+    std::vector<juce::uint32> titleLengths;
+
+    std::vector<juce::uint32> libraryIds;
+    std::vector<float> lengths;
+    std::vector<float> bpms;
+    std::vector<juce::int8> keys;
+
+    //The track of every library id that is not removed
+    std::unordered_map<juce::uint32, int> tracksByLibraryId;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackStore)
+};
@@ -0,0 +1,329 @@
+/*
+  ==============================================================================
+
+    WaveformCache.cpp
+    Created: 17 Oct 2026 3:34:06pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "WaveformCache.h"
+#include <algorithm>
+#include <vector>
+
+//==============================================================================
+//Feeds the blocks of a decode pass to a builder and hands the pyramid over once the pass is done.
+//The pyramid is saved by a job of the cache's pool, not on the thread of the pass, so the folder is
+//  only ever written by one job at a time and the pass is not held up by the disk.
+//A pass that stops before the end starts a search that makes the pyramid on its own
+class WaveformCache::PassConsumer : public DecodeConsumer
+{
+public:
+    PassConsumer(juce::WeakReference<WaveformCache> _cache, juce::File _audioFile, juce::File _pyramidFile)
+        : cache(_cache),
+          audioFile(_audioFile),
+          pyramidFile(_pyramidFile)
+    {
+    }
+
+    void prepare(double sampleRate, int, juce::int64 lengthInSamples) override
+    {
+        builder.reset(new WaveformPyramid::Builder(sampleRate, lengthInSamples));
+    }
+
+    //Only the first 2 channels go into the waveform, as they do when it is made by build()
+    void process(const float* const* channels, int numChannels, int numSamples) override
+    {
+        builder->process(channels, juce::jmin(numChannels, 2), numSamples);
+    }
+
+    void finished(bool completed) override
+    {
+        const juce::WeakReference<WaveformCache> safeCache{ cache };
+        const juce::File file{ audioFile };
+
+        if (!completed || builder == nullptr)
+        {
+            juce::MessageManager::callAsync([safeCache, file]
+            {
+                if (safeCache != nullptr)
+                {
+                    safeCache.get()->startSearch(file, false);
+                }
+            });
+            return;
+        }
+
+        std::shared_ptr<const WaveformPyramid> pyramid{ builder->finish() };
+
+        postResult(cache, audioFile, pyramid);
+
+        if (pyramid != nullptr)
+        {
+            const juce::File target{ pyramidFile };
+            juce::MessageManager::callAsync([safeCache, pyramid, target]
+            {
+                if (safeCache != nullptr)
+                {
+                    WaveformCache* owner{ safeCache.get() };
+                    owner->pool.addJob([owner, pyramid, target]
+                    {
+                        if (pyramid->save(target))
+                        {
+                            owner->prune();
+                        }
+                    });
+                }
+            });
+        }
+    }
+
+private:
+    juce::WeakReference<WaveformCache> cache;
+    juce::File audioFile;
+    juce::File pyramidFile;
+
+    std::unique_ptr<WaveformPyramid::Builder> builder;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PassConsumer)
+};
+
+//==============================================================================
+//The job that finds or makes the pyramid of one track. It looks in the folder again before making it,
+//  since an earlier job may have made the same pyramid while this one was waiting.
+//When the track is being decoded by the TrackLoader the job hands the work to a PassConsumer and finishes
+class WaveformCache::BuildJob : public juce::ThreadPoolJob
+{
+public:
+    BuildJob(WaveformCache& _owner, juce::WeakReference<WaveformCache> _safeOwner, juce::File _audioFile, bool _mayJoinPass)
+        : juce::ThreadPoolJob("Waveform pyramid"),
+          owner(_owner),
+          safeOwner(_safeOwner),
+          audioFile(_audioFile),
+          mayJoinPass(_mayJoinPass)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        std::shared_ptr<const WaveformPyramid> pyramid{ owner.find(audioFile) };
+
+        if (pyramid == nullptr)
+        {
+            if (mayJoinPass)
+            {
+                auto consumer = std::make_shared<PassConsumer>(safeOwner, audioFile, owner.getPyramidFile(audioFile));
+
+                if (owner.loader->joinDecodePass(audioFile, consumer))
+                {
+                    return jobHasFinished;
+                }
+            }
+
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+
+            std::shared_ptr<WaveformPyramid> built{ owner.build(audioFile, formatManager, this) };
+
+            if (built != nullptr && built->save(owner.getPyramidFile(audioFile)))
+            {
+                owner.prune();
+            }
+            pyramid = built;
+        }
+
+        if (shouldExit())
+        {
+            return jobHasFinished;
+        }
+
+        postResult(safeOwner, audioFile, pyramid);
+
+        return jobHasFinished;
+    }
+
+private:
+    WaveformCache& owner;
+    juce::WeakReference<WaveformCache> safeOwner;
+    juce::File audioFile;
+    bool mayJoinPass;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BuildJob)
+};
+
+//==============================================================================
+WaveformCache::WaveformCache()
+    : folder(getDefaultFolder())
+{
+    if (!folder.createDirectory())
+    {
+        DBG("WaveformCache could not create " << folder.getFullPathName());
+    }
+}
+
+WaveformCache::~WaveformCache()
+{
+    pool.removeAllJobs(true, 5000);
+}
+
+//A file that is used has its modification time set, so prune() removes the ones not used for the longest time
+std::shared_ptr<const WaveformPyramid> WaveformCache::find(const juce::File& audioFile)
+{
+    const juce::File pyramidFile{ getPyramidFile(audioFile) };
+    std::shared_ptr<const WaveformPyramid> pyramid{ WaveformPyramid::load(pyramidFile) };
+
+    if (pyramid != nullptr)
+    {
+        pyramidFile.setLastModificationTime(juce::Time::getCurrentTime());
+    }
+    return pyramid;
+}
+
+//Only the first request for a track starts a search, the others wait for its result
+void WaveformCache::findAsync(const juce::File& audioFile, PyramidCallback onFound)
+{
+    std::vector<PyramidCallback>& callbacks{ pending[audioFile.getFullPathName()] };
+    callbacks.push_back(std::move(onFound));
+
+    if (callbacks.size() == 1)
+    {
+        startSearch(audioFile, true);
+    }
+}
+
+juce::File WaveformCache::getPyramidFile(const juce::File& audioFile) const
+{
+    const juce::String key{ DecodedTrackCache::makeKey(audioFile) };
+    return folder.getChildFile(juce::String::toHexString(key.hashCode64()).paddedLeft('0', 16) + ".odw");
+}
+
+juce::File WaveformCache::getDefaultFolder()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("OtoDecks_waveforms");
+}
+
+void WaveformCache::startSearch(const juce::File& audioFile, bool mayJoinPass)
+{
+    pool.addJob(new BuildJob(*this, this, audioFile, mayJoinPass), true);
+}
+
+void WaveformCache::postResult(juce::WeakReference<WaveformCache> cache,
+                               const juce::File& audioFile,
+                               std::shared_ptr<const WaveformPyramid> pyramid)
+{
+    juce::MessageManager::callAsync([cache, audioFile, pyramid]
+    {
+        if (cache != nullptr)
+        {
+            cache.get()->searchFinished(audioFile, pyramid);
+        }
+    });
+}
+
+//The callbacks are taken out of the map before they are called, so a callback can ask for the same track again
+void WaveformCache::searchFinished(const juce::File& audioFile, std::shared_ptr<const WaveformPyramid> pyramid)
+{
+    auto found = pending.find(audioFile.getFullPathName());
+    if (found == pending.end())
+    {
+        return;
+    }
+
+    std::vector<PyramidCallback> callbacks{ std::move(found->second) };
+    pending.erase(found);
+
+    for (PyramidCallback& callback : callbacks)
+    {
+        callback(pyramid);
+    }
+}
+
+//==============================================================================
+//Only the first 2 channels go into the waveform, as they do for the analysis
+std::shared_ptr<WaveformPyramid> WaveformCache::build(const juce::File& audioFile,
+                                                      juce::AudioFormatManager& formatManager,
+                                                      juce::ThreadPoolJob* job)
+{
+    const juce::String key{ DecodedTrackCache::makeKey(audioFile) };
+    std::shared_ptr<const DecodedTrack> decoded{ decodedCache->peek(key) };
+
+    if (decoded != nullptr)
+    {
+        const int numSamples{ decoded->buffer.getNumSamples() };
+        const int numChannels{ juce::jmin(decoded->buffer.getNumChannels(), 2) };
+
+        WaveformPyramid::Builder builder{ decoded->sampleRate, numSamples };
+        builder.process(decoded->buffer.getArrayOfReadPointers(), numChannels, numSamples);
+        return builder.finish();
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> reader{ formatManager.createReaderFor(audioFile) };
+    if (reader == nullptr || reader->sampleRate <= 0.0 || reader->numChannels == 0)
+    {
+        DBG("WaveformCache::build could not read " << audioFile.getFullPathName());
+        return nullptr;
+    }
+
+    const int blockSize{ 65536 };
+    const int numChannels{ juce::jmin((int)reader->numChannels, 2) };
+
+    WaveformPyramid::Builder builder{ reader->sampleRate, reader->lengthInSamples };
+    juce::AudioBuffer<float> block{ numChannels, blockSize };
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples; position += blockSize)
+    {
+        if (job != nullptr && job->shouldExit())
+        {
+            return nullptr;
+        }
+
+        const int numSamples{ (int)juce::jmin((juce::int64)blockSize, reader->lengthInSamples - position) };
+        reader->read(&block, 0, numSamples, position, true, numChannels > 1);
+        builder.process(block.getArrayOfReadPointers(), numChannels, numSamples);
+    }
+
+    return builder.finish();
+}
+
+//The temporary files a pyramid is written to before it replaces its file are left alone
+void WaveformCache::prune()
+{
+    std::vector<juce::File> files;
+    juce::int64 totalBytes{ 0 };
+
+    for (const juce::DirectoryEntry& entry : juce::RangedDirectoryIterator(folder, false, "*.odw"))
+    {
+        if (entry.getFile().getFileNameWithoutExtension().contains("_temp"))
+        {
+            continue;
+        }
+
+        files.push_back(entry.getFile());
+        totalBytes += entry.getFileSize();
+    }
+
+    if (totalBytes <= maxDiskBytes)
+    {
+        return;
+    }
+
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b)
+    {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+
+    for (const juce::File& file : files)
+    {
+        if (totalBytes <= maxDiskBytes)
+        {
+            break;
+        }
+
+        const juce::int64 size{ file.getSize() };
+        if (file.deleteFile())
+        {
+            totalBytes -= size;
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    WaveformCache.h
+    Created: 17 Oct 2026 3:34:06pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include "WaveformPyramid.h"
+#include "DecodedTrackCache.h"
+#include "TrackLoader.h"
+
+//==============================================================================
+//A process-wide store of the waveform pyramids of the tracks, kept in a folder on disk.
+//The file of a track is named after a hash of its path, size and modification time, so a track that
+//  changes on disk gets a new pyramid and its old one is left to be pruned.
+//A pyramid missing from the folder is made on a worker thread and saved before it is handed over. It is made
+//  by joining the decode pass of the TrackLoader when the track is being decoded, from the DecodedTrackCache
+//  when the track is there and by streaming the file otherwise. Any later load of the same track, in this
+//  run or the next one, only maps its file.
+//The displays asking for the same track at the same time share one search.
+//The folder is kept under maxDiskBytes by removing the files that were used the longest time ago.
+//It is shared using a juce::SharedResourcePointer
+class WaveformCache
+{
+public:
+    //Called on the message thread with the pyramid of a track, or nullptr if the track could not be read
+    using PyramidCallback = std::function<void(std::shared_ptr<const WaveformPyramid>)>;
+
+    //The most bytes the pyramid files may take up together
+    static constexpr juce::int64 maxDiskBytes{ (juce::int64)256 * 1024 * 1024 };
+
+    WaveformCache();
+    ~WaveformCache();
+
+    //Returns the pyramid of a track if it is on disk, or nullptr. Only maps the file
+    std::shared_ptr<const WaveformPyramid> find(const juce::File& audioFile);
+    //Finds the pyramid of a track, or makes it, on a worker thread and returns straight away.
+    //Must be called on the message thread
+    void findAsync(const juce::File& audioFile, PyramidCallback onFound);
+
+    //The file the pyramid of a track is kept in
+    juce::File getPyramidFile(const juce::File& audioFile) const;
+    //The folder the pyramids are kept in
+    static juce::File getDefaultFolder();
+
+private:
+    class BuildJob;
+    //Makes a pyramid from the blocks of a decode pass
+    class PassConsumer;
+
+    //Adding a job that finds or makes the pyramid of a track, joining the decode pass of the track if mayJoinPass is true
+    void startSearch(const juce::File& audioFile, bool mayJoinPass);
+    //Sending the result of a search to the message thread, from any thread
+    static void postResult(juce::WeakReference<WaveformCache> cache,
+                           const juce::File& audioFile,
+                           std::shared_ptr<const WaveformPyramid> pyramid);
+    //Called on the message thread with the result of a search, to hand it to everyone who asked for the track
+    void searchFinished(const juce::File& audioFile, std::shared_ptr<const WaveformPyramid> pyramid);
+
+    //Decoding a track, or reading it from the DecodedTrackCache, and feeding it to a builder.
+    //Returns nullptr if the file could not be read or the job was asked to stop
+    std::shared_ptr<WaveformPyramid> build(const juce::File& audioFile,
+                                           juce::AudioFormatManager& formatManager,
+                                           juce::ThreadPoolJob* job);
+    //Removing the least recently used files until the folder is under maxDiskBytes. Only run by the jobs of the pool
+    void prune();
+
+    juce::File folder;
+
+    //The callbacks waiting for the search of each track, by the path of the track. Only used on the message thread
+    std::map<juce::String, std::vector<PyramidCallback>> pending;
+
+    //Only one job writes to the folder at a time, so the same pyramid is never made twice at once
+    juce::ThreadPool pool{ 1 };
+
+    juce::SharedResourcePointer<DecodedTrackCache> decodedCache;
+    juce::SharedResourcePointer<TrackLoader> loader;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(WaveformCache)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformCache)
+};
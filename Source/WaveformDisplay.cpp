@@ -13,56 +13,142 @@
 
 //==============================================================================
 //The constructor with the initialization list
-WaveformDisplay::WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
-    juce::AudioThumbnailCache& cachetoUse)
-    : audioThumb(1000, formatManagerToUse, cachetoUse),
-    position(0),
+WaveformDisplay::WaveformDisplay()
+    : position(0),
     fileLoaded(false)
 {
     // In your constructor, you should add any child components, and
     // initialise any special settings that your component needs.
 
-    //registering a change listener to the waveformDisplay object
-    audioThumb.addChangeListener(this);
-
+    //The cached image covers the whole component, so nothing behind it needs painting
+    setOpaque(true);
 }
 
 WaveformDisplay::~WaveformDisplay()
 {
 }
 
+//The waveform only changes with the track or the size, so it is drawn into the image once and every
+//  other paint, which is normally just the strips around the playhead, copies it back and draws the playhead
 void WaveformDisplay::paint (juce::Graphics& g)
 {
+    if (!imageValid)
+    {
+        renderImage();
+    }
+    g.drawImageAt(image, 0, 0);
+
+    if (fileLoaded == true)
+    {
+        g.setColour(juce::Colours::darkorange);
+        g.drawRect(getPlayheadArea(), 2);
+    }
+}
+
+void WaveformDisplay::renderImage()
+{
+    image = juce::Image(juce::Image::RGB, juce::jmax(1, getWidth()), juce::jmax(1, getHeight()), false);
+    imageValid = true;
+
+    juce::Graphics g{ image };
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
 
      //Drawing an outline around the component
     g.setColour (juce::Colours::darkorange);
     g.drawRect (getLocalBounds(), 1);  
     
-    //Setting the colour of the waveform
-    g.setColour(juce::Colours::lightseagreen);
     //if the file is loaded, the drawing of the waveform happens
     if (fileLoaded == true)
     {
-        audioThumb.drawChannel(g,
-            getLocalBounds(),
-            0,
-            audioThumb.getTotalLength(),
-            0,
-            1.0f);
-        
-        g.setColour(juce::Colours::darkorange);
-        g.drawRect(position * getWidth(), 0, 5, getHeight(), 2);
+        drawWaveform(g);
+    }
+    //else if the waveform could not be made from the file, an error is displayed
+    else if (loadFailed)
+    {
+        g.setFont(20.0f);
+        g.setColour(juce::Colours::red);
+        g.drawText("Could not read " + loadedFile.getFileName(), getLocalBounds(),
+            juce::Justification::centred, true);
     }
     //else if the file is not yet loaded,
     //the below default text is displayed
     else
     {        
         g.setFont(20.0f);
-        g.drawText("File not loaded", getLocalBounds(),
+        g.drawText(loadedFile == juce::File{} ? "File not loaded" : "Loading waveform...", getLocalBounds(),
             juce::Justification::centred, true);   // draw some placeholder text
     }
+}
 
+juce::Rectangle<int> WaveformDisplay::getPlayheadArea() const
+{
+    return { (int)(position * getWidth()), 0, 5, getHeight() };
+}
+
+//Every pixel covers the points of the level closest to the samples under it. The peaks are drawn first
+//  and the RMS over them in a lighter colour, so the loud parts of the track stand out
+void WaveformDisplay::drawWaveform(juce::Graphics& g)
+{
+    const int width{ getWidth() };
+    if (width <= 0 || pyramid->getLengthInSamples() <= 0)
+    {
+        return;
+    }
+
+    const double samplesPerPixel{ (double)pyramid->getLengthInSamples() / width };
+    const int level{ pyramid->findLevel(samplesPerPixel) };
+    const double pointsPerPixel{ samplesPerPixel / pyramid->getSamplesPerPoint(level) };
+
+    const float centre{ getHeight() * 0.5f };
+
+    for (int x = 0; x < width; ++x)
+    {
+        const int firstPoint{ (int)(x * pointsPerPixel) };
+        const int endPoint{ juce::jmax(firstPoint + 1, (int)((x + 1) * pointsPerPixel)) };
+
+        drawPoint(g, x, pyramid->getRange(level, firstPoint, endPoint), centre);
+    }
+}
+
+//The colour of a point is the mix of the colours of its bands, each as strong as the band is loud,
+//  so kicks show up red, vocals and synths green and hi-hats blue
+void WaveformDisplay::drawPoint(juce::Graphics& g, int x, const WaveformPoint& point, float centre)
+{
+    const float peakScale{ centre / 127.0f };
+    const float rmsScale{ centre / 255.0f };
+
+    const juce::Colour colour{ getBandColour(point) };
+
+    g.setColour(colour);
+    g.drawVerticalLine(x, centre - point.maximum * peakScale, centre - point.minimum * peakScale + 1.0f);
+
+    g.setColour(colour.brighter(0.6f));
+    g.drawVerticalLine(x, centre - point.rms * rmsScale, centre + point.rms * rmsScale + 1.0f);
+}
+
+//Most music has far more energy in the lows than in the highs, so the mids and highs are weighted up,
+//  or a hi-hat over a bass line would hardly change the colour
+juce::Colour WaveformDisplay::getBandColour(const WaveformPoint& point)
+{
+    const juce::Colour bandColours[3]{ juce::Colours::crimson, juce::Colours::lightseagreen, juce::Colours::deepskyblue };
+    const float weights[3]{ 1.0f, 1.5f, 3.0f };
+    const float levels[3]{ point.low * weights[0], point.mid * weights[1], point.high * weights[2] };
+
+    const float total{ levels[0] + levels[1] + levels[2] };
+    if (total <= 0.0f)
+    {
+        return juce::Colours::lightseagreen;
+    }
+
+    float red{ 0.0f }, green{ 0.0f }, blue{ 0.0f };
+    for (int band = 0; band < 3; ++band)
+    {
+        const float share{ levels[band] / total };
+        red += bandColours[band].getFloatRed() * share;
+        green += bandColours[band].getFloatGreen() * share;
+        blue += bandColours[band].getFloatBlue() * share;
+    }
+    return juce::Colour::fromFloatRGBA(red, green, blue, 1.0f);
 }
 
 void WaveformDisplay::resized()
@@ -70,30 +156,53 @@ void WaveformDisplay::resized()
     // This method is where you should set the bounds of any child
     // components that your component contains..
 
+    imageValid = false;
 }
 
+//Clears whatever has been loaded before and asks the WaveformCache for the pyramid of the track.
+//The waveform is drawn, and fileLoaded set, once the pyramid has arrived. If the track could not be read
+//  loadFailed is set instead
 void WaveformDisplay::loadURL(juce::URL audioURL)
 {
-    //Clears whatever has been loaded before 
-    audioThumb.clear();
+    loadedFile = audioURL.getLocalFile();
+    pyramid.reset();
+    fileLoaded = false;
+    loadFailed = false;
+    imageValid = false;
+    repaint();
 
-    //loading the source into the audioThumb object and returns a bool,
-    // indicating success or failure, stored in the fileLoaded variable
-    fileLoaded = audioThumb.setSource(new juce::URLInputSource(audioURL));
-}
+    juce::Component::SafePointer<WaveformDisplay> safeThis{ this };
+    const juce::File file{ loadedFile };
 
-//Whenever there is a change the waveform is repainted and updated
-void WaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster* source)
-{    
-    repaint();
+    waveformCache->findAsync(file, [safeThis, file](std::shared_ptr<const WaveformPyramid> found)
+    {
+        if (safeThis == nullptr || safeThis->loadedFile != file)
+        {
+            return;
+        }
+
+        safeThis->pyramid = found;
+        safeThis->fileLoaded = found != nullptr;
+        safeThis->loadFailed = found == nullptr;
+        safeThis->imageValid = false;
+        safeThis->repaint();
+    });
 }
 
-//Updating the position of the playhead 
+//Updating the position of the playhead. Only the strip the playhead left and the one it moved to are
+//  repainted, and nothing at all while it stays on the same pixel
 void WaveformDisplay::setPositionRelative(double pos)
 {
     if (pos != position)
     {
+        const juce::Rectangle<int> oldArea{ getPlayheadArea() };
         position = pos;
-        repaint();
+        const juce::Rectangle<int> newArea{ getPlayheadArea() };
+
+        if (fileLoaded == true && newArea != oldArea)
+        {
+            repaint(oldArea);
+            repaint(newArea);
+        }
     }
 }
\ No newline at end of file
@@ -11,17 +11,20 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <memory>
+#include "WaveformCache.h"
 
 //==============================================================================
-/*
-*/
-class WaveformDisplay  : public juce::Component,
-                         public juce::ChangeListener
+//Draws the whole waveform of the track on a deck, with the playhead over it.
+//The waveform comes from the pyramid of the track in the WaveformCache, so it is only worked out
+//  the first time a track is ever loaded and is simply mapped from disk after that.
+//The waveform is drawn once into an image and the playhead over it, so moving the playhead only
+//  repaints the few pixels it covers
+class WaveformDisplay  : public juce::Component
 {
 public:
     //The waveformDisplay constructor definition
-    WaveformDisplay(juce::AudioFormatManager& formatManagerToUse,
-                    juce::AudioThumbnailCache& cachetoUse);
+    WaveformDisplay();
 
     ~WaveformDisplay() override;
 
@@ -29,24 +32,43 @@ public:
     void paint (juce::Graphics&) override;
     void resized() override;
 
-    //The pure virtual function that needs to be implemented since we inherit from
-    // the ChangeListener class
-    void changeListenerCallback (juce::ChangeBroadcaster *source) override;
-
     //A function that takes care of setting the position of the playhead
     void setPositionRelative(double pos);
 
-    //A function that takes care of loading the source into an audioThumbnail
+    //A function that takes care of finding the waveform pyramid of a track, in the background
     void loadURL (juce::URL audioURL);
 
+    //Drawing one point of a pyramid as a vertical line at x, around the centre line of the waveform,
+    //  in the colour of its bands. Shared with the NearWaveformDisplay so both waveforms look the same
+    static void drawPoint(juce::Graphics& g, int x, const WaveformPoint& point, float centre);
+    //The colour of a point: the lows are red, the mids green and the highs blue
+    static juce::Colour getBandColour(const WaveformPoint& point);
+
 private:
-    //An audioThumbnail that enables us to draw the waveform
-    juce::AudioThumbnail audioThumb;
+    //Drawing the background, the outline and the waveform into the image
+    void renderImage();
+    //Drawing the peaks and the RMS of the pyramid, one line per pixel
+    void drawWaveform(juce::Graphics& g);
+    //The strip of the component the playhead is drawn in
+    juce::Rectangle<int> getPlayheadArea() const;
+
+    //The waveform as last drawn, without the playhead, and false when it has to be drawn again
+    juce::Image image;
+    bool imageValid{ false };
+
+    //The pyramid of the track, once the WaveformCache has found it
+    std::shared_ptr<const WaveformPyramid> pyramid;
+    //The file of the track being loaded, so a pyramid that arrives for an older track is ignored
+    juce::File loadedFile;
+
+    juce::SharedResourcePointer<WaveformCache> waveformCache;
 
     //The variable used to store the position and be able to update it
     double position;
 
     //A bool variable to check if the file is loaded or not initialized as false
     bool fileLoaded;
+    //Set when the WaveformCache could not read the track, so an error is shown instead of the waveform
+    bool loadFailed{ false };
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformDisplay)
 };
@@ -0,0 +1,502 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.cpp
+    Created: 17 Oct 2026 3:34:42pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#include "WaveformPyramid.h"
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+    //The header at the start of a pyramid file. The points of all the levels follow it
+    struct PyramidFileHeader
+    {
+        char magic[4]{ 'O', 'D', 'W', 'P' };
+        juce::uint32 version{ 2 };
+        double sampleRate{ 0.0 };
+        juce::int64 lengthInSamples{ 0 };
+        juce::uint32 pointSize{ sizeof(WaveformPoint) };
+        juce::uint32 baseSamplesPerPoint{ WaveformPyramid::baseSamplesPerPoint };
+        juce::uint32 numLevels{ 0 };
+        juce::uint32 levelSizes[WaveformPyramid::maxLevels]{};
+        juce::uint8 reserved[4]{};
+    };
+
+    static_assert(std::is_trivially_copyable<WaveformPoint>::value, "WaveformPoint is written to disk as it is");
+    static_assert(sizeof(WaveformPoint) == 6, "A point must stay 6 bytes");
+    static_assert(sizeof(PyramidFileHeader) == 104, "The header of the pyramid file must stay 104 bytes");
+
+    juce::int8 toPointSample(float sample)
+    {
+        return (juce::int8)juce::roundToInt(juce::jlimit(-1.0f, 1.0f, sample) * 127.0f);
+    }
+
+    juce::uint8 toPointRms(float meanSquare)
+    {
+        return (juce::uint8)juce::roundToInt(juce::jlimit(0.0f, 1.0f, std::sqrt(meanSquare)) * 255.0f);
+    }
+
+    //Joins 2 mean squares of the level below into one of the next level
+    void joinSquares(std::vector<float>& squares, size_t i, size_t first, size_t second)
+    {
+        squares[i] = 0.5f * (squares[first] + squares[second]);
+    }
+}
+
+//==============================================================================
+//The band filters are 2nd order filters run at half the sample rate of the track: lane 0 is a Butterworth
+//  low pass, lane 1 a band pass centred between the crossovers, as wide as the space between them,
+//  and lane 2 a Butterworth high pass
+WaveformPyramid::Builder::Builder(double _sampleRate, juce::int64 expectedLengthInSamples)
+    : sampleRate(_sampleRate)
+{
+    const size_t expectedPoints{ (size_t)(juce::jmax((juce::int64)0, expectedLengthInSamples) / baseSamplesPerPoint + 1) };
+
+    minimums.reserve(expectedPoints);
+    maximums.reserve(expectedPoints);
+    meanSquares.reserve(expectedPoints);
+    lowSquares.reserve(expectedPoints);
+    midSquares.reserve(expectedPoints);
+    highSquares.reserve(expectedPoints);
+
+    const double pi{ 3.14159265358979323846 };
+    const double centre{ std::sqrt(lowCrossover * highCrossover) };
+    const double frequencies[numBands]{ lowCrossover, centre, highCrossover };
+    const double qualities[numBands]{ 0.7071067811865476, centre / (highCrossover - lowCrossover), 0.7071067811865476 };
+    const double bandSampleRate{ sampleRate * 0.5 };
+
+    //The coefficients of the last lane stay 0, so it always outputs silence
+    for (int lane = 0; lane < numBands; ++lane)
+    {
+        const double w0{ 2.0 * pi * juce::jmin(frequencies[lane], 0.45 * bandSampleRate) / bandSampleRate };
+        const double alpha{ std::sin(w0) / (2.0 * qualities[lane]) };
+        const double cosine{ std::cos(w0) };
+        const double a0{ 1.0 + alpha };
+
+        if (lane == 0)
+        {
+            b0[lane] = (float)((1.0 - cosine) * 0.5 / a0);
+            b1[lane] = (float)((1.0 - cosine) / a0);
+            b2[lane] = b0[lane];
+        }
+        else if (lane == 1)
+        {
+            b0[lane] = (float)(alpha / a0);
+            b1[lane] = 0.0f;
+            b2[lane] = -b0[lane];
+        }
+        else
+        {
+            b0[lane] = (float)((1.0 + cosine) * 0.5 / a0);
+            b1[lane] = (float)(-(1.0 + cosine) / a0);
+            b2[lane] = b0[lane];
+        }
+        a1[lane] = (float)(-2.0 * cosine / a0);
+        a2[lane] = (float)((1.0 - alpha) / a0);
+    }
+}
+
+WaveformPyramid::Builder::~Builder()
+{
+
+}
+
+//The block is cut where the points end, so every point gets exactly baseSamplesPerPoint samples of every channel
+void WaveformPyramid::Builder::process(const float* const* channels, int _numChannels, int numSamples)
+{
+    numChannels = juce::jmax(1, _numChannels);
+
+    for (int start = 0; start < numSamples;)
+    {
+        const int count{ juce::jmin(numSamples - start, baseSamplesPerPoint - samplesInPoint) };
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* samples{ channels[channel] + start };
+            const juce::Range<float> range{ juce::FloatVectorOperations::findMinAndMax(samples, count) };
+
+            if (samplesInPoint == 0 && channel == 0)
+            {
+                minimum = range.getStart();
+                maximum = range.getEnd();
+            }
+            else
+            {
+                minimum = juce::jmin(minimum, range.getStart());
+                maximum = juce::jmax(maximum, range.getEnd());
+            }
+        }
+
+        addSquares(channels, start, count);
+
+        samplesInPoint += count;
+        lengthInSamples += count;
+        start += count;
+
+        if (samplesInPoint == baseSamplesPerPoint)
+        {
+            addPoint();
+        }
+    }
+}
+
+//The 3 filters are worked out for every sample before any moves on, so their lanes go through the
+//  same instructions.
+//The filters have to wait for the sample before, so the loop is held up by them and not by the number
+//  of sums. The squares of the samples are added in the same loop, which makes them almost free, and the
+//  filters only run on every other sample, the mean of each pair, which still keeps the highs up to
+//  a quarter of the sample rate. A pair never spans 2 points, since the points are an even length.
+//The state is copied into locals for the loop, since the compiler cannot tell the members apart from
+//  the samples and would otherwise write them back to memory for every sample
+void WaveformPyramid::Builder::addSquares(const float* const* channels, int start, int count)
+{
+    const float* left{ channels[0] + start };
+    const float* right{ channels[numChannels - 1] + start };
+
+    float s1[numLanes], s2[numLanes], c0[numLanes], c1[numLanes], c2[numLanes], d1[numLanes], d2[numLanes];
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        s1[lane] = z1[lane];
+        s2[lane] = z2[lane];
+        c0[lane] = b0[lane];
+        c1[lane] = b1[lane];
+        c2[lane] = b2[lane];
+        d1[lane] = a1[lane];
+        d2[lane] = a2[lane];
+    }
+
+    float squares{ 0.0f };
+    float low{ 0.0f };
+    float mid{ 0.0f };
+    float high{ 0.0f };
+    float pair{ pairSum };
+    bool secondOfPair{ pairStarted };
+
+    for (int i = 0; i < count; ++i)
+    {
+        squares += left[i] * left[i] + right[i] * right[i];
+        pair += left[i] + right[i];
+
+        if (!secondOfPair)
+        {
+            secondOfPair = true;
+            continue;
+        }
+
+        const float x{ 0.25f * pair };
+        pair = 0.0f;
+        secondOfPair = false;
+
+        float y[numLanes];
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            y[lane] = c0[lane] * x + s1[lane];
+            s1[lane] = c1[lane] * x - d1[lane] * y[lane] + s2[lane];
+            s2[lane] = c2[lane] * x - d2[lane] * y[lane];
+        }
+
+        low += y[0] * y[0];
+        mid += y[1] * y[1];
+        high += y[2] * y[2];
+    }
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        z1[lane] = s1[lane];
+        z2[lane] = s2[lane];
+    }
+    pairSum = pair;
+    pairStarted = secondOfPair;
+
+    sumOfSquares += squares;
+    bandSums[0] += low;
+    bandSums[1] += mid;
+    bandSums[2] += high;
+}
+
+void WaveformPyramid::Builder::addPoint()
+{
+    minimums.push_back(minimum);
+    maximums.push_back(maximum);
+    meanSquares.push_back((float)(sumOfSquares / (2.0 * samplesInPoint)));
+    const double numPairs{ (double)juce::jmax(1, samplesInPoint / 2) };
+    lowSquares.push_back((float)(bandSums[0] / numPairs));
+    midSquares.push_back((float)(bandSums[1] / numPairs));
+    highSquares.push_back((float)(bandSums[2] / numPairs));
+
+    samplesInPoint = 0;
+    sumOfSquares = 0.0;
+    bandSums[0] = bandSums[1] = bandSums[2] = 0.0;
+}
+
+//Every level is made from the one below it by joining its points in pairs. The last point of a level
+//  with an odd number of points is joined with nothing
+std::shared_ptr<WaveformPyramid> WaveformPyramid::Builder::finish()
+{
+    if (samplesInPoint > 0)
+    {
+        addPoint();
+    }
+
+    if (minimums.empty())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<WaveformPyramid> pyramid{ new WaveformPyramid() };
+    pyramid->sampleRate = sampleRate;
+    pyramid->lengthInSamples = lengthInSamples;
+
+    std::vector<WaveformPoint>& built{ pyramid->builtPoints };
+    built.reserve(minimums.size() * 2);
+
+    for (int level = 0; level < maxLevels; ++level)
+    {
+        const size_t size{ minimums.size() };
+
+        pyramid->levelStarts.push_back(built.size());
+        pyramid->levelSizes.push_back((int)size);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            WaveformPoint point;
+            point.minimum = toPointSample(minimums[i]);
+            point.maximum = toPointSample(maximums[i]);
+            point.rms = toPointRms(meanSquares[i]);
+            point.low = toPointRms(lowSquares[i]);
+            point.mid = toPointRms(midSquares[i]);
+            point.high = toPointRms(highSquares[i]);
+            built.push_back(point);
+        }
+
+        if (size <= (size_t)topLevelPoints)
+        {
+            break;
+        }
+
+        //Joining the points in place, so the vectors hold the next level
+        const size_t nextSize{ (size + 1) / 2 };
+        for (size_t i = 0; i < nextSize; ++i)
+        {
+            const size_t first{ 2 * i };
+            const size_t second{ juce::jmin(first + 1, size - 1) };
+
+            minimums[i] = juce::jmin(minimums[first], minimums[second]);
+            maximums[i] = juce::jmax(maximums[first], maximums[second]);
+            joinSquares(meanSquares, i, first, second);
+            joinSquares(lowSquares, i, first, second);
+            joinSquares(midSquares, i, first, second);
+            joinSquares(highSquares, i, first, second);
+        }
+
+        minimums.resize(nextSize);
+        maximums.resize(nextSize);
+        meanSquares.resize(nextSize);
+        lowSquares.resize(nextSize);
+        midSquares.resize(nextSize);
+        highSquares.resize(nextSize);
+    }
+
+    pyramid->points = built.data();
+    return pyramid;
+}
+
+//==============================================================================
+WaveformPyramid::WaveformPyramid()
+{
+
+}
+
+WaveformPyramid::~WaveformPyramid()
+{
+
+}
+
+//The points are used straight from the mapped file, so loading only reads the header
+std::shared_ptr<WaveformPyramid> WaveformPyramid::load(const juce::File& file)
+{
+    if (!file.existsAsFile())
+    {
+        return nullptr;
+    }
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+
+    const char* data{ static_cast<const char*>(mapped->getData()) };
+    const juce::uint64 size{ (juce::uint64)mapped->getSize() };
+
+    PyramidFileHeader header;
+    if (data == nullptr || size < sizeof(header))
+    {
+        return nullptr;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    bool valid{ std::memcmp(header.magic, "ODWP", 4) == 0
+        && header.version == PyramidFileHeader{}.version
+        && header.pointSize == sizeof(WaveformPoint)
+        && header.baseSamplesPerPoint == (juce::uint32)baseSamplesPerPoint
+        && header.numLevels > 0
+        && header.numLevels <= (juce::uint32)maxLevels
+        && header.sampleRate > 0.0 };
+
+    juce::uint64 numPoints{ 0 };
+    for (juce::uint32 level = 0; valid && level < header.numLevels; ++level)
+    {
+        numPoints += header.levelSizes[level];
+    }
+
+    if (!valid || sizeof(header) + numPoints * sizeof(WaveformPoint) > size)
+    {
+        DBG("WaveformPyramid::load ignored " << file.getFullPathName());
+        return nullptr;
+    }
+
+    std::shared_ptr<WaveformPyramid> pyramid{ new WaveformPyramid() };
+    pyramid->sampleRate = header.sampleRate;
+    pyramid->lengthInSamples = header.lengthInSamples;
+
+    size_t start{ 0 };
+    for (juce::uint32 level = 0; level < header.numLevels; ++level)
+    {
+        pyramid->levelStarts.push_back(start);
+        pyramid->levelSizes.push_back((int)header.levelSizes[level]);
+        start += header.levelSizes[level];
+    }
+
+    pyramid->points = reinterpret_cast<const WaveformPoint*>(data + sizeof(header));
+    pyramid->mappedFile = std::move(mapped);
+    return pyramid;
+}
+
+bool WaveformPyramid::save(const juce::File& file) const
+{
+    PyramidFileHeader header;
+    header.sampleRate = sampleRate;
+    header.lengthInSamples = lengthInSamples;
+    header.numLevels = (juce::uint32)levelSizes.size();
+
+    size_t numPoints{ 0 };
+    for (size_t level = 0; level < levelSizes.size(); ++level)
+    {
+        header.levelSizes[level] = (juce::uint32)levelSizes[level];
+        numPoints += (size_t)levelSizes[level];
+    }
+
+    juce::TemporaryFile tempFile{ file };
+    {
+        juce::FileOutputStream output{ tempFile.getFile() };
+        if (output.failedToOpen())
+        {
+            DBG("WaveformPyramid::save could not write " << tempFile.getFile().getFullPathName());
+            return false;
+        }
+
+        output.write(&header, sizeof(header));
+        output.write(points, numPoints * sizeof(WaveformPoint));
+        output.flush();
+
+        if (output.getStatus().failed())
+        {
+            DBG("WaveformPyramid::save could not write " << tempFile.getFile().getFullPathName());
+            return false;
+        }
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+int WaveformPyramid::getNumLevels() const
+{
+    return (int)levelSizes.size();
+}
+
+int WaveformPyramid::getNumPoints(int level) const
+{
+    return levelSizes[(size_t)level];
+}
+
+int WaveformPyramid::getSamplesPerPoint(int level) const
+{
+    return baseSamplesPerPoint << level;
+}
+
+const WaveformPoint* WaveformPyramid::getPoints(int level) const
+{
+    return points + levelStarts[(size_t)level];
+}
+
+double WaveformPyramid::getSampleRate() const
+{
+    return sampleRate;
+}
+
+juce::int64 WaveformPyramid::getLengthInSamples() const
+{
+    return lengthInSamples;
+}
+
+double WaveformPyramid::getLengthInSeconds() const
+{
+    return (double)lengthInSamples / sampleRate;
+}
+
+int WaveformPyramid::findLevel(double samplesPerPixel) const
+{
+    int level{ 0 };
+
+    while (level + 1 < getNumLevels() && getSamplesPerPoint(level + 1) <= samplesPerPixel)
+    {
+        ++level;
+    }
+    return level;
+}
+
+//Every RMS of the joined point is the root of the mean of the squares of the same RMS of its points
+WaveformPoint WaveformPyramid::getRange(int level, int firstPoint, int endPoint) const
+{
+    firstPoint = juce::jlimit(0, getNumPoints(level), firstPoint);
+    endPoint = juce::jlimit(firstPoint, getNumPoints(level), endPoint);
+
+    WaveformPoint joined;
+    if (firstPoint == endPoint)
+    {
+        return joined;
+    }
+
+    const WaveformPoint* levelPoints{ getPoints(level) };
+    int minimum{ 127 };
+    int maximum{ -127 };
+    juce::int64 sums[4]{};
+
+    for (int i = firstPoint; i < endPoint; ++i)
+    {
+        const WaveformPoint& point{ levelPoints[i] };
+
+        minimum = juce::jmin(minimum, (int)point.minimum);
+        maximum = juce::jmax(maximum, (int)point.maximum);
+        sums[0] += (int)point.rms * (int)point.rms;
+        sums[1] += (int)point.low * (int)point.low;
+        sums[2] += (int)point.mid * (int)point.mid;
+        sums[3] += (int)point.high * (int)point.high;
+    }
+
+    const double count{ (double)(endPoint - firstPoint) };
+
+    joined.minimum = (juce::int8)minimum;
+    joined.maximum = (juce::int8)maximum;
+    joined.rms = (juce::uint8)juce::roundToInt(std::sqrt(sums[0] / count));
+    joined.low = (juce::uint8)juce::roundToInt(std::sqrt(sums[1] / count));
+    joined.mid = (juce::uint8)juce::roundToInt(std::sqrt(sums[2] / count));
+    joined.high = (juce::uint8)juce::roundToInt(std::sqrt(sums[3] / count));
+    return joined;
+}
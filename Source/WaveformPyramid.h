@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.h
+    Created: 17 Oct 2026 3:34:42pm
+    Author:  Hesron
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+//One point of a waveform: the lowest and highest sample and the RMS of the samples it covers,
+//  and the RMS of its lows, mids and highs.
+//The samples are scaled from -1..1 to -127..127 and every RMS from 0..1 to 0..255, so a point is 6 bytes
+struct WaveformPoint
+{
+    juce::int8 minimum{ 0 };
+    juce::int8 maximum{ 0 };
+    juce::uint8 rms{ 0 };
+    juce::uint8 low{ 0 };
+    juce::uint8 mid{ 0 };
+    juce::uint8 high{ 0 };
+};
+
+//==============================================================================
+//The waveform of a whole track at several zoom levels.
+//Level 0 has a point for every baseSamplesPerPoint samples of the track, and every level after it
+//  covers twice as many samples per point, until a level has no more than topLevelPoints points.
+//A display picks the level closest to the number of samples under one of its pixels, so drawing
+//  the waveform never reads more than about 2 points per pixel, whatever the zoom.
+//The bands are split by a low pass at lowCrossover, a band pass between the 2 crossovers and a
+//  high pass at highCrossover.
+//A pyramid is made by a Builder fed the audio of the track in blocks, and it can be saved to a file
+//  and loaded back from it by memory mapping the whole file, so nothing is read or worked out again.
+//Once made, a pyramid never changes, so it can be shared between threads
+class WaveformPyramid
+{
+public:
+    //The number of samples under a point of level 0
+    static constexpr int baseSamplesPerPoint{ 256 };
+    //The levels stop halving once a level has this many points or fewer
+    static constexpr int topLevelPoints{ 1024 };
+    //The most levels a pyramid can have
+    static constexpr int maxLevels{ 16 };
+    //The frequencies in Hz the lows end and the highs start at
+    static constexpr double lowCrossover{ 200.0 };
+    static constexpr double highCrossover{ 2500.0 };
+
+    //==============================================================================
+    //Works out the points of a pyramid from the audio of a track, fed in blocks of any size.
+    //Only the points of level 0 are kept while the track is fed, the other levels are made from them at the end.
+    //The bands are split from the mono mix at half the sample rate. The 3 band filters are independent,
+    //  so they are run side by side as the lanes of one filter, which the compiler can keep in one
+    //  SIMD register
+    class Builder
+    {
+    public:
+        //The expected length is only used to reserve room for the points, and may be 0 if it is not known
+        Builder(double sampleRate, juce::int64 expectedLengthInSamples);
+        ~Builder();
+
+        //Adding the next block of audio, one pointer per channel. All the channels go into the same points
+        void process(const float* const* channels, int numChannels, int numSamples);
+
+        //Making the pyramid from everything that was fed. Returns nullptr if nothing was fed
+        std::shared_ptr<WaveformPyramid> finish();
+
+    private:
+        //Adding the point being worked out to the points of level 0
+        void addPoint();
+        //Adding the squares of a part of a block to the sums of the point, and running the band filters
+        //  over its mono mix. A mono track is read as its only channel twice
+        void addSquares(const float* const* channels, int start, int count);
+
+        //The number of filters run side by side, the low pass, the band pass and the high pass.
+        //There is room for a 4th one that does nothing, so the lanes fill a 128 bit SIMD register exactly.
+        //With 3 lanes the compiler leaves the filters unvectorized and the bands cost twice as much
+        static constexpr int numBands{ 3 };
+        static constexpr int numLanes{ 4 };
+
+        //The coefficients and the state of the band filters, biquads in the transposed direct form II
+        float b0[numLanes]{}, b1[numLanes]{}, b2[numLanes]{}, a1[numLanes]{}, a2[numLanes]{};
+        float z1[numLanes]{}, z2[numLanes]{};
+        //The sum of the first sample of a pair that was cut off by the end of a block
+        float pairSum{ 0.0f };
+        bool pairStarted{ false };
+
+        double sampleRate;
+        juce::int64 lengthInSamples{ 0 };
+
+        //The point being worked out, as floats
+        float minimum{ 0.0f };
+        float maximum{ 0.0f };
+        double sumOfSquares{ 0.0 };
+        double bandSums[3]{};
+        int samplesInPoint{ 0 };
+        int numChannels{ 1 };
+
+        //The finished points of level 0, as floats, and the mean square of each of them and of their bands
+        std::vector<float> minimums;
+        std::vector<float> maximums;
+        std::vector<float> meanSquares;
+        std::vector<float> lowSquares;
+        std::vector<float> midSquares;
+        std::vector<float> highSquares;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Builder)
+    };
+
+    //==============================================================================
+    ~WaveformPyramid();
+
+    //Loading a pyramid saved by save() by mapping the file. Returns nullptr if the file is missing,
+    //  was cut short or was written by another version
+    static std::shared_ptr<WaveformPyramid> load(const juce::File& file);
+    //Writing the pyramid to a file, through a temporary file so a file is never left half written
+    bool save(const juce::File& file) const;
+
+    int getNumLevels() const;
+    int getNumPoints(int level) const;
+    int getSamplesPerPoint(int level) const;
+    //The points of a level, from the start of the track to its end
+    const WaveformPoint* getPoints(int level) const;
+
+    //The track the pyramid was made from
+    double getSampleRate() const;
+    juce::int64 getLengthInSamples() const;
+    double getLengthInSeconds() const;
+
+    //The coarsest level that still has at least one point for every samplesPerPixel samples
+    int findLevel(double samplesPerPixel) const;
+    //Joining the points of a level from firstPoint up to, but not including, endPoint into one point
+    WaveformPoint getRange(int level, int firstPoint, int endPoint) const;
+
+private:
+    WaveformPyramid();
+
+    double sampleRate{ 0.0 };
+    juce::int64 lengthInSamples{ 0 };
+
+    //The number of points of every level and where each level starts in points
+    std::vector<int> levelSizes;
+    std::vector<size_t> levelStarts;
+
+    //The points of all the levels one after the other, either in the mapped file or in memory
+    const WaveformPoint* points{ nullptr };
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    std::vector<WaveformPoint> builtPoints;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPyramid)
+};